@@ -0,0 +1,55 @@
+// RFM69Aes.h
+//
+// Copyright (C) 2026 the UKHASnet_rfm69 contributors
+//
+// AES-128 in software, giving exactly what the RFM69 puts on air with its
+// packet handler's AES turned on (see RFM69::setEncryptionKey()): the message
+// after the length and address bytes is cut into 16 byte blocks, the last
+// one padded with zeros, and each is encrypted on its own with the key (ECB).
+// Used by the simulator to model the radio, and by gateways handling frames
+// captured without a radio that shares the key, eg from RFM69PacketLog.
+
+#ifndef RFM69Aes_h
+#define RFM69Aes_h
+
+#include "UKHASnet_rfm69.h"
+
+#define RFM69_AES_BLOCK     16
+#define RFM69_AES_KEY_LEN   16
+
+class RFM69Aes
+{
+public:
+    /// \param[in] key 16 bytes, as given to RFM69::setEncryptionKey(), or NULL for all zeros
+    RFM69Aes(const uint8_t* key = NULL);
+
+    /// Expands a new key
+    /// \param[in] key 16 bytes
+    void            setKey(const uint8_t* key);
+
+    /// Encrypts one 16 byte block in place
+    void            encryptBlock(uint8_t* block) const;
+
+    /// Decrypts one 16 byte block in place
+    void            decryptBlock(uint8_t* block) const;
+
+    /// Encrypts a message as the radio does
+    /// \param[in] in The message
+    /// \param[in] len Its length
+    /// \param[out] out Where to put the encrypted message, paddedLen(len) bytes. May be in.
+    void            encrypt(const uint8_t* in, uint8_t len, uint8_t* out) const;
+
+    /// Decrypts a message as the radio does
+    /// \param[in] in paddedLen(len) bytes, as on air
+    /// \param[in] len Length of the message, from the length byte
+    /// \param[out] out Where to put the len bytes of the message. May be in.
+    void            decrypt(const uint8_t* in, uint8_t len, uint8_t* out) const;
+
+    /// \return The number of bytes a message of len bytes takes encrypted
+    static uint16_t paddedLen(uint8_t len) { return ((uint16_t)len + RFM69_AES_BLOCK - 1) & ~(RFM69_AES_BLOCK - 1); }
+
+private:
+    uint8_t         _roundKeys[11 * RFM69_AES_BLOCK];
+};
+
+#endif
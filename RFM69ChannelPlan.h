@@ -0,0 +1,68 @@
+// RFM69ChannelPlan.h
+//
+// Copyright (C) 2026 the UKHASnet_rfm69 contributors
+//
+// A fixed list of precomputed channels a radio can hop between, eg the
+// 869.5 MHz UKHASnet channel and any secondary channels a gateway watches.
+
+#ifndef RFM69ChannelPlan_h
+#define RFM69ChannelPlan_h
+
+#include "UKHASnet_rfm69.h"
+#include "RFM69ConfigBuilder.h"
+
+/// A set of channels built at compile time, eg:
+///
+///   static const RFM69Channel channels[] = { RFM69_CHANNEL(869500000), RFM69_CHANNEL(869850000) };
+///   RFM69ChannelPlan plan(channels, 2);
+///   plan.select(radio, 1);
+///
+/// Selecting a channel costs one 3 byte SPI burst and no arithmetic.
+class RFM69ChannelPlan
+{
+public:
+    /// \param[in] channels Array of channels, must outlive the plan
+    /// \param[in] count Number of channels in the array
+    RFM69ChannelPlan(const RFM69Channel* channels, uint8_t count)
+        : _channels(channels), _count(count), _current(0)
+    {
+    }
+
+    /// \return Number of channels in the plan
+    uint8_t         count() const { return _count; }
+
+    /// \return Index of the channel last selected
+    uint8_t         current() const { return _current; }
+
+    /// \return The channel at index, or the first channel if index is out of range
+    const RFM69Channel& operator[](uint8_t index) const { return _channels[index < _count ? index : 0]; }
+
+    /// Tunes the radio to one of the channels
+    /// \param[in] radio The radio to retune
+    /// \param[in] index Channel index
+    /// \return false if index is out of range
+    boolean         select(RFM69& radio, uint8_t index)
+    {
+        if (index >= _count)
+            return false;
+        radio.setChannel(_channels[index]);
+        _current = index;
+        return true;
+    }
+
+    /// Tunes the radio to the next channel in the plan, wrapping round at the end
+    /// \param[in] radio The radio to retune
+    /// \return The index now selected
+    uint8_t         next(RFM69& radio)
+    {
+        select(radio, _current + 1 < _count ? _current + 1 : 0);
+        return _current;
+    }
+
+private:
+    const RFM69Channel* _channels;
+    uint8_t         _count;
+    uint8_t         _current;
+};
+
+#endif
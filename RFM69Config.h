@@ -2,48 +2,68 @@
 #define RFM69Config_h
 
 #include "UKHASnet_rfm69.h"
+#include "RFM69ConfigBuilder.h"
 
-/*PROGMEM */ static const uint8_t CONFIG[][2] =
+// UKHASnet: 869.5 MHz, 2000 bps, 3000 hz deviation (6000 hz shift), 10mW, 125kHz Rx bandwidth
+typedef RFM69Settings<869500000UL, 2000, 3000, 10, 125000> UKHASNET_SETTINGS;
+
+// Register set up for init(), already sorted and split into the runs of neighbouring
+// registers that init() writes one burst each: { first register, count, values... },
+// ending with a 255. Registers in between that we do not care about are filled with
+// their POR values so that runs can be merged.
+/*PROGMEM */ static constexpr uint8_t CONFIG_RUNS[] =
 {
-    { RFM69_REG_01_OPMODE,      RF_OPMODE_SEQUENCER_ON | RF_OPMODE_LISTEN_OFF | RFM69_MODE_SLEEP },
-    { RFM69_REG_02_DATA_MODUL,  RF_DATAMODUL_DATAMODE_PACKET | RF_DATAMODUL_MODULATIONTYPE_FSK | RF_DATAMODUL_MODULATIONSHAPING_00 },
-    
-    { RFM69_REG_03_BITRATE_MSB, 0x3E}, // 2000 bps
-    { RFM69_REG_04_BITRATE_LSB, 0x80},
-    
-    { RFM69_REG_05_FDEV_MSB,    0x00}, // 3000 hz (6000 hz shift)
-    { RFM69_REG_06_FDEV_LSB,    0x31},
-
-    { RFM69_REG_07_FRF_MSB,     0xD9 }, // 869.5 MHz
-    { RFM69_REG_08_FRF_MID,     0x60 }, // calculated: 0x80?
-    { RFM69_REG_09_FRF_LSB,     0x12 },
-    
+    RFM69_REG_01_OPMODE, 9,
+        RF_OPMODE_SEQUENCER_ON | RF_OPMODE_LISTEN_OFF | RFM69_MODE_SLEEP,
+        RF_DATAMODUL_DATAMODE_PACKET | RF_DATAMODUL_MODULATIONTYPE_FSK | RF_DATAMODUL_MODULATIONSHAPING_00,
+        UKHASNET_SETTINGS::BITRATE_MSB,
+        UKHASNET_SETTINGS::BITRATE_LSB,
+        UKHASNET_SETTINGS::FDEV_MSB,
+        UKHASNET_SETTINGS::FDEV_LSB,
+        UKHASNET_SETTINGS::FRF_MSB,
+        UKHASNET_SETTINGS::FRF_MID,
+        UKHASNET_SETTINGS::FRF_LSB,
+
     // PA Settings
     // +20dBm formula: Pout=-11+OutputPower[dBmW] (with PA1 and PA2)** and high power PA settings (section 3.3.7 in datasheet)
     // Without extra flags: Pout=-14+OutputPower[dBmW]
-    { RFM69_REG_11_PA_LEVEL,    RF_PALEVEL_PA0_OFF | RF_PALEVEL_PA1_ON | RF_PALEVEL_PA2_ON | 0x18},  // 10mW
-    //{ REG_PALEVEL, RF_PALEVEL_PA0_OFF | RF_PALEVEL_PA1_ON | RF_PALEVEL_PA2_ON | 0x1f},// 50mW
-    
-    { RFM69_REG_13_OCP,         RF_OCP_ON | RF_OCP_TRIM_95 },
-    
-    { RFM69_REG_18_LNA,         RF_LNA_ZIN_50 }, // 50 ohm for matched antenna, 200 otherwise
-    
-    { RFM69_REG_19_RX_BW,       RF_RXBW_DCCFREQ_010 | RF_RXBW_MANT_16 | RF_RXBW_EXP_2}, // Rx Bandwidth: 128KHz
-    { RFM69_REG_25_DIO_MAPPING1, RF_DIOMAPPING1_DIO0_01 },
-    { RFM69_REG_26_DIO_MAPPING2, RF_DIOMAPPING2_CLKOUT_OFF }, // Switch off Clkout
-    
-    // { RFM69_REG_2D_PREAMBLE_LSB, RF_PREAMBLESIZE_LSB_VALUE } // default 3 preamble bytes 0xAAAAAA
-    
-    //{ RFM69_REG_2E_SYNC_CONFIG, RF_SYNC_OFF | RF_SYNC_FIFOFILL_MANUAL }, // Sync bytes off
-    { RFM69_REG_2E_SYNC_CONFIG, RF_SYNC_ON | RF_SYNC_FIFOFILL_AUTO | RF_SYNC_SIZE_2 | RF_SYNC_TOL_0 },
-    { RFM69_REG_2F_SYNCVALUE1, 0x2D },
-    { RFM69_REG_30_SYNCVALUE2, 0xAA },
-    { RFM69_REG_37_PACKET_CONFIG1, RF_PACKET1_FORMAT_VARIABLE | RF_PACKET1_DCFREE_OFF | RF_PACKET1_CRC_ON | RF_PACKET1_CRCAUTOCLEAR_ON | RF_PACKET1_ADRSFILTERING_OFF },
-    { RFM69_REG_38_PAYLOAD_LENGTH, RFM69_FIFO_SIZE }, // Full FIFO size for rx packet
-    { RFM69_REG_3C_FIFO_THRESHOLD, RF_FIFOTHRESH_TXSTART_FIFONOTEMPTY | RF_FIFOTHRESH_VALUE }, //TX on FIFO not empty
-    { RFM69_REG_3D_PACKET_CONFIG2, RF_PACKET2_RXRESTARTDELAY_2BITS | RF_PACKET2_AUTORXRESTART_ON | RF_PACKET2_AES_OFF }, //RXRESTARTDELAY must match transmitter PA ramp-down time (bitrate dependent)
-    { RFM69_REG_6F_TEST_DAGC, RF_DAGC_IMPROVED_LOWBETA0 }, // run DAGC continuously in RX mode, recommended default for AfcLowBetaOn=0
-    {255, 0}
-  };
+    RFM69_REG_11_PA_LEVEL, 3,
+        UKHASNET_SETTINGS::PA_LEVEL,
+        RF_PARAMP_40, // POR
+        RF_OCP_ON | RF_OCP_TRIM_95,
+
+    RFM69_REG_18_LNA, 2,
+        RF_LNA_ZIN_50, // 50 ohm for matched antenna, 200 otherwise
+        RF_RXBW_DCCFREQ_010 | UKHASNET_SETTINGS::RX_BW,
+
+    RFM69_REG_25_DIO_MAPPING1, 2,
+        RF_DIOMAPPING1_DIO0_10, // SYNCADDRESS, then PAYLOADREADY once a packet has started
+        RF_DIOMAPPING2_CLKOUT_OFF, // Switch off Clkout
+
+    // RFM69_REG_2D_PREAMBLE_LSB, RF_PREAMBLESIZE_LSB_VALUE // default 3 preamble bytes 0xAAAAAA
+
+    //RFM69_REG_2E_SYNC_CONFIG, RF_SYNC_OFF | RF_SYNC_FIFOFILL_MANUAL // Sync bytes off
+    RFM69_REG_2E_SYNC_CONFIG, 3,
+        RF_SYNC_ON | RF_SYNC_FIFOFILL_AUTO | RF_SYNC_SIZE_2 | RF_SYNC_TOL_0,
+        0x2D,
+        0xAA,
+
+    // CRC auto clear off: a bad CRC still raises PAYLOADREADY, so it can be counted
+    RFM69_REG_37_PACKET_CONFIG1, 7,
+        RF_PACKET1_FORMAT_VARIABLE | RF_PACKET1_DCFREE_OFF | RF_PACKET1_CRC_ON | RF_PACKET1_CRCAUTOCLEAR_OFF | RF_PACKET1_ADRSFILTERING_OFF,
+        RFM69_MAX_MESSAGE_LEN, // Longer packets are dropped by the radio
+        0x00, // Node address, POR
+        RF_BROADCASTADDRESS_VALUE, // POR
+        RF_AUTOMODES_ENTER_OFF | RF_AUTOMODES_EXIT_OFF | RF_AUTOMODES_INTERMEDIATE_SLEEP, // POR
+        RF_FIFOTHRESH_TXSTART_FIFONOTEMPTY | RF_FIFOTHRESH_VALUE, //TX on FIFO not empty
+        RF_PACKET2_RXRESTARTDELAY_2BITS | RF_PACKET2_AUTORXRESTART_ON | RF_PACKET2_AES_OFF, //RXRESTARTDELAY must match transmitter PA ramp-down time (bitrate dependent)
+
+    RFM69_REG_6F_TEST_DAGC, 1,
+        RF_DAGC_IMPROVED_LOWBETA0, // run DAGC continuously in RX mode, recommended default for AfcLowBetaOn=0
+
+    255
+};
+
+static_assert(rfm69RunsValid(CONFIG_RUNS), "CONFIG_RUNS must be sorted, non-overlapping runs");
 
 #endif
@@ -0,0 +1,141 @@
+// RFM69ConfigBuilder.h
+//
+// Copyright (C) 2026 the UKHASnet_rfm69 contributors
+//
+// Compile time conversion of radio settings in physical units (Hz, bps, dBm)
+// into RFM69 register values. Everything here is constexpr, so a build with a
+// bad combination fails with a static_assert instead of a radio that never
+// hears anything, and no float maths ends up in the firmware.
+
+#ifndef RFM69ConfigBuilder_h
+#define RFM69ConfigBuilder_h
+
+#include "UKHASnet_rfm69.h"
+
+// Allowed ranges, from the SX1231 datasheet
+#define RFM69_BITRATE_MIN       1200UL
+#define RFM69_BITRATE_MAX       300000UL
+#define RFM69_FDEV_MIN          600UL
+#define RFM69_FDEV_MAX          300000UL
+#define RFM69_PA_DBM_MIN        2       // PA1 + PA2: Pout = -14 + OutputPower
+#define RFM69_PA_DBM_MAX        17
+
+/// RegBitrate value for a bitrate in bits per second, rounded to nearest
+constexpr uint16_t rfm69BitrateReg(uint32_t bps)
+{
+    return (uint16_t)((RFM69_FXOSC + bps / 2) / bps);
+}
+
+/// RegFdev value for a frequency deviation in Hz, in steps of FSTEP
+constexpr uint16_t rfm69FdevReg(uint32_t hz)
+{
+    return (uint16_t)((((uint64_t)hz << 19) + RFM69_FXOSC / 2) / RFM69_FXOSC);
+}
+
+/// RegFrf value for a carrier frequency in Hz, in steps of FSTEP
+constexpr uint32_t rfm69FrfReg(uint32_t hz)
+{
+    return (uint32_t)((((uint64_t)hz << 19) + RFM69_FXOSC / 2) / RFM69_FXOSC);
+}
+
+/// True if hz is inside one of the synthesiser's bands
+constexpr bool rfm69FrfValid(uint32_t hz)
+{
+    return (hz >= 290000000UL && hz <= 340000000UL)
+        || (hz >= 424000000UL && hz <= 510000000UL)
+        || (hz >= 862000000UL && hz <= 1020000000UL);
+}
+
+/// RegPaLevel value for an output power in dBm using PA1 and PA2 together
+constexpr uint8_t rfm69PaLevelReg(int8_t dbm)
+{
+    return RF_PALEVEL_PA0_OFF | RF_PALEVEL_PA1_ON | RF_PALEVEL_PA2_ON | (uint8_t)(dbm + 14);
+}
+
+/// Single sided FSK receiver bandwidth in Hz for a RegRxBw mantissa and exponent
+constexpr uint32_t rfm69RxBwHz(uint8_t mant, uint8_t exp)
+{
+    return RFM69_FXOSC / ((uint32_t)mant << (exp + 2));
+}
+
+/// RegRxBw mantissa bits for a mantissa of 16, 20 or 24
+constexpr uint8_t rfm69RxBwMant(uint8_t mant)
+{
+    return mant == 16 ? RF_RXBW_MANT_16 : mant == 20 ? RF_RXBW_MANT_20 : RF_RXBW_MANT_24;
+}
+
+/// RegRxBw mantissa and exponent bits for the narrowest bandwidth at least hz wide,
+/// or 0xFF if hz is wider than the radio can do. Searches from the narrowest setting
+/// (exponent 7, mantissa 24) outwards.
+constexpr uint8_t rfm69RxBwBits(uint32_t hz, int8_t exp = 7, uint8_t mant = 24)
+{
+    return exp < 0 ? 0xFF
+        : rfm69RxBwHz(mant, exp) >= hz ? (uint8_t)(rfm69RxBwMant(mant) | exp)
+        : mant == 16 ? rfm69RxBwBits(hz, exp - 1, 24)
+        : rfm69RxBwBits(hz, exp, mant - 4);
+}
+
+/// Register values for one set of FSK modem and RF settings, all checked at compile time
+/// \param FrfHz Carrier frequency in Hz
+/// \param Bps Bitrate in bits per second
+/// \param FdevHz Frequency deviation in Hz (the shift is twice this)
+/// \param Dbm Output power in dBm
+/// \param RxBwHz Minimum single sided receiver bandwidth in Hz
+template <uint32_t FrfHz, uint32_t Bps, uint32_t FdevHz, int8_t Dbm, uint32_t RxBwHz>
+struct RFM69Settings
+{
+    static_assert(rfm69FrfValid(FrfHz), "carrier frequency outside the RFM69 bands");
+    static_assert(Bps >= RFM69_BITRATE_MIN && Bps <= RFM69_BITRATE_MAX, "bitrate out of range");
+    static_assert(FdevHz >= RFM69_FDEV_MIN && FdevHz <= RFM69_FDEV_MAX, "deviation out of range");
+    static_assert(FdevHz + Bps / 2 <= 500000UL, "deviation + bitrate/2 must not exceed 500kHz");
+    static_assert(2 * FdevHz >= Bps / 2, "modulation index 2*Fdev/BR must be at least 0.5");
+    static_assert(Dbm >= RFM69_PA_DBM_MIN && Dbm <= RFM69_PA_DBM_MAX, "output power out of range for PA1+PA2");
+    static_assert(rfm69RxBwBits(RxBwHz) != 0xFF, "receiver bandwidth wider than the RFM69 can do");
+    static_assert(RxBwHz >= FdevHz + Bps / 2, "receiver bandwidth narrower than deviation + bitrate/2");
+
+    static constexpr uint16_t bitrate = rfm69BitrateReg(Bps);
+    static constexpr uint16_t fdev = rfm69FdevReg(FdevHz);
+    static constexpr uint32_t frf = rfm69FrfReg(FrfHz);
+
+    static constexpr uint8_t BITRATE_MSB = bitrate >> 8;
+    static constexpr uint8_t BITRATE_LSB = bitrate & 0xFF;
+    static constexpr uint8_t FDEV_MSB = fdev >> 8;
+    static constexpr uint8_t FDEV_LSB = fdev & 0xFF;
+    static constexpr uint8_t FRF_MSB = (frf >> 16) & 0xFF;
+    static constexpr uint8_t FRF_MID = (frf >> 8) & 0xFF;
+    static constexpr uint8_t FRF_LSB = frf & 0xFF;
+    static constexpr uint8_t PA_LEVEL = rfm69PaLevelReg(Dbm);
+    static constexpr uint8_t RX_BW = rfm69RxBwBits(RxBwHz);
+};
+
+/// RFM69Channel for a carrier frequency in Hz. Usable at run time as well as compile time.
+constexpr RFM69Channel rfm69Channel(uint32_t hz)
+{
+    return RFM69Channel{ { (uint8_t)(rfm69FrfReg(hz) >> 16), (uint8_t)(rfm69FrfReg(hz) >> 8), (uint8_t)rfm69FrfReg(hz) } };
+}
+
+/// Compile time checked carrier frequency
+template <uint32_t Hz>
+struct RFM69ChannelOf
+{
+    static_assert(rfm69FrfValid(Hz), "carrier frequency outside the RFM69 bands");
+    static constexpr RFM69Channel value = rfm69Channel(Hz);
+};
+
+template <uint32_t Hz>
+constexpr RFM69Channel RFM69ChannelOf<Hz>::value;
+
+/// Initialiser for an RFM69Channel, checked at compile time: RFM69Channel c = RFM69_CHANNEL(869500000);
+#define RFM69_CHANNEL(hz) RFM69ChannelOf<(hz)>::value
+
+/// Checks a table of burst runs, each [first register, count, values...] and ending
+/// with a 255 register: runs must be in ascending register order, must not overlap
+/// and must not run past the end of the register map.
+constexpr bool rfm69RunsValid(const uint8_t* runs, int next = 0)
+{
+    return runs[0] == 255 ? true
+        : runs[0] < next || runs[1] == 0 || runs[0] + runs[1] > 0x80 ? false
+        : rfm69RunsValid(runs + 2 + runs[1], runs[0] + runs[1]);
+}
+
+#endif
@@ -0,0 +1,101 @@
+// RFM69Drift.cpp
+//
+// Copyright (C) 2026 the UKHASnet_rfm69 contributors
+
+#include "RFM69Drift.h"
+
+RFM69DriftTracker::RFM69DriftTracker(RFM69& radio)
+{
+    _radio = &radio;
+    _retunes = 0;
+    clear();
+}
+
+void RFM69DriftTracker::clear()
+{
+    memset(_neighbours, 0, sizeof(_neighbours));
+    _count = 0;
+    _clock = 0;
+}
+
+boolean RFM69DriftTracker::heard(uint32_t neighbour, int16_t fei)
+{
+    if (neighbour == 0)
+        neighbour = 1; // 0 marks an empty entry
+    _clock++;
+    Neighbour* entry = NULL;
+    Neighbour* oldest = &_neighbours[0];
+    for (uint8_t i = 0; i < RFM69_DRIFT_NEIGHBOURS; i++) {
+        Neighbour* n = &_neighbours[i];
+        if (n->key == neighbour) {
+            entry = n;
+            break;
+        }
+        if (!n->key || (oldest->key && (uint16_t)(_clock - n->heardAt) > (uint16_t)(_clock - oldest->heardAt)))
+            oldest = n;
+    }
+    if (!entry) {
+        entry = oldest; // An empty entry if there is one
+        if (!entry->key)
+            _count++;
+        entry->key = neighbour;
+        entry->samples = 0;
+    }
+    entry->heardAt = _clock;
+    if (entry->samples++ == 0)
+        entry->offset = (int32_t)fei * 16;
+    else
+        entry->offset += ((int32_t)fei * 16 - entry->offset) / (1 << RFM69_DRIFT_SMOOTHING);
+
+    int16_t common = drift();
+    if (common > -RFM69_DRIFT_RETUNE && common < RFM69_DRIFT_RETUNE)
+        return false;
+    int16_t old = _radio->frequencyTrim();
+    int16_t trim = old + common;
+    if (trim > RFM69_DRIFT_TRIM_MAX)
+        trim = RFM69_DRIFT_TRIM_MAX;
+    if (trim < -RFM69_DRIFT_TRIM_MAX)
+        trim = -RFM69_DRIFT_TRIM_MAX;
+    if (trim == old)
+        return false;
+    _radio->setFrequencyTrim(trim);
+    _retunes++;
+    // Every neighbour is now that much closer
+    for (uint8_t i = 0; i < RFM69_DRIFT_NEIGHBOURS; i++)
+        if (_neighbours[i].key)
+            _neighbours[i].offset -= (int32_t)(trim - old) * 16;
+    return true;
+}
+
+boolean RFM69DriftTracker::offset(uint32_t neighbour, int16_t* offset) const
+{
+    for (uint8_t i = 0; i < RFM69_DRIFT_NEIGHBOURS; i++) {
+        if (_neighbours[i].key == neighbour && neighbour) {
+            *offset = (int16_t)(_neighbours[i].offset / 16);
+            return true;
+        }
+    }
+    return false;
+}
+
+int16_t RFM69DriftTracker::drift() const
+{
+    // Insertion sort of the settled offsets, there are only a few
+    int16_t sorted[RFM69_DRIFT_NEIGHBOURS];
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < RFM69_DRIFT_NEIGHBOURS; i++) {
+        const Neighbour& entry = _neighbours[i];
+        if (!entry.key || entry.samples < RFM69_DRIFT_MIN_SAMPLES)
+            continue;
+        int16_t value = (int16_t)(entry.offset / 16);
+        uint8_t j = n++;
+        while (j > 0 && sorted[j - 1] > value) {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = value;
+    }
+    if (n == 0 || n < RFM69_DRIFT_MIN_NEIGHBOURS)
+        return 0;
+    return n & 1 ? sorted[n / 2] : (int16_t)(((int32_t)sorted[n / 2 - 1] + sorted[n / 2]) / 2);
+}
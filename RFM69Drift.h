@@ -0,0 +1,101 @@
+// RFM69Drift.h
+//
+// Copyright (C) 2026 the UKHASnet_rfm69 contributors
+//
+// Follows the frequency offset of each neighbour, as measured by the AFC on
+// every message (RFM69::setAfc(), RFM69::lastFei()), and retunes the radio to
+// cancel the drift of its own crystal. Each neighbour's crystal is off by its
+// own amount, but when this node's crystal drifts, with temperature say, every
+// neighbour appears to move by the same amount the other way. The tracker takes
+// the median of the neighbours' smoothed offsets as that common part, and once
+// it grows past RFM69_DRIFT_RETUNE moves the carrier by it with
+// RFM69::setFrequencyTrim(). Transmissions are corrected along with reception.
+
+#ifndef RFM69Drift_h
+#define RFM69Drift_h
+
+#include "UKHASnet_rfm69.h"
+
+// Number of neighbours followed. When full, the one heard from longest ago is forgotten.
+// Each costs 12 bytes of SRAM.
+#ifndef RFM69_DRIFT_NEIGHBOURS
+#if defined(__AVR__)
+#define RFM69_DRIFT_NEIGHBOURS  8
+#else
+#define RFM69_DRIFT_NEIGHBOURS  32
+#endif
+#endif
+
+// Messages from a neighbour before its offset counts towards retuning
+#ifndef RFM69_DRIFT_MIN_SAMPLES
+#define RFM69_DRIFT_MIN_SAMPLES 3
+#endif
+
+// Settled neighbours needed before the tracker retunes, so that it does not simply
+// follow the first one heard
+#ifndef RFM69_DRIFT_MIN_NEIGHBOURS
+#define RFM69_DRIFT_MIN_NEIGHBOURS 3
+#endif
+
+// Common offset in FSTEPs (61Hz) that makes the tracker retune, 16 is about 1kHz
+#ifndef RFM69_DRIFT_RETUNE
+#define RFM69_DRIFT_RETUNE      16
+#endif
+
+// Largest correction in FSTEPs, 820 is 50kHz, or 58ppm at 869.5MHz
+#ifndef RFM69_DRIFT_TRIM_MAX
+#define RFM69_DRIFT_TRIM_MAX    820
+#endif
+
+// Weight of each new measurement in a neighbour's smoothed offset, as a shift: 2 is 1/4
+#ifndef RFM69_DRIFT_SMOOTHING
+#define RFM69_DRIFT_SMOOTHING   2
+#endif
+
+class RFM69DriftTracker
+{
+public:
+    /// \param[in] radio The radio to retune. Turn its AFC on with RFM69::setAfc().
+    RFM69DriftTracker(RFM69& radio);
+
+    /// Forgets every neighbour. The radio keeps its current trim.
+    void            clear();
+
+    /// Records the offset of a message, and retunes the radio if the neighbours agree it
+    /// has drifted
+    /// \param[in] neighbour Key for the node the message came from directly, not 0.
+    /// Eg a hash of the last hop of a UKHASnet packet.
+    /// \param[in] fei Its offset, RFM69::lastFei() straight after recv()
+    /// \return true if the radio was retuned
+    boolean         heard(uint32_t neighbour, int16_t fei);
+
+    /// \param[in] neighbour Key passed to heard()
+    /// \param[out] offset Set to the neighbour's smoothed offset from the current tuning, in FSTEPs
+    /// \return false if the neighbour is not known
+    boolean         offset(uint32_t neighbour, int16_t* offset) const;
+
+    /// \return The median offset of the neighbours heard often enough, in FSTEPs, or 0 with
+    /// fewer than RFM69_DRIFT_MIN_NEIGHBOURS of them. What the tracker will correct for once
+    /// it reaches RFM69_DRIFT_RETUNE.
+    int16_t         drift() const;
+
+    uint8_t         neighbours() const { return _count; }   ///< Neighbours being followed
+    uint16_t        retunes() const { return _retunes; }    ///< Times the radio was retuned
+
+private:
+    struct Neighbour
+    {
+        uint32_t    key;        // 0 for an empty entry
+        int32_t     offset;     // Smoothed, in 1/16 FSTEP
+        uint16_t    samples;
+        uint16_t    heardAt;    // Value of _clock when last heard
+    };
+
+    RFM69*          _radio;
+    Neighbour       _neighbours[RFM69_DRIFT_NEIGHBOURS];
+    uint8_t         _count;
+    uint16_t        _clock;
+    uint16_t        _retunes;
+};
+
+#endif
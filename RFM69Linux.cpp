@@ -0,0 +1,193 @@
+// RFM69Linux.cpp
+//
+// Copyright (C) 2026 the UKHASnet_rfm69 contributors
+
+#include "RFM69Linux.h"
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <linux/gpio.h>
+#include <linux/spi/spidev.h>
+
+RFM69SpidevTransport::RFM69SpidevTransport(const char* device, uint32_t speedHz)
+{
+    strncpy(_device, device, sizeof(_device) - 1);
+    _device[sizeof(_device) - 1] = '\0';
+    _speedHz = speedHz;
+    _fd = -1;
+    _messages = 0;
+    _len = 0;
+    _segmentCount = 0;
+}
+
+RFM69SpidevTransport::~RFM69SpidevTransport()
+{
+    if (_fd >= 0)
+        close(_fd);
+}
+
+void RFM69SpidevTransport::begin()
+{
+    if (_fd >= 0)
+        return;
+    _fd = open(_device, O_RDWR | O_CLOEXEC);
+    if (_fd < 0)
+        return;
+    uint8_t mode = SPI_MODE_0;
+    uint8_t bits = 8;
+    if (ioctl(_fd, SPI_IOC_WR_MODE, &mode) < 0
+        || ioctl(_fd, SPI_IOC_WR_BITS_PER_WORD, &bits) < 0
+        || ioctl(_fd, SPI_IOC_WR_MAX_SPEED_HZ, &_speedHz) < 0) {
+        close(_fd);
+        _fd = -1;
+    }
+}
+
+void RFM69SpidevTransport::select()
+{
+    _len = 0;
+    _segmentCount = 0;
+}
+
+void RFM69SpidevTransport::transfer(const uint8_t* src, uint8_t* dest, uint8_t len)
+{
+    if (len > RFM69_SPIDEV_BUF - _len)
+        len = RFM69_SPIDEV_BUF - _len; // Longer than any transaction the driver makes
+    if (src)
+        memcpy(_tx + _len, src, len);
+    else
+        memset(_tx + _len, 0, len);
+    if (dest && _segmentCount < RFM69_SPIDEV_SEGMENTS) {
+        Segment* segment = &_segments[_segmentCount++];
+        segment->dest = dest;
+        segment->offset = _len;
+        segment->len = len;
+    }
+    _len += len;
+}
+
+void RFM69SpidevTransport::deselect()
+{
+    if (_len == 0)
+        return;
+    if (!message(_tx, _rx, _len))
+        memset(_rx, 0, _len);
+    _messages++;
+    for (uint8_t i = 0; i < _segmentCount; i++)
+        memcpy(_segments[i].dest, _rx + _segments[i].offset, _segments[i].len);
+}
+
+boolean RFM69SpidevTransport::message(const uint8_t* tx, uint8_t* rx, uint16_t len)
+{
+    struct spi_ioc_transfer xfer;
+    memset(&xfer, 0, sizeof(xfer));
+    xfer.tx_buf = (unsigned long)tx;
+    xfer.rx_buf = (unsigned long)rx;
+    xfer.len = len;
+    xfer.speed_hz = _speedHz;
+    xfer.bits_per_word = 8;
+    return _fd >= 0 && ioctl(_fd, SPI_IOC_MESSAGE(1), &xfer) >= 0;
+}
+
+RFM69EventLoop::RFM69EventLoop()
+{
+    _epoll = epoll_create1(EPOLL_CLOEXEC);
+    _count = 0;
+}
+
+RFM69EventLoop::~RFM69EventLoop()
+{
+    for (uint8_t i = 0; i < _count; i++)
+        if (_lines[i].owned)
+            close(_lines[i].fd);
+    if (_epoll >= 0)
+        close(_epoll);
+}
+
+boolean RFM69EventLoop::attach(RFM69& radio, const char* chip, uint32_t line, uint8_t dio)
+{
+    int chipFd = open(chip, O_RDONLY | O_CLOEXEC);
+    if (chipFd < 0)
+        return false;
+    struct gpio_v2_line_request request;
+    memset(&request, 0, sizeof(request));
+    request.offsets[0] = line;
+    request.num_lines = 1;
+    strncpy(request.consumer, "rfm69", sizeof(request.consumer) - 1);
+    // DIO1 (FIFOLEVEL) needs both edges, see RFM69::isr1()
+    request.config.flags = GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_EDGE_RISING
+        | (dio ? GPIO_V2_LINE_FLAG_EDGE_FALLING : 0);
+    int result = ioctl(chipFd, GPIO_V2_GET_LINE_IOCTL, &request);
+    close(chipFd);
+    if (result < 0)
+        return false;
+    if (!add(radio, request.fd, dio, true)) {
+        close(request.fd);
+        return false;
+    }
+    return true;
+}
+
+boolean RFM69EventLoop::attachFd(RFM69& radio, int fd, uint8_t dio)
+{
+    return add(radio, fd, dio, false);
+}
+
+boolean RFM69EventLoop::add(RFM69& radio, int fd, uint8_t dio, boolean owned)
+{
+    if (_epoll < 0 || _count == RFM69_EVENTLOOP_MAX)
+        return false;
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.u32 = _count;
+    if (epoll_ctl(_epoll, EPOLL_CTL_ADD, fd, &event) < 0)
+        return false;
+    Line* entry = &_lines[_count++];
+    entry->radio = &radio;
+    entry->fd = fd;
+    entry->dio = dio;
+    entry->owned = owned;
+
+    // Only edges are reported, so a line that is already high would never be seen. The
+    // ioctl fails harmlessly on a descriptor that is not a GPIO line, eg a pipe.
+    struct gpio_v2_line_values values;
+    memset(&values, 0, sizeof(values));
+    values.mask = 1;
+    if (ioctl(fd, GPIO_V2_LINE_GET_VALUES_IOCTL, &values) == 0 && (values.bits & 1))
+        handle(*entry);
+    return true;
+}
+
+void RFM69EventLoop::handle(const Line& entry)
+{
+    if (entry.dio)
+        entry.radio->isr1();
+    else
+        entry.radio->isr0();
+}
+
+int RFM69EventLoop::wait(int timeoutMs)
+{
+    struct epoll_event events[RFM69_EVENTLOOP_MAX];
+    int ready = epoll_wait(_epoll, events, RFM69_EVENTLOOP_MAX, timeoutMs);
+    if (ready < 0)
+        return errno == EINTR ? 0 : -1;
+    for (int i = 0; i < ready; i++) {
+        Line* entry = &_lines[events[i].data.u32];
+        // However many edges are queued, one pass of the handler sees the state they led to
+        struct gpio_v2_line_event edges[16];
+        if (read(entry->fd, edges, sizeof(edges)) < 0 && errno != EAGAIN)
+            return -1;
+        handle(*entry);
+    }
+    return ready;
+}
+
+#endif
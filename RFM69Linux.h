@@ -0,0 +1,138 @@
+// RFM69Linux.h
+//
+// Copyright (C) 2026 the UKHASnet_rfm69 contributors
+//
+// Runs the driver on a Linux gateway: SPI through spidev, with each transaction
+// sent as a single ioctl, and DIO0/DIO1 through the GPIO character device (v2
+// uAPI, Linux 5.10 or later), with edges waited for on epoll so that an idle
+// gateway uses no CPU.
+//
+//   RFM69SpidevTransport spi("/dev/spidev0.0");
+//   RFM69 radio(spi);
+//   RFM69EventLoop events;
+//   radio.init();
+//   events.attach(radio, "/dev/gpiochip0", 25);   // DIO0 on GPIO25
+//   for (;;) {
+//       events.wait(1000);
+//       while (radio.recv(buf, &len)) ...
+//   }
+//
+// Everything, including the "interrupt" handlers, runs on the thread calling
+// wait(), so the driver needs no locking.
+
+#ifndef RFM69Linux_h
+#define RFM69Linux_h
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include "UKHASnet_rfm69.h"
+
+// Largest SPI transaction, the address byte and a full FIFO with room to spare
+#define RFM69_SPIDEV_BUF        260
+
+// Most transfer() calls with a destination in one transaction
+#define RFM69_SPIDEV_SEGMENTS   8
+
+// Most DIO lines one event loop waits on
+#ifndef RFM69_EVENTLOOP_MAX
+#define RFM69_EVENTLOOP_MAX     8
+#endif
+
+/// Transport over a Linux spidev device. select() and transfer() only collect the
+/// transaction, deselect() clocks it with one SPI_IOC_MESSAGE ioctl, chip select
+/// held throughout.
+class RFM69SpidevTransport : public RFM69Transport
+{
+public:
+    /// \param[in] device Path of the spidev device, copied
+    /// \param[in] speedHz SPI clock, the RFM69 takes up to 10MHz
+    RFM69SpidevTransport(const char* device = "/dev/spidev0.0", uint32_t speedHz = 8000000);
+    virtual ~RFM69SpidevTransport();
+
+    /// Opens the device, in SPI mode 0 with 8 bit words. Does nothing if it is open already.
+    void        begin();
+    void        select();
+    void        transfer(const uint8_t* src, uint8_t* dest, uint8_t len);
+    void        deselect();
+
+    /// \return true if begin() opened the device
+    boolean     isOpen() const { return _fd >= 0; }
+
+    /// \return Number of transactions, each one ioctl, sent so far
+    uint32_t    messages() const { return _messages; }
+
+protected:
+    /// Clocks one whole transaction
+    /// \param[in] tx Bytes to send
+    /// \param[out] rx Where to store the bytes received, len of them
+    /// \param[in] len Number of bytes
+    /// \return false if the ioctl failed
+    virtual boolean message(const uint8_t* tx, uint8_t* rx, uint16_t len);
+
+private:
+    struct Segment
+    {
+        uint8_t*    dest;
+        uint16_t    offset;
+        uint8_t     len;
+    };
+
+    char        _device[64];
+    uint32_t    _speedHz;
+    int         _fd;
+    uint32_t    _messages;
+
+    uint8_t     _tx[RFM69_SPIDEV_BUF];
+    uint8_t     _rx[RFM69_SPIDEV_BUF];
+    uint16_t    _len;
+    Segment     _segments[RFM69_SPIDEV_SEGMENTS];
+    uint8_t     _segmentCount;
+};
+
+/// Waits on GPIO edges for any number of radios and runs their interrupt handlers
+class RFM69EventLoop
+{
+public:
+    RFM69EventLoop();
+    ~RFM69EventLoop();
+
+    /// Requests a GPIO line as an input and runs the radio's handler on its edges:
+    /// isr0() on rising edges of DIO0, isr1() on both edges of DIO1. If the line is
+    /// already high, eg a packet arrived before the loop started, the handler runs once now.
+    /// \param[in] radio The radio, init() it first
+    /// \param[in] chip GPIO chip device, eg "/dev/gpiochip0"
+    /// \param[in] line Line offset on that chip
+    /// \param[in] dio 0 for DIO0, 1 for DIO1
+    /// \return false if the line could not be requested
+    boolean     attach(RFM69& radio, const char* chip, uint32_t line, uint8_t dio = 0);
+
+    /// Same as attach(), for a descriptor that already delivers struct gpio_v2_line_event
+    /// records, such as a line requested elsewhere or a test stand-in. Not closed by this.
+    /// Its level is read as for attach() where it is a GPIO line.
+    boolean     attachFd(RFM69& radio, int fd, uint8_t dio = 0);
+
+    /// Waits for edges and runs the handler of every line that has had one
+    /// \param[in] timeoutMs Longest wait, -1 to wait for ever, 0 to only poll
+    /// \return Number of handlers run, 0 on a timeout, -1 on error
+    int         wait(int timeoutMs);
+
+private:
+    struct Line
+    {
+        RFM69*      radio;
+        int         fd;
+        uint8_t     dio;
+        boolean     owned;  // Requested by attach(), closed by the destructor
+    };
+
+    boolean     add(RFM69& radio, int fd, uint8_t dio, boolean owned);
+    void        handle(const Line& entry);
+
+    int         _epoll;
+    Line        _lines[RFM69_EVENTLOOP_MAX];
+    uint8_t     _count;
+};
+
+#endif
+
+#endif
@@ -0,0 +1,349 @@
+// RFM69PacketLog.cpp
+//
+// Copyright (C) 2026 the UKHASnet_rfm69 contributors
+
+#include "RFM69PacketLog.h"
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "UKHASnetPacket.h"
+
+#define LOG_MAGIC       "RFM69LOG"
+#define LOG_VERSION     1
+#define LOG_HEADER      64
+
+// File header
+//   0  char[8] magic
+//   8  uint32  version
+//  12  uint32  block size
+
+// Record, little endian as the host is
+//   0  uint16  size, header included. 0 ends the records in a block.
+//   2  uint8   frame length
+//   3  uint8   offset of the origin node in the frame
+//   4  uint8   length of the origin node, 0 if the frame did not parse
+//   5  int8    rssi
+//   6  uint64  time
+//  14  frame
+#define RECORD_HEADER   14
+
+// Index, the last INDEX_SIZE bytes of a finished block
+//   0  char[4] magic
+//   4  uint32  records
+//   8  uint64  earliest time
+//  16  uint64  latest time
+//  24  uint32  bytes of records
+//  28  uint32  reserved
+//  32  uint8[32] Bloom filter of origin nodes
+#define INDEX_MAGIC     "RIDX"
+#define INDEX_SIZE      64
+#define RECORDS_MAX     (RFM69_LOG_BLOCK - INDEX_SIZE)
+
+#if RFM69_LOG_BLOCK < 4096 || (RFM69_LOG_BLOCK & (RFM69_LOG_BLOCK - 1)) != 0
+#error RFM69_LOG_BLOCK must be a power of 2, at least 4096
+#endif
+
+// Two bits of the Bloom filter, taken from ukhasnetHash() of the origin
+static void bloomAdd(uint8_t* bloom, uint32_t hash)
+{
+    bloom[(hash & 0xFF) >> 3] |= 1 << (hash & 7);
+    bloom[((hash >> 8) & 0xFF) >> 3] |= 1 << ((hash >> 8) & 7);
+}
+
+static boolean bloomHas(const uint8_t* bloom, uint32_t hash)
+{
+    return (bloom[(hash & 0xFF) >> 3] & (1 << (hash & 7)))
+        && (bloom[((hash >> 8) & 0xFF) >> 3] & (1 << ((hash >> 8) & 7)));
+}
+
+static boolean validHeader(const uint8_t* header)
+{
+    uint32_t version;
+    uint32_t block;
+    memcpy(&version, header + 8, 4);
+    memcpy(&block, header + 12, 4);
+    return memcmp(header, LOG_MAGIC, 8) == 0 && version == LOG_VERSION && block == RFM69_LOG_BLOCK;
+}
+
+// Checks the record at pos of a block holding limit bytes of records
+// \return Its size, 0 if there is none or it is torn
+static uint16_t recordSize(const uint8_t* block, uint32_t pos, uint32_t limit)
+{
+    if (pos + RECORD_HEADER > limit)
+        return 0;
+    const uint8_t* rec = block + pos;
+    uint16_t size;
+    memcpy(&size, rec, 2);
+    if (size != RECORD_HEADER + rec[2] || pos + size > limit || rec[3] + rec[4] > rec[2])
+        return 0;
+    return size;
+}
+
+RFM69PacketLog::RFM69PacketLog()
+{
+    _fd = -1;
+    _appended = 0;
+}
+
+RFM69PacketLog::~RFM69PacketLog()
+{
+    close();
+}
+
+boolean RFM69PacketLog::open(const char* path)
+{
+    close();
+    _fd = ::open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (_fd < 0)
+        return false;
+    struct stat st;
+    uint8_t header[LOG_HEADER];
+    if (fstat(_fd, &st) < 0) {
+        close();
+        return false;
+    }
+    if (st.st_size < LOG_HEADER) {
+        // New, or never got as far as a whole header
+        memset(header, 0, sizeof(header));
+        memcpy(header, LOG_MAGIC, 8);
+        uint32_t version = LOG_VERSION;
+        uint32_t block = RFM69_LOG_BLOCK;
+        memcpy(header + 8, &version, 4);
+        memcpy(header + 12, &block, 4);
+        if (ftruncate(_fd, 0) < 0 || pwrite(_fd, header, LOG_HEADER, 0) != LOG_HEADER) {
+            close();
+            return false;
+        }
+        st.st_size = LOG_HEADER;
+    } else if (pread(_fd, header, LOG_HEADER, 0) != LOG_HEADER || !validHeader(header)) {
+        close();
+        return false;
+    }
+
+    // Carry on with the last block if it is unfinished, minus anything torn
+    uint64_t body = st.st_size - LOG_HEADER;
+    _blockAt = LOG_HEADER + body / RFM69_LOG_BLOCK * RFM69_LOG_BLOCK;
+    uint32_t partial = (uint32_t)(body % RFM69_LOG_BLOCK);
+    if (partial > RECORDS_MAX)
+        partial = RECORDS_MAX; // Padded, but the index did not make it
+    if (partial && pread(_fd, _block, partial, _blockAt) != (ssize_t)partial) {
+        close();
+        return false;
+    }
+    _used = 0;
+    _count = 0;
+    _earliest = 0;
+    _latest = 0;
+    memset(_bloom, 0, sizeof(_bloom));
+    for (uint16_t size; (size = recordSize(_block, _used, partial)) != 0; _used += size) {
+        const uint8_t* rec = _block + _used;
+        uint64_t time;
+        memcpy(&time, rec + 6, 8);
+        if (_count == 0 || time < _earliest)
+            _earliest = time;
+        if (_count == 0 || time > _latest)
+            _latest = time;
+        if (rec[4])
+            bloomAdd(_bloom, ukhasnetHash(rec + RECORD_HEADER + rec[3], rec[4]));
+        _count++;
+    }
+    if (_blockAt + _used < (uint64_t)st.st_size && ftruncate(_fd, _blockAt + _used) < 0) {
+        close();
+        return false;
+    }
+    _written = _used;
+    return true;
+}
+
+void RFM69PacketLog::close()
+{
+    if (_fd < 0)
+        return;
+    flush();
+    ::close(_fd);
+    _fd = -1;
+}
+
+boolean RFM69PacketLog::append(const uint8_t* data, uint8_t len, int rssi, uint64_t time)
+{
+    if (_fd < 0)
+        return false;
+    if (time == 0) {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        time = (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+    }
+    uint16_t size = RECORD_HEADER + len;
+    if (_used + size > RECORDS_MAX && !finishBlock())
+        return false;
+
+    uint8_t* rec = _block + _used;
+    memcpy(rec, &size, 2);
+    rec[2] = len;
+    rec[3] = 0;
+    rec[4] = 0;
+    rec[5] = (uint8_t)(int8_t)(rssi < -128 ? -128 : rssi > 127 ? 127 : rssi);
+    memcpy(rec + 6, &time, 8);
+    memcpy(rec + RECORD_HEADER, data, len);
+    UKHASnetPacket packet;
+    if (packet.parse(rec + RECORD_HEADER, len)) {
+        rec[3] = (uint8_t)((const uint8_t*)packet.origin().ptr - (rec + RECORD_HEADER));
+        rec[4] = packet.origin().len;
+        bloomAdd(_bloom, packet.origin().hash());
+    }
+    if (_count == 0 || time < _earliest)
+        _earliest = time;
+    if (_count == 0 || time > _latest)
+        _latest = time;
+    _count++;
+    _used += size;
+    _appended++;
+    return true;
+}
+
+boolean RFM69PacketLog::flush()
+{
+    if (_fd < 0)
+        return false;
+    if (_written == _used)
+        return true;
+    if (pwrite(_fd, _block + _written, _used - _written, _blockAt + _written) != (ssize_t)(_used - _written))
+        return false;
+    _written = _used;
+    return true;
+}
+
+boolean RFM69PacketLog::finishBlock()
+{
+    memset(_block + _used, 0, RECORDS_MAX - _used);
+    uint8_t* index = _block + RECORDS_MAX;
+    memset(index, 0, INDEX_SIZE);
+    memcpy(index, INDEX_MAGIC, 4);
+    memcpy(index + 4, &_count, 4);
+    memcpy(index + 8, &_earliest, 8);
+    memcpy(index + 16, &_latest, 8);
+    memcpy(index + 24, &_used, 4);
+    memcpy(index + 32, _bloom, sizeof(_bloom));
+    if (pwrite(_fd, _block + _written, RFM69_LOG_BLOCK - _written, _blockAt + _written)
+        != (ssize_t)(RFM69_LOG_BLOCK - _written))
+        return false;
+    _blockAt += RFM69_LOG_BLOCK;
+    _used = 0;
+    _written = 0;
+    _count = 0;
+    memset(_bloom, 0, sizeof(_bloom));
+    return true;
+}
+
+RFM69PacketLogReader::RFM69PacketLogReader()
+{
+    _map = NULL;
+    _size = 0;
+    _blocks = 0;
+}
+
+RFM69PacketLogReader::~RFM69PacketLogReader()
+{
+    close();
+}
+
+boolean RFM69PacketLogReader::open(const char* path)
+{
+    close();
+    int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size < LOG_HEADER) {
+        ::close(fd);
+        return false;
+    }
+    void* map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED)
+        return false;
+    _map = (const uint8_t*)map;
+    _size = st.st_size;
+    if (!validHeader(_map)) {
+        close();
+        return false;
+    }
+    _blocks = (uint32_t)((_size - LOG_HEADER + RFM69_LOG_BLOCK - 1) / RFM69_LOG_BLOCK);
+    return true;
+}
+
+void RFM69PacketLogReader::close()
+{
+    if (_map)
+        munmap((void*)_map, _size);
+    _map = NULL;
+    _size = 0;
+    _blocks = 0;
+}
+
+uint32_t RFM69PacketLogReader::scan(uint64_t from, uint64_t to, const char* origin,
+                                    boolean (*visit)(void* ctx, const RFM69LogRecord& record), void* ctx,
+                                    RFM69LogScan* work) const
+{
+    RFM69LogScan done;
+    memset(&done, 0, sizeof(done));
+    uint8_t originLen = origin ? (uint8_t)strlen(origin) : 0;
+    uint32_t hash = origin ? ukhasnetHash(origin, originLen) : 0;
+    boolean stop = false;
+
+    for (uint32_t b = 0; b < _blocks && !stop; b++) {
+        const uint8_t* block = _map + LOG_HEADER + (size_t)b * RFM69_LOG_BLOCK;
+        size_t have = _size - (block - _map);
+        uint32_t limit = have < RECORDS_MAX ? (uint32_t)have : RECORDS_MAX;
+        const uint8_t* index = NULL;
+        uint32_t indexed = 0;
+        if (have >= RFM69_LOG_BLOCK && memcmp(block + RECORDS_MAX, INDEX_MAGIC, 4) == 0) {
+            index = block + RECORDS_MAX;
+            memcpy(&indexed, index + 24, 4);
+            if (indexed > RECORDS_MAX)
+                index = NULL; // Damaged, records cannot run into it. Read as if it had none.
+        }
+        if (index) {
+            uint64_t earliest;
+            uint64_t latest;
+            memcpy(&earliest, index + 8, 8);
+            memcpy(&latest, index + 16, 8);
+            limit = indexed;
+            if (latest < from || earliest > to || (origin && !bloomHas(index + 32, hash))) {
+                done.blocksSkipped++;
+                continue;
+            }
+        }
+        done.blocksRead++;
+
+        for (uint32_t pos = 0, size; !stop && (size = recordSize(block, pos, limit)) != 0; pos += size) {
+            const uint8_t* rec = block + pos;
+            done.read++;
+            RFM69LogRecord record;
+            memcpy(&record.time, rec + 6, 8);
+            if (record.time < from || record.time > to)
+                continue;
+            record.data = rec + RECORD_HEADER;
+            record.len = rec[2];
+            record.origin = (const char*)record.data + rec[3];
+            record.originLen = rec[4];
+            if (origin && (record.originLen != originLen || memcmp(record.origin, origin, originLen) != 0))
+                continue;
+            record.rssi = (int8_t)rec[5];
+            done.matched++;
+            if (visit && !visit(ctx, record))
+                stop = true;
+        }
+    }
+    if (work)
+        *work = done;
+    return done.matched;
+}
+
+#endif
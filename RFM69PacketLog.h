@@ -0,0 +1,135 @@
+// RFM69PacketLog.h
+//
+// Copyright (C) 2026 the UKHASnet_rfm69 contributors
+//
+// Compact binary log of received packets for later analysis on a gateway,
+// with a reader that answers "what did we hear between these times" and
+// "what came from this node" from a memory mapping without looking at most
+// of the file.
+//
+// The file is a 64 byte header and then fixed size blocks. Records, each a
+// 14 byte header (length, time, RSSI, where the origin node is in the frame)
+// and the raw frame, are appended to a block until the next would not fit,
+// then the block is finished with an index at its very end: how many records
+// it holds, the earliest and latest time, and a Bloom filter of the origin nodes.
+// Blocks are only ever appended, so a crash can at worst leave the last block
+// unfinished, with a torn record at its end that the writer cuts off when it
+// opens the file again. The reader only walks the records of the blocks whose
+// index says they might hold a match, and of the unfinished last block.
+
+#ifndef RFM69PacketLog_h
+#define RFM69PacketLog_h
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include "UKHASnet_rfm69.h"
+
+// Size of a block, index included. Larger blocks waste less space on indexes and
+// padding, smaller ones let queries skip more.
+#ifndef RFM69_LOG_BLOCK
+#define RFM69_LOG_BLOCK     65536
+#endif
+
+/// One logged packet, as handed out by RFM69PacketLogReader. The pointers are into
+/// the reader's mapping of the file and valid until it is closed.
+struct RFM69LogRecord
+{
+    uint64_t        time;       ///< Wall clock time received, in milliseconds since 1970
+    int8_t          rssi;       ///< In dBm
+    uint8_t         len;
+    const uint8_t*  data;       ///< The frame as received
+    uint8_t         originLen;  ///< 0 if the frame was not a UKHASnet packet
+    const char*     origin;     ///< The origin node, inside data. Not NUL terminated.
+};
+
+/// Work done by one RFM69PacketLogReader::scan()
+struct RFM69LogScan
+{
+    uint32_t        matched;    ///< Records passed to the visitor
+    uint32_t        read;       ///< Records looked at
+    uint32_t        blocksRead; ///< Blocks whose records were looked at
+    uint32_t        blocksSkipped; ///< Blocks ruled out from their index alone
+};
+
+/// Appends to a packet log
+class RFM69PacketLog
+{
+public:
+    RFM69PacketLog();
+    ~RFM69PacketLog();
+
+    /// Opens a log, creating it if need be. An existing log is appended to, after
+    /// cutting off anything torn at its end.
+    /// \return false if the file could not be opened, or is not a log
+    boolean         open(const char* path);
+
+    /// Writes out what is buffered and closes the file
+    void            close();
+
+    /// Adds a packet. It is buffered until the block fills or flush() is called.
+    /// \param[in] data The frame, as from RFM69::recv()
+    /// \param[in] len Its length
+    /// \param[in] rssi Its signal strength in dBm, eg RFM69::lastRssi()
+    /// \param[in] time Wall clock time in milliseconds since 1970, 0 for now
+    /// \return false if the file could not be written
+    boolean         append(const uint8_t* data, uint8_t len, int rssi, uint64_t time = 0);
+
+    /// Writes out the records buffered so far
+    /// \return false if the file could not be written
+    boolean         flush();
+
+    /// \return Packets appended since open()
+    uint32_t        appended() const { return _appended; }
+
+private:
+    boolean         finishBlock();
+
+    int             _fd;
+    uint64_t        _blockAt;       // File offset of the current block
+    uint32_t        _used;          // Bytes of records in it
+    uint32_t        _written;       // Bytes of it already in the file
+    uint32_t        _count;
+    uint64_t        _earliest;
+    uint64_t        _latest;
+    uint8_t         _bloom[32];
+    uint32_t        _appended;
+    uint8_t         _block[RFM69_LOG_BLOCK];
+};
+
+/// Queries a packet log through a read only mapping
+class RFM69PacketLogReader
+{
+public:
+    RFM69PacketLogReader();
+    ~RFM69PacketLogReader();
+
+    /// Maps a log. Packets appended after this are not seen until it is opened again.
+    /// \return false if the file could not be mapped, or is not a log
+    boolean         open(const char* path);
+    void            close();
+
+    /// Passes each packet received in a time range, optionally only those from one node,
+    /// to a visitor, in the order they were logged
+    /// \param[in] from Earliest time, in milliseconds since 1970
+    /// \param[in] to Latest time, inclusive
+    /// \param[in] origin Only packets first sent by this node, NULL for all
+    /// \param[in] visit Called with each match, returns false to stop the scan
+    /// \param[in] ctx Passed to visit
+    /// \param[out] work If not NULL, the work done
+    /// \return Number of packets passed to visit
+    uint32_t        scan(uint64_t from, uint64_t to, const char* origin,
+                         boolean (*visit)(void* ctx, const RFM69LogRecord& record), void* ctx,
+                         RFM69LogScan* work = NULL) const;
+
+    /// \return Number of blocks in the log, including an unfinished last one
+    uint32_t        blocks() const { return _blocks; }
+
+private:
+    const uint8_t*  _map;
+    size_t          _size;
+    uint32_t        _blocks;
+};
+
+#endif
+
+#endif
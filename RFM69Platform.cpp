@@ -0,0 +1,74 @@
+// RFM69Platform.cpp
+//
+// Copyright (C) 2026 the UKHASnet_rfm69 contributors
+//
+// Host implementations of the Arduino core calls declared in RFM69Platform.h
+
+#if !defined(ARDUINO)
+
+#include <time.h>
+#include "RFM69Platform.h"
+
+static RFM69HostClock*  hostClock = NULL;
+static bool             hostInterruptsEnabled = true;
+
+static uint64_t wallMicros()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void rfm69SetHostClock(RFM69HostClock* clock)
+{
+    hostClock = clock;
+}
+
+uint32_t micros()
+{
+    if (hostClock)
+        return hostClock->micros();
+    return (uint32_t)wallMicros();
+}
+
+uint32_t millis()
+{
+    if (hostClock)
+        return hostClock->millis();
+    return (uint32_t)(wallMicros() / 1000);
+}
+
+void delayMicroseconds(uint32_t us)
+{
+    if (hostClock) {
+        hostClock->delayMicroseconds(us);
+        return;
+    }
+    struct timespec ts;
+    ts.tv_sec = us / 1000000;
+    ts.tv_nsec = (long)(us % 1000000) * 1000;
+    nanosleep(&ts, NULL);
+}
+
+void delay(uint32_t ms)
+{
+    while (ms--)
+        delayMicroseconds(1000);
+}
+
+void noInterrupts()
+{
+    hostInterruptsEnabled = false;
+}
+
+void interrupts()
+{
+    hostInterruptsEnabled = true;
+}
+
+bool rfm69HostInterruptsEnabled()
+{
+    return hostInterruptsEnabled;
+}
+
+#endif
@@ -0,0 +1,66 @@
+// RFM69Platform.h
+//
+// Copyright (C) 2026 the UKHASnet_rfm69 contributors
+//
+// The handful of Arduino core calls used by the driver. On the target these
+// come straight from the Arduino core, on a Linux host they are provided by
+// RFM69Platform.cpp so the driver can be built and exercised off-target.
+
+#ifndef RFM69Platform_h
+#define RFM69Platform_h
+
+#if defined(ARDUINO)
+
+#include <Arduino.h>
+#include <SPI.h>
+
+// Keeps the compiler from moving buffer accesses across the publication of a queue index.
+// Single core targets only need the compiler held back.
+#define RFM69_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+#else
+
+// On a host the interrupt side may be another thread, so use a real fence
+#define RFM69_BARRIER() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+#include <stdint.h>
+#include <string.h>
+
+/// Time source used by millis(), micros() and delay() on a host build.
+/// By default the host wall clock is used; a simulator installs itself here so
+/// that driver delays advance simulated time instead of sleeping.
+class RFM69HostClock
+{
+public:
+    virtual ~RFM69HostClock() {}
+
+    /// \return Microseconds since an arbitrary epoch, wrapping like the Arduino micros()
+    virtual uint32_t    micros() = 0;
+
+    /// \return Milliseconds since the same epoch, wrapping like the Arduino millis(), after
+    /// 2^32ms rather than when micros() does
+    virtual uint32_t    millis() = 0;
+
+    /// Lets us microseconds of time pass
+    virtual void        delayMicroseconds(uint32_t us) = 0;
+};
+
+/// Installs the clock used by the host timing functions
+/// \param[in] clock The new clock, or NULL to return to the wall clock
+void            rfm69SetHostClock(RFM69HostClock* clock);
+
+uint32_t        millis();
+uint32_t        micros();
+void            delay(uint32_t ms);
+void            delayMicroseconds(uint32_t us);
+
+/// The host has no interrupt controller. These only track whether the driver
+/// currently has "interrupts" masked, so that simulated DIO interrupts can be
+/// deferred exactly as they would be on the target.
+void            noInterrupts();
+void            interrupts();
+bool            rfm69HostInterruptsEnabled();
+
+#endif
+
+#endif
@@ -0,0 +1,72 @@
+// RFM69Scheduler.cpp
+//
+// Copyright (C) 2026 the UKHASnet_rfm69 contributors
+
+#include "RFM69Scheduler.h"
+
+RFM69Scheduler::RFM69Scheduler()
+{
+    _count = 0;
+    _next = 0;
+    _leased = RFM69_SCHEDULER_MAX;
+}
+
+boolean RFM69Scheduler::add(RFM69& radio)
+{
+    if (_count == RFM69_SCHEDULER_MAX)
+        return false;
+    _radios[_count++] = &radio;
+    return true;
+}
+
+boolean RFM69Scheduler::init()
+{
+    // A chip select pin that has not been set up yet may float low, and that radio
+    // would then answer on the bus while another is being set up
+    for (uint8_t i = 0; i < _count; i++)
+        _radios[i]->transport().begin();
+    boolean ok = true;
+    for (uint8_t i = 0; i < _count; i++)
+        ok &= _radios[i]->init();
+    return ok;
+}
+
+boolean RFM69Scheduler::poll(uint8_t* buf, uint8_t* len, uint8_t* index)
+{
+    const uint8_t* data;
+    uint8_t dataLen;
+    if (!pollLease(&data, &dataLen, index))
+        return false;
+    if (*len > dataLen)
+        *len = dataLen;
+    memcpy(buf, data, *len);
+    release();
+    return true;
+}
+
+boolean RFM69Scheduler::pollLease(const uint8_t** buf, uint8_t* len, uint8_t* index)
+{
+    for (uint8_t i = 0; i < _count; i++) {
+        _radios[i]->service();
+        _radios[i]->txPending();
+    }
+    for (uint8_t n = 0; n < _count; n++) {
+        uint8_t i = (_next + n) % _count;
+        if (_radios[i]->recvLease(buf, len)) {
+            _next = (i + 1) % _count;
+            _leased = i;
+            if (index)
+                *index = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+void RFM69Scheduler::release()
+{
+    if (_leased == RFM69_SCHEDULER_MAX)
+        return;
+    _radios[_leased]->recvRelease();
+    _leased = RFM69_SCHEDULER_MAX;
+}
@@ -0,0 +1,60 @@
+// RFM69Scheduler.h
+//
+// Copyright (C) 2026 the UKHASnet_rfm69 contributors
+//
+// Runs several RFM69 radios from one main loop, eg a gateway listening on more
+// than one channel at once. Each radio has its own transport (chip select) and
+// interrupt. The scheduler keeps every radio's bottom half and transmit queue
+// moving and hands out received messages round robin, one per radio per turn,
+// so a busy channel cannot starve the others.
+
+#ifndef RFM69Scheduler_h
+#define RFM69Scheduler_h
+
+#include "UKHASnet_rfm69.h"
+
+// Most radios one scheduler can run
+#ifndef RFM69_SCHEDULER_MAX
+#define RFM69_SCHEDULER_MAX 4
+#endif
+
+class RFM69Scheduler
+{
+public:
+    RFM69Scheduler();
+
+    /// Adds a radio. Call before init().
+    /// \param[in] radio The radio, with its own transport and interrupt
+    /// \return false if there are already RFM69_SCHEDULER_MAX radios
+    boolean         add(RFM69& radio);
+
+    /// Deselects every radio on the bus, then initialises them in turn
+    /// \return true if every radio initialised
+    boolean         init();
+
+    uint8_t         count() const { return _count; }
+    RFM69&          radio(uint8_t i) { return *_radios[i]; }
+
+    /// Runs the bottom half and the transmit queue of every radio, then takes the next
+    /// received message, starting with the radio after the one that gave the last
+    /// \param[out] buf Where to copy the message
+    /// \param[in,out] len Available space in buf. Set to the number of bytes copied.
+    /// \param[out] index If not NULL, set to the number of the radio that received it
+    /// \return true if a message was copied
+    boolean         poll(uint8_t* buf, uint8_t* len, uint8_t* index = NULL);
+
+    /// Same as poll(), but leases the message in place, see RFM69::recvLease().
+    /// Call release() when done with it, before the next poll().
+    boolean         pollLease(const uint8_t** buf, uint8_t* len, uint8_t* index = NULL);
+
+    /// Hands the message from pollLease() back to its radio
+    void            release();
+
+private:
+    RFM69*          _radios[RFM69_SCHEDULER_MAX];
+    uint8_t         _count;
+    uint8_t         _next;      // Radio to look at first
+    uint8_t         _leased;    // Radio holding a leased message, or RFM69_SCHEDULER_MAX
+};
+
+#endif
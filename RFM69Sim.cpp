@@ -0,0 +1,964 @@
+// RFM69Sim.cpp
+//
+// Copyright (C) 2026 the UKHASnet_rfm69 contributors
+//
+// Register level model of the RFM69 (SX1231) for host builds. See RFM69Sim.h
+
+#if !defined(ARDUINO)
+
+#include "RFM69Sim.h"
+#include "RFM69Aes.h"
+
+// Value returned from RegVersion
+#define RFM69_SIM_VERSION   0x24
+
+// Synthesiser settling time for a hop (TS_HOP), which grows with the size of the step
+#define RFM69_SIM_HOP_SMALL_NS  20000   // Up to 1MHz
+#define RFM69_SIM_HOP_MEDIUM_NS 50000   // Up to 5MHz
+#define RFM69_SIM_HOP_LARGE_NS  80000
+
+RFM69Sim::RFM69Sim(uint32_t spiClockHz)
+{
+    _spiByteTime = 8000000000ULL / spiClockHz;
+    _selectOverhead = 0;
+    _now = 0;
+    _txHandler = NULL;
+    _txHandlerCtx = NULL;
+    for (uint8_t i = 0; i < RFM69_SIM_NUM_DIO; i++) {
+        _dioHandler[i] = NULL;
+        _dioHandlerCtx[i] = NULL;
+        _dioEdge[i] = RFM69_SIM_RISING;
+    }
+    _inHandler = false;
+    _noise = 0xFF; // -127.5 dBm, a quiet channel
+    _noiseJitter = 0;
+    _noiseSeed = 2463534242UL;
+    _carrierUntil = 0;
+    _carrierRssi = 0xFF;
+    _heldRssi = 0xFF;
+    _temperature = 25;
+    _supplyMv = 3300;
+    clearStats();
+    reset();
+}
+
+void RFM69Sim::reset()
+{
+    memset(_regs, 0, sizeof(_regs));
+    _regs[RFM69_REG_01_OPMODE]          = RF_OPMODE_STANDBY;
+    _regs[RFM69_REG_03_BITRATE_MSB]     = 0x1A; // 4.8 kbps
+    _regs[RFM69_REG_04_BITRATE_LSB]     = 0x0B;
+    _regs[RFM69_REG_05_FDEV_MSB]        = 0x00; // 5 kHz
+    _regs[RFM69_REG_06_FDEV_LSB]        = 0x52;
+    _regs[RFM69_REG_07_FRF_MSB]         = 0xE4; // 915 MHz
+    _regs[RFM69_REG_08_FRF_MID]         = 0xC0;
+    _regs[RFM69_REG_09_FRF_LSB]         = 0x00;
+    _regs[RFM69_REG_0D_LISTEN1]         = RF_LISTEN1_RESOL_IDLE_4100 | RF_LISTEN1_RESOL_RX_64 | RF_LISTEN1_END_01;
+    _regs[RFM69_REG_0E_LISTEN2]         = RF_LISTEN2_COEFIDLE_VALUE;
+    _regs[RFM69_REG_0F_LISTEN3]         = RF_LISTEN3_COEFRX_VALUE;
+    _regs[RFM69_REG_10_VERSION]         = RFM69_SIM_VERSION;
+    _regs[RFM69_REG_11_PA_LEVEL]        = 0x9F;
+    _regs[RFM69_REG_13_OCP]             = RF_OCP_ON | RF_OCP_TRIM_95;
+    _regs[RFM69_REG_18_LNA]             = RF_LNA_ZIN_200;
+    _regs[RFM69_REG_19_RX_BW]           = RF_RXBW_DCCFREQ_010 | RF_RXBW_MANT_24 | RF_RXBW_EXP_5;
+    _regs[RFM69_REG_1A_AFC_BW]          = RF_AFCBW_DCCFREQAFC_100 | RF_AFCBW_MANTAFC_20 | RF_AFCBW_EXPAFC_3;
+    _regs[RFM69_REG_24_RSSI_VALUE]      = 0xFF;
+    _regs[RFM69_REG_26_DIO_MAPPING2]    = RF_DIOMAPPING2_CLKOUT_OFF;
+    _regs[RFM69_REG_29_RSSI_THRESHOLD]  = RF_RSSITHRESH_VALUE;
+    _regs[RFM69_REG_2D_PREAMBLE_LSB]    = RF_PREAMBLESIZE_LSB_VALUE;
+    _regs[RFM69_REG_2E_SYNC_CONFIG]     = RF_SYNC_ON | RF_SYNC_SIZE_4;
+    _regs[RFM69_REG_37_PACKET_CONFIG1]  = RF_PACKET1_CRC_ON;
+    _regs[RFM69_REG_38_PAYLOAD_LENGTH]  = RF_PAYLOADLENGTH_VALUE;
+    _regs[RFM69_REG_3C_FIFO_THRESHOLD]  = RF_FIFOTHRESH_TXSTART_FIFONOTEMPTY | RF_FIFOTHRESH_VALUE;
+    _regs[RFM69_REG_3D_PACKET_CONFIG2]  = RF_PACKET2_AUTORXRESTART_ON;
+    _regs[RFM69_REG_4E_TEMP1]           = RF_TEMP1_ADCLOWPOWER_ON;
+
+    _selected = false;
+    _addressed = false;
+    _writing = false;
+    _addr = 0;
+    _fifoHead = 0;
+    _fifoCount = 0;
+    _fifoOverrun = false;
+    _payloadReady = false;
+    _crcOk = false;
+    _packetSent = false;
+    _pllLockAt = 0;
+    _lastFrf = frf();
+    _txActive = false;
+    _txPos = 0;
+    _txLen = 0;
+    _txEncrypted = false;
+    _rxActive = false;
+    _rxSynced = false;
+    _rxPos = 0;
+    _rxLen = 0;
+    _rxCrcOk = true;
+    _rxRssi = 0xFF;
+    _rxOffset = 0;
+    _tempDoneAt = 0;
+    _listenOn = false;
+    _listenRx = false;
+    _listenWoken = false;
+    _listenNext = 0;
+    _listenPending = false;
+    _airCount = 0;
+    for (uint8_t i = 0; i < RFM69_SIM_NUM_DIO; i++) {
+        _dioLevel[i] = false;
+        _dioPending[i] = false;
+    }
+}
+
+void RFM69Sim::clearStats()
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// SPI
+
+void RFM69Sim::begin()
+{
+}
+
+void RFM69Sim::select()
+{
+    run(_now + _selectOverhead);
+    _selected = true;
+    _addressed = false;
+    _selectedAt = _now;
+    _stats.transactions++;
+}
+
+void RFM69Sim::transfer(const uint8_t* src, uint8_t* dest, uint8_t len)
+{
+    while (len--) {
+        uint8_t in = src ? *src++ : 0;
+        uint8_t out = 0;
+
+        // The byte takes effect once its 8th clock has been shifted
+        run(_now + _spiByteTime);
+        _stats.bytes++;
+
+        if (!_selected) {
+            // Chip select not asserted, the radio does not see the clocks
+        } else if (!_addressed) {
+            _addressed = true;
+            _writing = (in & RFM69_SPI_WRITE_MASK) != 0;
+            _addr = in & ~RFM69_SPI_WRITE_MASK;
+        } else {
+            if (_writing)
+                writeReg(_addr, in);
+            else
+                out = readReg(_addr);
+            // Burst accesses auto-increment the address, except on the FIFO
+            if (_addr != RFM69_REG_00_FIFO)
+                _addr = (_addr + 1) & 0x7F;
+        }
+        if (dest)
+            *dest++ = out;
+    }
+}
+
+void RFM69Sim::deselect()
+{
+    _stats.busNs += _now - _selectedAt;
+    _selected = false;
+    dispatch();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Time
+
+uint32_t RFM69Sim::micros()
+{
+    return (uint32_t)(_now / 1000);
+}
+
+uint32_t RFM69Sim::millis()
+{
+    return (uint32_t)(_now / 1000000);
+}
+
+void RFM69Sim::delayMicroseconds(uint32_t us)
+{
+    advance((uint64_t)us * 1000);
+}
+
+void RFM69Sim::advance(uint64_t ns)
+{
+    run(_now + ns);
+}
+
+uint64_t RFM69Sim::byteTime() const
+{
+    uint32_t br = ((uint32_t)_regs[RFM69_REG_03_BITRATE_MSB] << 8) | _regs[RFM69_REG_04_BITRATE_LSB];
+    if (br == 0)
+        br = 1;
+    // 8 bits at FXOSC / br bits per second
+    return 8000000000ULL * br / RFM69_FXOSC;
+}
+
+uint8_t RFM69Sim::crcLen() const
+{
+    return (_regs[RFM69_REG_37_PACKET_CONFIG1] & RF_PACKET1_CRC_ON) ? 2 : 0;
+}
+
+uint64_t RFM69Sim::headerTime() const
+{
+    uint16_t preamble = ((uint16_t)_regs[RFM69_REG_2C_PREAMBLE_MSB] << 8) | _regs[RFM69_REG_2D_PREAMBLE_LSB];
+    uint8_t sync = 0;
+    if (_regs[RFM69_REG_2E_SYNC_CONFIG] & RF_SYNC_ON)
+        sync = ((_regs[RFM69_REG_2E_SYNC_CONFIG] >> 3) & 0x07) + 1;
+    return (uint64_t)(preamble + sync) * byteTime();
+}
+
+uint64_t RFM69Sim::airtime(uint8_t len) const
+{
+    return headerTime() + (uint64_t)(1 + onAirLen(len) + crcLen()) * byteTime();
+}
+
+boolean RFM69Sim::aesOn() const
+{
+    return (_regs[RFM69_REG_3D_PACKET_CONFIG2] & RF_PACKET2_AES_ON)
+        && (_regs[RFM69_REG_37_PACKET_CONFIG1] & RF_PACKET1_FORMAT_VARIABLE);
+}
+
+// The address byte, if the packet handler filters on one, goes in the clear
+uint8_t RFM69Sim::aesClearLen() const
+{
+    return _regs[RFM69_REG_37_PACKET_CONFIG1] & (RF_PACKET1_ADRSFILTERING_NODE | RF_PACKET1_ADRSFILTERING_NODEBROADCAST)
+        ? 1 : 0;
+}
+
+// Bytes after the length byte on air for a message of len bytes
+uint16_t RFM69Sim::onAirLen(uint8_t len) const
+{
+    uint8_t clear = aesClearLen();
+    if (!aesOn() || len <= clear)
+        return len;
+    uint16_t n = clear + RFM69Aes::paddedLen(len - clear);
+    return n > 255 ? 255 : n;
+}
+
+// Takes the whole message of len bytes out of the FIFO and encrypts it into _txFrame
+boolean RFM69Sim::encryptTx(uint8_t len)
+{
+    if (_fifoCount < len)
+        return false;
+    uint8_t plain[255];
+    for (uint8_t i = 0; i < len; i++)
+        plain[i] = fifoPop();
+    uint8_t clear = len < aesClearLen() ? len : aesClearLen();
+    RFM69Aes aes(_regs + RFM69_REG_3E_AES_KEY1);
+    memcpy(_txFrame + 1, plain, clear);
+    aes.encrypt(plain + clear, len - clear, _txFrame + 1 + clear);
+    _txLen = 1 + onAirLen(len);
+    _txEncrypted = true;
+    return true;
+}
+
+// Replaces the encrypted packet in the FIFO with the message
+void RFM69Sim::decryptFifo()
+{
+    uint8_t frame[RFM69_SIM_FIFO_SIZE + 16];
+    uint8_t count = 0;
+    while (_fifoCount)
+        frame[count++] = fifoPop();
+    uint8_t len = frame[0];
+    uint8_t clear = len < aesClearLen() ? len : aesClearLen();
+    if (1 + onAirLen(len) <= count) {
+        RFM69Aes aes(_regs + RFM69_REG_3E_AES_KEY1);
+        aes.decrypt(frame + 1 + clear, len - clear, frame + 1 + clear);
+        count = 1 + len;
+    }
+    for (uint8_t i = 0; i < count; i++)
+        fifoPush(frame[i]);
+}
+
+// Processes every air event up to the given time, in order
+void RFM69Sim::run(uint64_t until)
+{
+    for (;;) {
+        const uint64_t never = ~0ULL;
+        uint64_t next = never;
+        uint8_t event = 0;
+
+        if (_airCount && _air[0].at < next) {
+            next = _air[0].at;
+            event = 1;
+        }
+        if (_txActive) {
+            uint64_t t;
+            if (_txLen == 0 || _txPos < _txLen)
+                t = _txStart + (uint64_t)_txPos * byteTime();
+            else
+                t = _txStart + (uint64_t)(_txLen + crcLen()) * byteTime();
+            if (t <= next) {
+                next = t;
+                event = 2;
+            }
+        }
+        if (_rxActive) {
+            uint64_t t;
+            if (!_rxSynced)
+                t = _rxStart;
+            else if (_rxPos < _rxLen)
+                t = _rxStart + (uint64_t)(_rxPos + 1) * byteTime();
+            else
+                t = _rxStart + (uint64_t)(_rxLen + crcLen()) * byteTime();
+            if (t <= next) {
+                next = t;
+                event = 3;
+            }
+        }
+
+        if (_listenOn && !_listenWoken && _listenNext <= next) {
+            next = _listenNext;
+            event = 4;
+        }
+
+        if (next == never || next > until)
+            break;
+        elapse(next);
+
+        if (event == 1) {
+            AirPacket pkt = _air[0];
+            _airCount--;
+            memmove(&_air[0], &_air[1], _airCount * sizeof(AirPacket));
+            if (onChannel(pkt)) {
+                // On the channel whether or not the receiver catches it
+                _carrierUntil = pkt.at + airtime(pkt.len);
+                _carrierRssi = rssiReg(pkt.rssi);
+            }
+            if (_listenOn && !_listenWoken) {
+                // Held until a receive window opens, it may still be in its preamble then
+                if (_listenPending)
+                    _stats.rxMissed++;
+                _listenPacket = pkt;
+                _listenPending = true;
+                if (_listenRx)
+                    listenCatch();
+            } else {
+                startRx(pkt);
+            }
+        } else if (event == 2) {
+            if (_txLen == 0 || _txPos < _txLen) {
+                if (_txEncrypted) {
+                    _txPos++;
+                } else if (_fifoCount == 0) {
+                    // FIFO ran dry in the middle of the packet
+                    _txActive = false;
+                    _stats.txUnderruns++;
+                } else {
+                    uint8_t b = fifoPop();
+                    if (_txPos == 0) {
+                        if (_regs[RFM69_REG_37_PACKET_CONFIG1] & RF_PACKET1_FORMAT_VARIABLE)
+                            _txLen = (uint16_t)b + 1;
+                        else
+                            _txLen = _regs[RFM69_REG_38_PAYLOAD_LENGTH];
+                        if (aesOn() && !encryptTx(b)) {
+                            // AES needs the whole message in the FIFO before it starts
+                            _txActive = false;
+                            _stats.txUnderruns++;
+                        }
+                    }
+                    _txFrame[_txPos++] = b;
+                }
+            } else {
+                _txActive = false;
+                _packetSent = true;
+                _stats.txPackets++;
+                if (_txHandler) {
+                    if (_regs[RFM69_REG_37_PACKET_CONFIG1] & RF_PACKET1_FORMAT_VARIABLE)
+                        _txHandler(_txHandlerCtx, _txFrame + 1, _txFrame[0]);
+                    else
+                        _txHandler(_txHandlerCtx, _txFrame, (uint8_t)_txLen);
+                }
+                checkTxStart();
+            }
+        } else if (event == 3) {
+            if (!_rxSynced) {
+                _rxSynced = true;
+            } else if (_rxPos < _rxLen) {
+                if (_fifoCount == RFM69_SIM_FIFO_SIZE) {
+                    _fifoOverrun = true;
+                    _rxActive = false;
+                    _stats.rxOverruns++;
+                } else {
+                    fifoPush(_rxFrame[_rxPos++]);
+                }
+            } else {
+                _rxActive = false;
+                _rxSynced = false;
+                _heldRssi = _rxRssi; // Last measured on the packet itself
+                uint8_t payloadLen = _rxFrame[0];
+                if ((_regs[RFM69_REG_37_PACKET_CONFIG1] & RF_PACKET1_FORMAT_VARIABLE)
+                    && payloadLen > _regs[RFM69_REG_38_PAYLOAD_LENGTH]) {
+                    // Too long for the configured PayloadLength, the packet handler drops it
+                    fifoClear();
+                    _stats.rxDiscarded++;
+                } else if (!_rxCrcOk && !(_regs[RFM69_REG_37_PACKET_CONFIG1] & RF_PACKET1_CRCAUTOCLEAR_OFF)) {
+                    fifoClear();
+                    _stats.rxDiscarded++;
+                } else {
+                    if (aesOn())
+                        decryptFifo();
+                    _payloadReady = true;
+                    _crcOk = _rxCrcOk;
+                    _stats.rxPackets++;
+                    if (_listenOn && (_regs[RFM69_REG_0D_LISTEN1] & 0x06) == RF_LISTEN1_END_01) {
+                        // Back to the duty cycle, the FIFO survives until the next window
+                        _listenWoken = false;
+                        _listenRx = false;
+                        _listenNext = _now + listenTime(6, RFM69_REG_0E_LISTEN2);
+                    }
+                }
+            }
+        } else if (event == 4) {
+            if (_listenRx) {
+                // Nothing woke the window
+                _listenRx = false;
+                _listenNext = _now + listenTime(6, RFM69_REG_0E_LISTEN2);
+            } else {
+                _listenRx = true;
+                _listenNext = _now + listenTime(4, RFM69_REG_0F_LISTEN3);
+                fifoClear();
+                listenCatch();
+            }
+        }
+        dispatch();
+    }
+    elapse(until);
+    dispatch();
+}
+
+// Moves time on to until, charging the interval to the current power state
+void RFM69Sim::elapse(uint64_t until)
+{
+    if (until <= _now)
+        return;
+    uint64_t ns = until - _now;
+    if (_listenOn)
+        *(_listenRx || _listenWoken ? &_stats.rxNs : &_stats.idleNs) += ns;
+    else if (mode() == RFM69_MODE_SLEEP)
+        _stats.sleepNs += ns;
+    else if (mode() == RFM69_MODE_RX)
+        _stats.rxNs += ns;
+    else if (mode() == RFM69_MODE_TX)
+        _stats.txNs += ns;
+    else
+        _stats.stdbyNs += ns;
+    _now = until;
+}
+
+boolean RFM69Sim::receiving() const
+{
+    return mode() == RFM69_MODE_RX || (_listenOn && _listenWoken);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Listen mode
+
+// Idle or receive period from the resolution field at resolShift in RegListen1 and a coefficient
+uint64_t RFM69Sim::listenTime(uint8_t resolShift, uint8_t coefReg) const
+{
+    static const uint64_t resolNs[4] = { 0, 64000, 4100000, 262000000 };
+    uint64_t t = resolNs[(_regs[RFM69_REG_0D_LISTEN1] >> resolShift) & 0x03] * _regs[coefReg];
+    return t ? t : 64000;
+}
+
+void RFM69Sim::listenStart()
+{
+    _listenOn = true;
+    _listenRx = false;
+    _listenWoken = false;
+    _listenNext = _now + listenTime(6, RFM69_REG_0E_LISTEN2);
+}
+
+void RFM69Sim::listenStop()
+{
+    if (_listenPending)
+        _stats.rxMissed++;
+    _listenPending = false;
+    _listenOn = false;
+    _listenRx = false;
+    _listenWoken = false;
+    if (mode() != RFM69_MODE_RX) {
+        _rxActive = false;
+        _rxSynced = false;
+    }
+}
+
+// Decides whether the receive window that is open now wakes on the packet last heard on air
+void RFM69Sim::listenCatch()
+{
+    if (!_listenPending)
+        return;
+    const AirPacket& pkt = _listenPacket;
+    uint16_t preamble = ((uint16_t)_regs[RFM69_REG_2C_PREAMBLE_MSB] << 8) | _regs[RFM69_REG_2D_PREAMBLE_LSB];
+    uint64_t preambleEnd = pkt.at + preamble * byteTime();
+    boolean onAir = _now < pkt.at + airtime(pkt.len);
+    boolean heard = pkt.rssi * 2 >= -(int)_regs[RFM69_REG_29_RSSI_THRESHOLD]
+        && onChannel(pkt);
+    if (onAir && !heard)
+        return; // Too weak to wake on, but it may yet be followed by something that is
+
+    _listenPending = false;
+    if (!onAir) {
+        _stats.rxMissed++;
+        return;
+    }
+    boolean inPreamble = _now <= preambleEnd;
+    boolean rssiOnly = !(_regs[RFM69_REG_0D_LISTEN1] & RF_LISTEN1_CRITERIA_RSSIANDSYNC);
+    if (rssiOnly || (inPreamble && pkt.at + headerTime() <= _listenNext)) {
+        _listenWoken = true;
+        _stats.listenWakes++;
+    }
+    if (_listenWoken && inPreamble)
+        startRx(pkt);
+    else
+        _stats.rxMissed++;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Air
+
+uint32_t RFM69Sim::frf() const
+{
+    return ((uint32_t)_regs[RFM69_REG_07_FRF_MSB] << 16) | ((uint32_t)_regs[RFM69_REG_08_FRF_MID] << 8)
+        | _regs[RFM69_REG_09_FRF_LSB];
+}
+
+boolean RFM69Sim::air(const uint8_t* data, uint8_t len, int rssi, uint64_t at, uint32_t frf, boolean crcOk)
+{
+    if (_airCount == RFM69_SIM_AIR_QUEUE)
+        return false;
+    if (at < _now)
+        at = _now;
+
+    // Keep the queue in time order
+    uint8_t i = _airCount;
+    while (i > 0 && _air[i - 1].at > at) {
+        _air[i] = _air[i - 1];
+        i--;
+    }
+    memcpy(_air[i].data, data, onAirLen(len));
+    _air[i].len = len;
+    _air[i].rssi = rssi;
+    _air[i].at = at;
+    _air[i].frf = frf;
+    _air[i].crcOk = crcOk;
+    _airCount++;
+    return true;
+}
+
+void RFM69Sim::startRx(const AirPacket& pkt)
+{
+    // The receiver only hears a packet if it is listening and not still holding
+    // the previous one in the FIFO
+    int16_t offset;
+    if (!receiving() || _rxActive || _payloadReady || _now < _pllLockAt || !onChannel(pkt, &offset)) {
+        _stats.rxMissed++;
+        return;
+    }
+
+    // Address filtering: the packet handler goes back to waiting for a preamble
+    // without raising SyncAddressMatch or touching the FIFO
+    uint8_t filtering = _regs[RFM69_REG_37_PACKET_CONFIG1]
+        & (RF_PACKET1_ADRSFILTERING_NODE | RF_PACKET1_ADRSFILTERING_NODEBROADCAST);
+    if (filtering && (pkt.len == 0
+                      || (pkt.data[0] != _regs[RFM69_REG_39_NODE_ADRS]
+                          && (filtering != RF_PACKET1_ADRSFILTERING_NODEBROADCAST
+                              || pkt.data[0] != _regs[RFM69_REG_3A_BROADCAST_ADRS])))) {
+        _stats.rxFiltered++;
+        _listenWoken = false;   // Back to duty cycling
+        return;
+    }
+
+    _rxRssi = rssiReg(pkt.rssi);
+    _rxOffset = offset;
+    if (_regs[RFM69_REG_1E_AFC_FEI] & RF_AFCFEI_AFCAUTO_ON) {
+        // The AFC measures the offset during the preamble and corrects for it
+        _regs[RFM69_REG_1F_AFC_MSB] = (uint8_t)((uint16_t)offset >> 8);
+        _regs[RFM69_REG_20_AFC_LSB] = (uint8_t)offset;
+        _regs[RFM69_REG_1E_AFC_FEI] |= RF_AFCFEI_AFC_DONE;
+    }
+
+    if (_regs[RFM69_REG_37_PACKET_CONFIG1] & RF_PACKET1_FORMAT_VARIABLE) {
+        _rxFrame[0] = pkt.len;
+        _rxLen = 1 + onAirLen(pkt.len);
+        memcpy(_rxFrame + 1, pkt.data, _rxLen - 1);
+    } else {
+        _rxLen = _regs[RFM69_REG_38_PAYLOAD_LENGTH];
+        memset(_rxFrame, 0, sizeof(_rxFrame));
+        memcpy(_rxFrame, pkt.data, pkt.len < _rxLen ? pkt.len : _rxLen);
+    }
+    _rxActive = true;
+    _rxSynced = false;
+    _rxCrcOk = pkt.crcOk;
+    _rxPos = 0;
+    _rxStart = pkt.at + headerTime();
+}
+
+// A packet off the tuned carrier is heard while its deviation and half its bitrate either
+// side still fit in the receiver bandwidth, or with AfcAutoOn in the AFC bandwidth, as the
+// AFC then centres the receiver on it
+boolean RFM69Sim::onChannel(const AirPacket& pkt, int16_t* offset) const
+{
+    if (offset)
+        *offset = 0;
+    if (!pkt.frf || pkt.frf == frf())
+        return true;
+    int32_t steps = (int32_t)(pkt.frf - frf());
+    uint32_t distance = (uint32_t)(((uint64_t)(steps < 0 ? -steps : steps) * RFM69_FXOSC) >> 19);
+    uint8_t bwReg = _regs[_regs[RFM69_REG_1E_AFC_FEI] & RF_AFCFEI_AFCAUTO_ON ? RFM69_REG_1A_AFC_BW : RFM69_REG_19_RX_BW];
+    uint32_t bw = RFM69_FXOSC / ((uint32_t)(16 + ((bwReg >> 3) & 0x03) * 4) << ((bwReg & 0x07) + 2));
+    uint32_t br = ((uint32_t)_regs[RFM69_REG_03_BITRATE_MSB] << 8) | _regs[RFM69_REG_04_BITRATE_LSB];
+    uint32_t fdev = ((uint32_t)_regs[RFM69_REG_05_FDEV_MSB] << 8) | _regs[RFM69_REG_06_FDEV_LSB];
+    uint32_t spread = (uint32_t)(((uint64_t)fdev * RFM69_FXOSC) >> 19) + (br ? RFM69_FXOSC / br / 2 : 0);
+    if (distance + spread > bw)
+        return false;
+    if (offset)
+        *offset = (int16_t)(steps < -32768 ? -32768 : steps > 32767 ? 32767 : steps);
+    return true;
+}
+
+void RFM69Sim::onTransmit(void (*handler)(void* ctx, const uint8_t* data, uint8_t len), void* ctx)
+{
+    _txHandler = handler;
+    _txHandlerCtx = ctx;
+}
+
+void RFM69Sim::checkTxStart()
+{
+    if (mode() != RFM69_MODE_TX || _txActive || _fifoCount == 0)
+        return;
+    uint8_t thresh = _regs[RFM69_REG_3C_FIFO_THRESHOLD];
+    if (!(thresh & RF_FIFOTHRESH_TXSTART_FIFONOTEMPTY) && _fifoCount <= (thresh & 0x7F))
+        return;
+    _txActive = true;
+    _packetSent = false;
+    _txPos = 0;
+    _txLen = 0;
+    _txEncrypted = false;
+    _txStart = _now + headerTime();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// DIO
+
+boolean RFM69Sim::dio(uint8_t dio)
+{
+    uint8_t map1 = _regs[RFM69_REG_25_DIO_MAPPING1];
+    uint8_t m = mode();
+
+    if (dio == 0) {
+        uint8_t map = map1 >> 6;
+        if (m == RFM69_MODE_RX || _listenOn) {
+            switch (map) {
+            case 0: return _crcOk;
+            case 1: return _payloadReady;
+            case 2: return _rxSynced;
+            default: return false;
+            }
+        } else if (m == RFM69_MODE_TX) {
+            return map == 0 ? _packetSent : map == 1;
+        }
+        return false;
+    } else if (dio == 1) {
+        uint8_t map = (map1 >> 4) & 0x03;
+        if (m == RFM69_MODE_SLEEP)
+            return false;
+        switch (map) {
+        case 0: return _fifoCount > (_regs[RFM69_REG_3C_FIFO_THRESHOLD] & 0x7F);
+        case 1: return _fifoCount == RFM69_SIM_FIFO_SIZE;
+        case 2: return _fifoCount != 0;
+        default: return false;
+        }
+    }
+    return false;
+}
+
+void RFM69Sim::attachInterrupt(uint8_t dio, void (*handler)(void* ctx), void* ctx, uint8_t edge)
+{
+    if (dio >= RFM69_SIM_NUM_DIO)
+        return;
+    _dioHandler[dio] = handler;
+    _dioHandlerCtx[dio] = ctx;
+    _dioEdge[dio] = edge;
+    _dioLevel[dio] = this->dio(dio);
+    _dioPending[dio] = false;
+}
+
+// Latches rising edges and runs handlers whose interrupt can be taken now
+void RFM69Sim::dispatch()
+{
+    for (uint8_t i = 0; i < RFM69_SIM_NUM_DIO; i++) {
+        boolean level = dio(i);
+        if (level != _dioLevel[i] && _dioHandler[i]) {
+            if (_dioEdge[i] == RFM69_SIM_CHANGE
+                || (_dioEdge[i] == RFM69_SIM_RISING && level)
+                || (_dioEdge[i] == RFM69_SIM_FALLING && !level))
+                _dioPending[i] = true;
+        }
+        _dioLevel[i] = level;
+    }
+    if (_inHandler || _selected || !rfm69HostInterruptsEnabled())
+        return;
+    for (uint8_t i = 0; i < RFM69_SIM_NUM_DIO; i++) {
+        if (_dioPending[i]) {
+            _dioPending[i] = false;
+            _inHandler = true;
+            _dioHandler[i](_dioHandlerCtx[i]);
+            _inHandler = false;
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Registers
+
+uint8_t RFM69Sim::peek(uint8_t reg)
+{
+    reg &= 0x7F;
+    if (reg == RFM69_REG_27_IRQ_FLAGS1)
+        return irqFlags1();
+    if (reg == RFM69_REG_28_IRQ_FLAGS2)
+        return irqFlags2();
+    if (reg == RFM69_REG_00_FIFO)
+        return _fifoCount ? _fifo[_fifoHead] : 0;
+    if (reg == RFM69_REG_24_RSSI_VALUE)
+        return rssiValue();
+    if (reg == RFM69_REG_4E_TEMP1)
+        return _regs[reg] | (_now < _tempDoneAt ? RF_TEMP1_MEAS_RUNNING : 0);
+    if (reg == RFM69_REG_0C_LOWBAT) {
+        static const uint16_t thresholds[8] = { 1695, 1764, 1835, 1905, 1976, 2045, 2116, 2185 };
+        boolean low = (_regs[reg] & RF_LOWBAT_ON) && _supplyMv < thresholds[_regs[reg] & 0x07];
+        return _regs[reg] | (low ? RF_LOWBAT_MONITOR : 0);
+    }
+    return _regs[reg];
+}
+
+uint8_t RFM69Sim::rssiValue()
+{
+    if (_rxActive)
+        return _heldRssi = _rxRssi;
+    if (!receiving())
+        return _heldRssi;
+    if (_now < _carrierUntil)
+        return _heldRssi = _carrierRssi;
+    if (!_noiseJitter)
+        return _heldRssi = _noise;
+    _noiseSeed ^= _noiseSeed << 13; // xorshift32
+    _noiseSeed ^= _noiseSeed >> 17;
+    _noiseSeed ^= _noiseSeed << 5;
+    int value = (int)_noise + (int)(_noiseSeed % (4U * _noiseJitter + 1)) - 2 * _noiseJitter;
+    return _heldRssi = value < 0 ? 0 : value > 0xFF ? 0xFF : (uint8_t)value;
+}
+
+void RFM69Sim::setNoise(int dbm, uint8_t jitter)
+{
+    _noise = rssiReg(dbm);
+    _noiseJitter = jitter;
+}
+
+uint8_t RFM69Sim::rssiReg(int dbm)
+{
+    if (dbm > 0)
+        dbm = 0;
+    if (dbm < -127)
+        dbm = -127;
+    return (uint8_t)(-dbm * 2);
+}
+
+uint8_t RFM69Sim::irqFlags1()
+{
+    uint8_t m = mode();
+    uint8_t flags = RF_IRQFLAGS1_MODEREADY;
+    if (m == RFM69_MODE_RX)
+        flags |= RF_IRQFLAGS1_RXREADY;
+    if (m == RFM69_MODE_TX)
+        flags |= RF_IRQFLAGS1_TXREADY;
+    if ((m == RFM69_MODE_RX || m == RFM69_MODE_TX) && _now >= _pllLockAt)
+        flags |= RF_IRQFLAGS1_PLLLOCK;
+    if (_rxSynced || _payloadReady)
+        flags |= RF_IRQFLAGS1_SYNCADDRESSMATCH;
+    return flags;
+}
+
+uint8_t RFM69Sim::irqFlags2()
+{
+    uint8_t flags = 0;
+    if (_fifoCount == RFM69_SIM_FIFO_SIZE)
+        flags |= RF_IRQFLAGS2_FIFOFULL;
+    if (_fifoCount)
+        flags |= RF_IRQFLAGS2_FIFONOTEMPTY;
+    if (_fifoCount > (_regs[RFM69_REG_3C_FIFO_THRESHOLD] & 0x7F))
+        flags |= RF_IRQFLAGS2_FIFOLEVEL;
+    if (_fifoOverrun)
+        flags |= RF_IRQFLAGS2_FIFOOVERRUN;
+    if (_packetSent)
+        flags |= RF_IRQFLAGS2_PACKETSENT;
+    if (_payloadReady)
+        flags |= RF_IRQFLAGS2_PAYLOADREADY;
+    if (_crcOk)
+        flags |= RF_IRQFLAGS2_CRCOK;
+    return flags;
+}
+
+uint8_t RFM69Sim::readReg(uint8_t reg)
+{
+    if (reg == RFM69_REG_00_FIFO)
+        return fifoPop();
+    return peek(reg);
+}
+
+void RFM69Sim::writeReg(uint8_t reg, uint8_t val)
+{
+    switch (reg) {
+    case RFM69_REG_00_FIFO:
+        if (_fifoCount == RFM69_SIM_FIFO_SIZE)
+            _fifoOverrun = true;
+        else
+            fifoPush(val);
+        checkTxStart();
+        break;
+
+    case RFM69_REG_01_OPMODE: {
+        uint8_t oldMode = mode();
+        _regs[reg] = val & ~RF_OPMODE_LISTENABORT;
+        if ((val & 0x1C) != oldMode)
+            setMode(val & 0x1C);
+        if ((val & RF_OPMODE_LISTEN_ON) && !_listenOn)
+            listenStart();
+        else if (!(val & RF_OPMODE_LISTEN_ON) && _listenOn)
+            listenStop();
+        break;
+    }
+
+    case RFM69_REG_10_VERSION:
+    case RFM69_REG_24_RSSI_VALUE:
+    case RFM69_REG_27_IRQ_FLAGS1:
+        break; // Read only
+
+    case RFM69_REG_0C_LOWBAT:
+        _regs[reg] = val & (RF_LOWBAT_ON | 0x07);
+        break;
+
+    case RFM69_REG_4E_TEMP1:
+        _regs[reg] = val & RF_TEMP1_ADCLOWPOWER_ON;
+        if ((val & RF_TEMP1_MEAS_START) && _now >= _tempDoneAt
+            && (mode() == RFM69_MODE_STDBY || mode() == RF_OPMODE_SYNTHESIZER)) {
+            int value = RFM69_TEMP_OFFSET - _temperature;
+            _regs[RFM69_REG_4F_TEMP2] = (uint8_t)(value < 0 ? 0 : value > 255 ? 255 : value);
+            _tempDoneAt = _now + 100000;
+        }
+        break;
+
+    case RFM69_REG_4F_TEMP2:
+        break; // Read only
+
+    case RFM69_REG_1E_AFC_FEI:
+        _regs[reg] = (_regs[reg] & (RF_AFCFEI_FEI_DONE | RF_AFCFEI_AFC_DONE))
+            | (val & (RF_AFCFEI_AFCAUTO_ON | RF_AFCFEI_AFCAUTOCLEAR_ON));
+        if (val & RF_AFCFEI_AFC_CLEAR) {
+            _regs[RFM69_REG_1F_AFC_MSB] = 0;
+            _regs[RFM69_REG_20_AFC_LSB] = 0;
+        }
+        if (val & RF_AFCFEI_FEI_START) {
+            // Measured on whatever is being received, nothing to measure otherwise
+            int16_t fei = _rxActive ? _rxOffset : 0;
+            _regs[RFM69_REG_21_FEI_MSB] = (uint8_t)((uint16_t)fei >> 8);
+            _regs[RFM69_REG_22_FEI_LSB] = (uint8_t)fei;
+            _regs[reg] |= RF_AFCFEI_FEI_DONE;
+        }
+        break;
+
+    case RFM69_REG_1F_AFC_MSB:
+    case RFM69_REG_20_AFC_LSB:
+    case RFM69_REG_21_FEI_MSB:
+    case RFM69_REG_22_FEI_LSB:
+        break; // Read only
+
+    case RFM69_REG_28_IRQ_FLAGS2:
+        // Writing FifoOverrun clears the flag and the FIFO
+        if (val & RF_IRQFLAGS2_FIFOOVERRUN) {
+            _fifoOverrun = false;
+            fifoClear();
+        }
+        break;
+
+    case RFM69_REG_09_FRF_LSB: {
+        // The synthesiser retunes when the LSB is written
+        _regs[reg] = val;
+        uint32_t now = frf();
+        uint32_t step = now > _lastFrf ? now - _lastFrf : _lastFrf - now;
+        uint32_t stepHz = (uint32_t)(((uint64_t)step * RFM69_FXOSC) >> 19);
+        if (step && mode() != RFM69_MODE_SLEEP && mode() != RFM69_MODE_STDBY) {
+            // Only a running synthesiser has to settle
+            _pllLockAt = _now + (stepHz <= 1000000 ? RFM69_SIM_HOP_SMALL_NS
+                                 : stepHz <= 5000000 ? RFM69_SIM_HOP_MEDIUM_NS : RFM69_SIM_HOP_LARGE_NS);
+            _rxActive = false; // Whatever was being received is lost
+            _rxSynced = false;
+        }
+        _lastFrf = now;
+        break;
+    }
+
+    default:
+        _regs[reg] = val;
+        break;
+    }
+}
+
+void RFM69Sim::setMode(uint8_t newMode)
+{
+    if (newMode != RFM69_MODE_TX) {
+        _txActive = false;
+        _packetSent = false;
+    }
+    if (newMode != RFM69_MODE_RX) {
+        _rxActive = false;
+        _rxSynced = false;
+    }
+    if (newMode == RFM69_MODE_RX) {
+        // The receiver starts from an empty FIFO
+        fifoClear();
+    }
+    checkTxStart();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// FIFO
+
+void RFM69Sim::fifoPush(uint8_t val)
+{
+    _fifo[(_fifoHead + _fifoCount) % RFM69_SIM_FIFO_SIZE] = val;
+    _fifoCount++;
+}
+
+uint8_t RFM69Sim::fifoPop()
+{
+    if (_fifoCount == 0)
+        return 0;
+    uint8_t val = _fifo[_fifoHead];
+    _fifoHead = (_fifoHead + 1) % RFM69_SIM_FIFO_SIZE;
+    _fifoCount--;
+    if (_fifoCount == 0 && _payloadReady) {
+        // PayloadReady and CrcOk drop once the packet has been read out
+        _payloadReady = false;
+        _crcOk = false;
+    }
+    return val;
+}
+
+void RFM69Sim::fifoClear()
+{
+    _fifoHead = 0;
+    _fifoCount = 0;
+    _payloadReady = false;
+    _crcOk = false;
+}
+
+#endif
@@ -0,0 +1,285 @@
+// RFM69Sim.h
+//
+// Copyright (C) 2026 the UKHASnet_rfm69 contributors
+//
+// Host-side model of an RFM69 sitting on the end of an SPI bus. It keeps the
+// register map, the 66 byte FIFO, the IRQ flags and the DIO mapping, and
+// moves packets on and off the air a byte at a time at the configured bitrate.
+// RegRssiValue reads a packet's level from its preamble to its last byte, whether
+// or not the receiver caught it, and the background noise set by setNoise() at
+// any other time.
+// With address filtering on, a packet whose first byte matches neither RegNodeAdrs
+// nor (for node or broadcast filtering) RegBroadcastAdrs is dropped as soon as it
+// is heard, leaving the receiver free and Listen mode duty cycling.
+// A packet sent off the tuned carrier is heard while its deviation plus half its bitrate
+// either side fits in RegRxBw, or in RegAfcBw with AfcAutoOn, and the AFC then leaves
+// the offset in RegAfcValue. FeiStart measures the packet being received.
+// TempMeasStart in STDBY or FS reads setTemperature() into RegTemp2, as
+// RFM69_TEMP_OFFSET less it, after 100us. RegLowBat compares setSupply() with
+// its threshold whenever LowBatOn is set.
+// Listen mode duty cycles on the RegListen timing; ListenEnd 00 and 10 are both
+// treated as staying in RX until the driver aborts.
+// With AesOn, variable length packets are encrypted with RFM69Aes on the way out,
+// once the whole message is in the FIFO, and decrypted before PayloadReady, so
+// packets on air (air(), onTransmit()) carry the ciphertext.
+// Every SPI byte costs 8 SPI clocks of simulated time, so driver paths can be
+// timed on a build box: see extras/host/rfm69_bench.cpp
+
+#ifndef RFM69Sim_h
+#define RFM69Sim_h
+
+#if !defined(ARDUINO)
+
+#include "UKHASnet_rfm69.h"
+
+// FIFO depth of the SX1231, 64 bytes of payload plus the length and address bytes
+#define RFM69_SIM_FIFO_SIZE 66
+
+// Number of packets that can be waiting to go on air towards the simulated radio
+#define RFM69_SIM_AIR_QUEUE 8
+
+// Number of DIO lines that can raise simulated interrupts
+#define RFM69_SIM_NUM_DIO   2
+
+// Edges for attachInterrupt(), as the Arduino RISING, FALLING and CHANGE
+#define RFM69_SIM_RISING    0
+#define RFM69_SIM_FALLING   1
+#define RFM69_SIM_CHANGE    2
+
+/// Counters kept by the simulator
+struct RFM69SimStats
+{
+    uint32_t    transactions;   ///< Chip select assertions
+    uint32_t    bytes;          ///< Bytes clocked, including address bytes
+    uint64_t    busNs;          ///< Time spent with chip select asserted
+    uint32_t    txPackets;      ///< Packets that left the antenna
+    uint32_t    txUnderruns;    ///< Packets aborted because the FIFO ran dry mid-packet
+    uint32_t    rxPackets;      ///< Packets that reached PAYLOADREADY
+    uint32_t    rxMissed;       ///< Packets on air while the receiver was not listening
+    uint32_t    rxOverruns;     ///< Packets lost to a FIFO overrun
+    uint32_t    rxDiscarded;    ///< Packets dropped by the packet handler (length, CRC with auto clear)
+    uint32_t    rxFiltered;     ///< Packets dropped by address filtering before reaching the FIFO
+    uint32_t    listenWakes;    ///< Listen mode receive windows that met the wake criteria
+    uint64_t    sleepNs;        ///< Time spent in each power state
+    uint64_t    idleNs;         ///< Listen mode between receive windows
+    uint64_t    stdbyNs;        ///< STDBY and FS
+    uint64_t    rxNs;           ///< RX, including Listen mode receive windows
+    uint64_t    txNs;
+};
+
+class RFM69Sim : public RFM69Transport, public RFM69HostClock
+{
+public:
+    /// \param[in] spiClockHz SPI clock used to cost each byte on the bus
+    RFM69Sim(uint32_t spiClockHz = 8000000);
+
+    /// Power on reset. Registers return to their POR values and the FIFO is emptied.
+    /// Simulated time and the statistics are not touched.
+    void        reset();
+
+    // RFM69Transport
+    void        begin();
+    void        select();
+    void        transfer(const uint8_t* src, uint8_t* dest, uint8_t len);
+    void        deselect();
+
+    // RFM69HostClock
+    uint32_t    micros();
+    uint32_t    millis();
+    void        delayMicroseconds(uint32_t us);
+
+    /// \return Simulated time in nanoseconds
+    uint64_t    now() const { return _now; }
+
+    /// Lets simulated time pass, moving bytes on and off the air and raising DIO interrupts
+    void        advance(uint64_t ns);
+
+    /// Queues a packet to be transmitted towards this radio by some other node
+    /// \param[in] data Payload (without the length byte). With AES on, as on air: any address
+    /// byte, then the rest of the message encrypted, RFM69Aes::paddedLen() bytes of it.
+    /// \param[in] len Payload length, the value of the length byte
+    /// \param[in] rssi Signal strength the packet arrives with, in dBm
+    /// \param[in] at Simulated time the preamble starts. 0 means now.
+    /// \param[in] frf Carrier as a RegFrf value. The radio only hears the packet if its PLL is
+    /// locked and it is tuned close enough, see the top of this file. 0 means whatever the
+    /// radio is tuned to.
+    /// \param[in] crcOk false to have the packet arrive with a bad CRC
+    /// \return false if the air queue is full
+    boolean     air(const uint8_t* data, uint8_t len, int rssi = -60, uint64_t at = 0, uint32_t frf = 0,
+                    boolean crcOk = true);
+
+    /// Sets the background level RegRssiValue reads when no packet is on air
+    /// \param[in] dbm Mean noise level in dBm
+    /// \param[in] jitter Each read is spread uniformly over +/- this many dB
+    void        setNoise(int dbm, uint8_t jitter = 0);
+
+    /// Sets the die temperature the next TempMeasStart reads
+    void        setTemperature(int celsius) { _temperature = celsius; }
+
+    /// Sets the supply voltage RegLowBat compares with its threshold
+    void        setSupply(uint16_t mv) { _supplyMv = mv; }
+
+    /// \return The carrier the radio is tuned to, as a RegFrf value
+    uint32_t    frf() const;
+
+    /// \return Nanoseconds a variable length packet of len payload bytes occupies the channel
+    /// with the current bitrate, preamble, sync and CRC settings
+    uint64_t    airtime(uint8_t len) const;
+
+    /// \return Nanoseconds per byte on air at the current bitrate
+    uint64_t    byteTime() const;
+
+    /// Called with the payload of every packet the radio finishes transmitting. With AES on
+    /// that is as on air, len being the length byte, see air().
+    void        onTransmit(void (*handler)(void* ctx, const uint8_t* data, uint8_t len), void* ctx);
+
+    /// Registers an edge handler for a DIO line, the simulated equivalent of attachInterrupt().
+    /// Handlers are held off while interrupts are masked or a transaction is in progress.
+    /// \param[in] edge One of RFM69_SIM_RISING, RFM69_SIM_FALLING or RFM69_SIM_CHANGE
+    void        attachInterrupt(uint8_t dio, void (*handler)(void* ctx), void* ctx,
+                                uint8_t edge = RFM69_SIM_RISING);
+
+    /// \return The current level of DIO line dio
+    boolean     dio(uint8_t dio);
+
+    /// Reads a register without touching the bus or simulated time
+    uint8_t     peek(uint8_t reg);
+
+    /// \return The mode bits of RegOpMode, one of RFM69_MODE_*
+    uint8_t     mode() const { return _regs[RFM69_REG_01_OPMODE] & 0x1C; }
+
+    /// \return true while Listen mode is running
+    boolean     listening() const { return _listenOn; }
+
+    /// \return Number of bytes currently in the FIFO
+    uint8_t     fifoCount() const { return _fifoCount; }
+
+    const RFM69SimStats& stats() const { return _stats; }
+    void        clearStats();
+
+    /// Sets the extra time charged for each chip select assertion (GPIO toggles, call overhead)
+    void        setSelectOverhead(uint32_t ns) { _selectOverhead = ns; }
+
+private:
+    struct AirPacket
+    {
+        uint8_t     data[255];
+        uint8_t     len;
+        int         rssi;
+        uint64_t    at;
+        uint32_t    frf;
+        boolean     crcOk;
+    };
+
+    void        run(uint64_t until);
+    void        elapse(uint64_t until);
+    boolean     receiving() const;
+    boolean     onChannel(const AirPacket& pkt, int16_t* offset = NULL) const;
+    uint64_t    listenTime(uint8_t resolShift, uint8_t coefReg) const;
+    void        listenStart();
+    void        listenStop();
+    void        listenCatch();
+    void        dispatch();
+    uint8_t     readReg(uint8_t reg);
+    void        writeReg(uint8_t reg, uint8_t val);
+    void        setMode(uint8_t newMode);
+    void        checkTxStart();
+    void        startRx(const AirPacket& pkt);
+    void        fifoPush(uint8_t val);
+    uint8_t     fifoPop();
+    void        fifoClear();
+    uint8_t     irqFlags1();
+    uint8_t     irqFlags2();
+    uint64_t    headerTime() const;
+    uint8_t     crcLen() const;
+    boolean     aesOn() const;
+    uint8_t     aesClearLen() const;
+    uint16_t    onAirLen(uint8_t len) const;
+    boolean     encryptTx(uint8_t len);
+    void        decryptFifo();
+    uint8_t     rssiValue();
+    static uint8_t rssiReg(int dbm);
+
+    uint8_t     _regs[0x80];
+    uint64_t    _now;
+    uint64_t    _spiByteTime;
+    uint32_t    _selectOverhead;
+
+    // SPI transaction state
+    boolean     _selected;
+    boolean     _addressed;
+    boolean     _writing;
+    uint8_t     _addr;
+    uint64_t    _selectedAt;
+
+    uint8_t     _fifo[RFM69_SIM_FIFO_SIZE];
+    uint8_t     _fifoHead;
+    uint8_t     _fifoCount;
+
+    boolean     _fifoOverrun;
+    boolean     _payloadReady;
+    boolean     _crcOk;
+    boolean     _packetSent;
+
+    uint64_t    _pllLockAt;     // time the synthesiser settles after a retune
+    uint32_t    _lastFrf;       // carrier before the last write to RegFrfLsb
+
+    // Transmitter
+    boolean     _txActive;
+    uint64_t    _txStart;       // time the first payload byte starts on air
+    uint16_t    _txPos;
+    uint16_t    _txLen;
+    boolean     _txEncrypted;   // _txFrame was built from the FIFO in one go
+    uint8_t     _txFrame[256];
+
+    // Receiver
+    boolean     _rxActive;
+    boolean     _rxSynced;
+    uint64_t    _rxStart;       // time the sync word has been received
+    uint16_t    _rxPos;
+    uint16_t    _rxLen;
+    boolean     _rxCrcOk;
+    uint8_t     _rxRssi;        // RegRssiValue while the packet is on air
+    int16_t     _rxOffset;      // Carrier of the packet less the receiver's, in FSTEPs
+    uint8_t     _rxFrame[256];
+
+    // Background RSSI, in RegRssiValue units of -0.5 dB
+    uint8_t     _noise;
+    uint8_t     _noiseJitter;
+    uint32_t    _noiseSeed;
+    uint64_t    _carrierUntil;  // end of the last packet on the tuned channel
+    uint8_t     _carrierRssi;
+    uint8_t     _heldRssi;      // RegRssiValue is only measured in RX and keeps its last value
+
+    // Housekeeping ADCs
+    int         _temperature;
+    uint16_t    _supplyMv;
+    uint64_t    _tempDoneAt;    // TempMeasRunning clears
+
+    // Listen mode
+    boolean     _listenOn;
+    boolean     _listenRx;      // in a receive window
+    boolean     _listenWoken;   // wake criteria met, receiving until PayloadReady
+    uint64_t    _listenNext;    // end of the current idle period or receive window
+    boolean     _listenPending; // _listenPacket started on air while the receiver was off
+    AirPacket   _listenPacket;
+
+    AirPacket   _air[RFM69_SIM_AIR_QUEUE];
+    uint8_t     _airCount;
+
+    void        (*_txHandler)(void* ctx, const uint8_t* data, uint8_t len);
+    void*       _txHandlerCtx;
+
+    void        (*_dioHandler[RFM69_SIM_NUM_DIO])(void* ctx);
+    void*       _dioHandlerCtx[RFM69_SIM_NUM_DIO];
+    uint8_t     _dioEdge[RFM69_SIM_NUM_DIO];
+    boolean     _dioLevel[RFM69_SIM_NUM_DIO];
+    boolean     _dioPending[RFM69_SIM_NUM_DIO];
+    boolean     _inHandler;
+
+    RFM69SimStats _stats;
+};
+
+#endif
+
+#endif
@@ -0,0 +1,328 @@
+// RFM69Spool.cpp
+//
+// Copyright (C) 2026 the UKHASnet_rfm69 contributors
+
+#include "RFM69Spool.h"
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define SPOOL_MAGIC     "RFM69SPL"
+#define SPOOL_VERSION   1
+
+// The ring starts a page into the file, after the header
+#define SPOOL_DATA      4096
+
+// A record is a 16 byte header then the packet, padded to a multiple of 8 bytes
+#define RECORD_HEADER   16
+#define RECORD_SIZE(len) (((len) + RECORD_HEADER + 7) & ~7U)
+
+// Fills the space up to the end of the ring when a record would not fit there.
+// Less than a record header at the end is skipped without one.
+#define RECORD_PAD      0x01
+
+struct RFM69Spool::Header
+{
+    char        magic[8];
+    uint32_t    version;
+    uint32_t    capacity;
+    uint64_t    head;       // Positions count bytes since the file was created
+    uint64_t    tail;
+};
+
+// Record layout, little endian as the host is
+//   0  uint16 size     whole record
+//   2  uint16 crc      CRC-16/CCITT over the position then bytes 4 onwards
+//   4  uint8  len
+//   5  uint8  flags
+//   6  int16  rssi
+//   8  uint64 time
+//  16  data
+
+static uint16_t crc16(uint16_t crc, const uint8_t* data, uint32_t len)
+{
+    while (len--) {
+        crc ^= (uint16_t)*data++ << 8;
+        for (uint8_t i = 0; i < 8; i++)
+            crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
+
+static uint16_t recordCrc(uint64_t pos, const uint8_t* rec, uint16_t size)
+{
+    return crc16(crc16(0xFFFF, (const uint8_t*)&pos, sizeof(pos)), rec + 4, size - 4);
+}
+
+RFM69Spool::RFM69Spool()
+{
+    _header = NULL;
+    _ring = NULL;
+    _mapped = 0;
+    _capacity = 0;
+    _pending = 0;
+    clearStats();
+    _recovered = 0;
+    _discarded = 0;
+}
+
+RFM69Spool::~RFM69Spool()
+{
+    close();
+}
+
+boolean RFM69Spool::open(const char* path, uint32_t capacity)
+{
+    close();
+    int fd = ::open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        ::close(fd);
+        return false;
+    }
+
+    // An existing spool keeps its size, anything else is started afresh
+    Header existing;
+    boolean valid = st.st_size >= SPOOL_DATA
+        && pread(fd, &existing, sizeof(existing), 0) == sizeof(existing)
+        && memcmp(existing.magic, SPOOL_MAGIC, 8) == 0
+        && existing.version == SPOOL_VERSION
+        && existing.capacity % 8 == 0
+        && st.st_size >= (off_t)(SPOOL_DATA + existing.capacity);
+    if (valid)
+        capacity = existing.capacity;
+    capacity &= ~7U;
+    if (capacity < 1024)
+        capacity = 1024;
+    if (!valid && ftruncate(fd, SPOOL_DATA + capacity) < 0) {
+        ::close(fd);
+        return false;
+    }
+
+    size_t size = SPOOL_DATA + capacity;
+    void* map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED)
+        return false;
+    _header = (Header*)map;
+    _ring = (uint8_t*)map + SPOOL_DATA;
+    _mapped = size;
+    _capacity = capacity;
+    if (!valid) {
+        memset(_header, 0, sizeof(Header));
+        _header->version = SPOOL_VERSION;
+        _header->capacity = capacity;
+        memcpy(_header->magic, SPOOL_MAGIC, 8);
+    }
+    clearStats();
+    recover();
+    return true;
+}
+
+void RFM69Spool::close()
+{
+    if (!_header)
+        return;
+    munmap(_header, _mapped);
+    _header = NULL;
+    _ring = NULL;
+}
+
+uint8_t* RFM69Spool::record(uint64_t pos) const
+{
+    return _ring + pos % _capacity;
+}
+
+uint64_t RFM69Spool::skipWrap(uint64_t pos) const
+{
+    uint32_t toEnd = _capacity - pos % _capacity;
+    if (toEnd < RECORD_HEADER)
+        return pos + toEnd;
+    const uint8_t* rec = record(pos);
+    if (rec[5] & RECORD_PAD)
+        return pos + toEnd;
+    return pos;
+}
+
+void RFM69Spool::recover()
+{
+    // Walk the published records, stopping at the first that is not whole
+    uint64_t tail = _header->tail;
+    uint64_t head = _header->head;
+    _pending = 0;
+    _recovered = 0;
+    _discarded = 0;
+    if (head < tail || head - tail > _capacity) {
+        _header->tail = _header->head = 0;
+        _discarded = _capacity;
+        return;
+    }
+    uint64_t pos = tail;
+    while (pos < head) {
+        uint32_t toEnd = _capacity - pos % _capacity;
+        if (toEnd < RECORD_HEADER) {
+            pos += toEnd;
+            continue;
+        }
+        const uint8_t* rec = record(pos);
+        uint16_t size;
+        uint16_t crc;
+        memcpy(&size, rec, 2);
+        memcpy(&crc, rec + 2, 2);
+        boolean pad = rec[5] & RECORD_PAD;
+        if (size < RECORD_HEADER || size > toEnd || pos + size > head
+            || (pad ? size != toEnd : size != RECORD_SIZE(rec[4]))
+            || crc != recordCrc(pos, rec, size))
+            break;
+        pos += size;
+        if (!pad)
+            _pending++;
+    }
+    if (pos < head) {
+        _discarded = (uint32_t)(head - pos);
+        __atomic_store_n(&_header->head, pos, __ATOMIC_RELEASE);
+    }
+    _recovered = _pending;
+    _highWater = (uint32_t)(pos - tail);
+}
+
+boolean RFM69Spool::append(const uint8_t* data, uint8_t len, int16_t rssi, uint64_t time)
+{
+    if (!_header)
+        return false;
+    if (time == 0) {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        time = (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+    }
+    uint64_t pos = _header->head;
+    uint16_t size = RECORD_SIZE(len);
+    uint32_t toEnd = _capacity - pos % _capacity;
+    uint32_t skip = toEnd < size ? toEnd : 0;
+    if (pos + skip + size - _header->tail > _capacity) {
+        _dropped++;
+        return false;
+    }
+
+    if (skip) {
+        if (skip >= RECORD_HEADER) {
+            uint8_t* pad = record(pos);
+            uint16_t padSize = (uint16_t)skip;
+            memset(pad + 4, 0, RECORD_HEADER - 4);
+            pad[5] = RECORD_PAD;
+            memcpy(pad, &padSize, 2);
+            uint16_t crc = recordCrc(pos, pad, padSize);
+            memcpy(pad + 2, &crc, 2);
+        }
+        pos += skip;
+    }
+
+    uint8_t* rec = record(pos);
+    memcpy(rec, &size, 2);
+    rec[4] = len;
+    rec[5] = 0;
+    memcpy(rec + 6, &rssi, 2);
+    memcpy(rec + 8, &time, 8);
+    memcpy(rec + RECORD_HEADER, data, len);
+    memset(rec + RECORD_HEADER + len, 0, size - RECORD_HEADER - len);
+    uint16_t crc = recordCrc(pos, rec, size);
+    memcpy(rec + 2, &crc, 2);
+
+    // Publish it only now it is all there
+    __atomic_store_n(&_header->head, pos + size, __ATOMIC_RELEASE);
+    _appended++;
+    _pending++;
+    uint32_t used = (uint32_t)(pos + size - _header->tail);
+    if (used > _highWater)
+        _highWater = used;
+    return true;
+}
+
+boolean RFM69Spool::read(uint64_t* cursor, RFM69SpoolRecord& out) const
+{
+    if (!_header)
+        return false;
+    uint64_t head = _header->head;
+    uint64_t pos = *cursor;
+    if (pos < head)
+        pos = skipWrap(pos);
+    if (pos >= head) {
+        *cursor = head;
+        return false;
+    }
+    const uint8_t* rec = record(pos);
+    uint16_t size;
+    memcpy(&size, rec, 2);
+    out.len = rec[4];
+    memcpy(&out.rssi, rec + 6, 2);
+    memcpy(&out.time, rec + 8, 8);
+    memcpy(out.data, rec + RECORD_HEADER, out.len);
+    *cursor = pos + size;
+    return true;
+}
+
+uint64_t RFM69Spool::tail() const
+{
+    return _header ? _header->tail : 0;
+}
+
+uint64_t RFM69Spool::head() const
+{
+    return _header ? _header->head : 0;
+}
+
+void RFM69Spool::release(uint64_t upto)
+{
+    if (!_header)
+        return;
+    uint64_t pos = _header->tail;
+    if (upto > _header->head)
+        upto = _header->head;
+    while (pos < upto) {
+        pos = skipWrap(pos);
+        if (pos >= upto)
+            break;
+        uint16_t size;
+        memcpy(&size, record(pos), 2);
+        pos += size;
+        if (_pending)
+            _pending--;
+    }
+    if (upto > _header->tail)
+        __atomic_store_n(&_header->tail, upto, __ATOMIC_RELEASE);
+}
+
+void RFM69Spool::sync()
+{
+    if (_header)
+        msync(_header, _mapped, MS_SYNC);
+}
+
+void RFM69Spool::stats(RFM69SpoolStats& stats) const
+{
+    stats.appended = _appended;
+    stats.dropped = _dropped;
+    stats.recovered = _recovered;
+    stats.discarded = _discarded;
+    stats.pending = _pending;
+    stats.used = _header ? (uint32_t)(_header->head - _header->tail) : 0;
+    stats.highWater = _highWater;
+    stats.capacity = _capacity;
+}
+
+void RFM69Spool::clearStats()
+{
+    _appended = 0;
+    _dropped = 0;
+    _highWater = 0;
+}
+
+#endif
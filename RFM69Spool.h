@@ -0,0 +1,126 @@
+// RFM69Spool.h
+//
+// Copyright (C) 2026 the UKHASnet_rfm69 contributors
+//
+// Crash-safe queue of received packets on a gateway, between recv() and
+// whatever takes them off the box (see RFM69Uploader). It is a ring of records
+// in a memory mapped file: appending is a memcpy into the page cache, so it
+// never waits on the disk or the network, and because a record is only
+// published by moving the head after it has been written, a gateway process
+// that dies loses nothing it had appended. The kernel writes the pages back
+// in its own time; call sync() to push them to the disk for power loss too.
+//
+// Each record carries a CRC over its contents and its position in the ring,
+// so on open() anything between the tail and the head that did not make it to
+// the disk whole, or is left over from an earlier lap, is cut off.
+//
+// When the ring is full new packets are dropped and counted, never old ones.
+
+#ifndef RFM69Spool_h
+#define RFM69Spool_h
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include "UKHASnet_rfm69.h"
+
+// Default size of the ring in bytes. A packet of len bytes takes len + 16, rounded up to 8.
+#ifndef RFM69_SPOOL_CAPACITY
+#define RFM69_SPOOL_CAPACITY    (1024UL * 1024UL)
+#endif
+
+/// One spooled packet
+struct RFM69SpoolRecord
+{
+    uint64_t    time;       ///< Wall clock time received, in milliseconds since 1970
+    int16_t     rssi;       ///< In dBm
+    uint8_t     len;
+    uint8_t     data[255];
+};
+
+/// Counters and levels kept by the spool
+struct RFM69SpoolStats
+{
+    uint32_t    appended;   ///< Packets appended since open()
+    uint32_t    dropped;    ///< Packets not appended because the ring was full
+    uint32_t    recovered;  ///< Packets found waiting by open()
+    uint32_t    discarded;  ///< Bytes of torn or stale records cut off by open()
+    uint32_t    pending;    ///< Packets waiting to be released
+    uint32_t    used;       ///< Bytes of the ring in use
+    uint32_t    highWater;  ///< Most bytes in use since open()
+    uint32_t    capacity;   ///< Size of the ring in bytes
+};
+
+class RFM69Spool
+{
+public:
+    RFM69Spool();
+    ~RFM69Spool();
+
+    /// Opens a spool file, creating it if need be, and recovers any packets waiting in it.
+    /// \param[in] path The file
+    /// \param[in] capacity Size of the ring in bytes for a new file. An existing file keeps its own.
+    /// \return false if the file could not be created or mapped
+    boolean     open(const char* path, uint32_t capacity = RFM69_SPOOL_CAPACITY);
+
+    /// Unmaps the file. Anything not released stays in it for the next open().
+    void        close();
+
+    /// \return true between a successful open() and close()
+    boolean     isOpen() const { return _header != NULL; }
+
+    /// Adds a packet at the head of the ring
+    /// \param[in] data The packet, as from RFM69::recv()
+    /// \param[in] len Its length
+    /// \param[in] rssi Its signal strength, eg RFM69::lastRssi()
+    /// \param[in] time Wall clock time in milliseconds since 1970, 0 for now
+    /// \return false if the ring is full and the packet was dropped
+    boolean     append(const uint8_t* data, uint8_t len, int16_t rssi, uint64_t time = 0);
+
+    /// Reads the packet at a position and moves the position on to the next one.
+    /// Start at tail(); the packets up to head() are waiting.
+    /// \param[in,out] cursor Position in the ring
+    /// \param[out] record The packet
+    /// \return false if there is none, *cursor is at head()
+    boolean     read(uint64_t* cursor, RFM69SpoolRecord& record) const;
+
+    /// Position of the oldest packet waiting
+    uint64_t    tail() const;
+
+    /// Position the next packet will be appended at
+    uint64_t    head() const;
+
+    /// Frees the packets before a position, once they have been delivered
+    /// \param[in] upto A cursor from read(), between tail() and head()
+    void        release(uint64_t upto);
+
+    /// Writes the ring back to the disk and waits for it. This blocks on the disk, so
+    /// call it from somewhere that can afford to, or not at all if only crashes of the
+    /// gateway process have to be survived.
+    void        sync();
+
+    void        stats(RFM69SpoolStats& stats) const;
+    void        clearStats();
+
+private:
+    struct Header;
+
+    void        recover();
+    uint8_t*    record(uint64_t pos) const;
+    uint64_t    skipWrap(uint64_t pos) const;
+
+    Header*     _header;
+    uint8_t*    _ring;
+    size_t      _mapped;
+    uint32_t    _capacity;
+
+    uint32_t    _appended;
+    uint32_t    _dropped;
+    uint32_t    _recovered;
+    uint32_t    _discarded;
+    uint32_t    _pending;
+    uint32_t    _highWater;
+};
+
+#endif
+
+#endif
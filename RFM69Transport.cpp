@@ -0,0 +1,44 @@
+// RFM69Transport.cpp
+//
+// Copyright (C) 2026 the UKHASnet_rfm69 contributors
+
+#if defined(ARDUINO)
+
+#include "RFM69Transport.h"
+
+RFM69SPITransport::RFM69SPITransport(uint8_t slaveSelectPin)
+{
+    _slaveSelectPin = slaveSelectPin;
+}
+
+void RFM69SPITransport::begin()
+{
+    pinMode(_slaveSelectPin, OUTPUT); // Init nSS
+    digitalWrite(_slaveSelectPin, HIGH);
+
+    SPI.setDataMode(SPI_MODE0);
+    SPI.setBitOrder(MSBFIRST);
+    SPI.setClockDivider(SPI_CLOCK_DIV2);
+    SPI.begin();
+}
+
+void RFM69SPITransport::select()
+{
+    digitalWrite(_slaveSelectPin, LOW);
+}
+
+void RFM69SPITransport::transfer(const uint8_t* src, uint8_t* dest, uint8_t len)
+{
+    while (len--) {
+        uint8_t val = SPI.transfer(src ? *src++ : 0);
+        if (dest)
+            *dest++ = val;
+    }
+}
+
+void RFM69SPITransport::deselect()
+{
+    digitalWrite(_slaveSelectPin, HIGH);
+}
+
+#endif
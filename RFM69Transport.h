@@ -0,0 +1,60 @@
+// RFM69Transport.h
+//
+// Copyright (C) 2026 the UKHASnet_rfm69 contributors
+//
+// The SPI bus underneath an RFM69. The driver only ever talks to the radio
+// through one of these, so it can run against real hardware or a simulator.
+
+#ifndef RFM69Transport_h
+#define RFM69Transport_h
+
+#include "RFM69Platform.h"
+
+/// Abstract SPI transport for one radio.
+/// A transaction is select(), one or more transfer() calls, then deselect().
+/// Implementations are allowed to defer the actual bus traffic until deselect(),
+/// so the contents of any dest buffer are only valid once deselect() returns.
+class RFM69Transport
+{
+public:
+    virtual ~RFM69Transport() {}
+
+    /// Sets up the bus and the chip select line, leaving the radio deselected. Called from
+    /// RFM69::init(), and before that from RFM69Scheduler::init() so that no radio sharing
+    /// the bus is left selected while another is set up, so it must be safe to call twice.
+    virtual void        begin() = 0;
+
+    /// Asserts chip select, starting a transaction
+    virtual void        select() = 0;
+
+    /// Clocks len bytes through the bus
+    /// \param[in] src Bytes to send, or NULL to send zeros
+    /// \param[out] dest Where to store the bytes received, or NULL to discard them
+    /// \param[in] len Number of bytes
+    virtual void        transfer(const uint8_t* src, uint8_t* dest, uint8_t len) = 0;
+
+    /// Releases chip select, ending the transaction
+    virtual void        deselect() = 0;
+};
+
+#if defined(ARDUINO)
+
+/// Transport over the Arduino hardware SPI with a GPIO chip select
+class RFM69SPITransport : public RFM69Transport
+{
+public:
+    /// \param[in] slaveSelectPin Arduino pin wired to the radio NSS
+    RFM69SPITransport(uint8_t slaveSelectPin = 10);
+
+    void        begin();
+    void        select();
+    void        transfer(const uint8_t* src, uint8_t* dest, uint8_t len);
+    void        deselect();
+
+private:
+    uint8_t     _slaveSelectPin;
+};
+
+#endif
+
+#endif
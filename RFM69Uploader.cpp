@@ -0,0 +1,458 @@
+// RFM69Uploader.cpp
+//
+// Copyright (C) 2026 the UKHASnet_rfm69 contributors
+
+#include "RFM69Uploader.h"
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+
+#define HEADROOM    512
+
+// Longest JSON line for one packet, every byte escaped
+#define LINE_MAX_LEN (255 * 6 + 64)
+
+static uint64_t nowMs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+// Whether the header starting at line is name, with token among its comma separated values.
+// Both are compared ignoring case, and only up to the end of the line.
+static boolean headerHas(const char* line, const char* name, const char* token)
+{
+    size_t nameLen = strlen(name);
+    if (strncasecmp(line, name, nameLen) != 0 || line[nameLen] != ':')
+        return false;
+    const char* end = strstr(line, "\r\n");
+    if (!end)
+        end = line + strlen(line); // The last header
+    size_t tokenLen = strlen(token);
+    const char* p = line + nameLen + 1;
+    while (p < end) {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == ','))
+            p++;
+        const char* word = p;
+        while (p < end && *p != ',' && *p != ';' && *p != ' ' && *p != '\t')
+            p++;
+        if ((size_t)(p - word) == tokenLen && strncasecmp(word, token, tokenLen) == 0)
+            return true;
+        while (p < end && *p != ',')
+            p++; // Parameters
+    }
+    return false;
+}
+
+RFM69Uploader::RFM69Uploader(RFM69Spool& spool)
+{
+    _spool = &spool;
+    _host[0] = '\0';
+    _path[0] = '\0';
+    _port = 80;
+    _addressLen = 0;
+    _state = STATE_IDLE;
+    _fd = -1;
+    _reused = false;
+    _keepAlive = false;
+    _retryAt = 0;
+    _isolateEnd = 0;
+    _isolate = 0;
+    setBatch(RFM69_UPLOAD_BATCH);
+    clearStats();
+}
+
+RFM69Uploader::~RFM69Uploader()
+{
+    disconnect();
+}
+
+boolean RFM69Uploader::begin(const char* url)
+{
+    if (strncmp(url, "http://", 7) != 0)
+        return false;
+    const char* host = url + 7;
+    const char* path = strchr(host, '/');
+    size_t hostLen = path ? (size_t)(path - host) : strlen(host);
+    if (!path)
+        path = "/";
+    if (hostLen == 0 || hostLen >= sizeof(_host) || strlen(path) >= sizeof(_path))
+        return false;
+    memcpy(_host, host, hostLen);
+    _host[hostLen] = '\0';
+    strcpy(_path, path);
+
+    char port[8] = "80";
+    char* colon = strrchr(_host, ':');
+    if (colon) {
+        *colon = '\0';
+        snprintf(port, sizeof(port), "%s", colon + 1);
+    }
+    _port = (uint16_t)atoi(port);
+
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo* found;
+    if (getaddrinfo(_host, port, &hints, &found) != 0)
+        return false;
+    boolean ok = found->ai_addrlen <= sizeof(_address);
+    if (ok) {
+        memcpy(_address, found->ai_addr, found->ai_addrlen);
+        _addressLen = found->ai_addrlen;
+    }
+    freeaddrinfo(found);
+    disconnect();
+    _state = STATE_IDLE;
+    return ok;
+}
+
+void RFM69Uploader::setBatch(uint16_t records, uint32_t lingerMs, uint32_t timeoutMs)
+{
+    _batch = records == 0 ? 1 : records > RFM69_UPLOAD_BATCH ? RFM69_UPLOAD_BATCH : records;
+    _linger = lingerMs;
+    _timeout = timeoutMs;
+}
+
+void RFM69Uploader::poll()
+{
+    if (_addressLen == 0)
+        return;
+    uint64_t now = nowMs();
+    if (_state == STATE_IDLE) {
+        if (now < _retryAt || !build())
+            return;
+        start(now);
+    }
+
+    if (_state == STATE_CONNECTING) {
+        struct pollfd pfd = { _fd, POLLOUT, 0 };
+        if (::poll(&pfd, 1, 0) == 1) {
+            int error = 0;
+            socklen_t len = sizeof(error);
+            getsockopt(_fd, SOL_SOCKET, SO_ERROR, &error, &len);
+            if (error) {
+                finish(now, false);
+                return;
+            }
+            _state = STATE_SENDING;
+        }
+    }
+
+    if (_state == STATE_SENDING) {
+        while (_sent < _requestLen) {
+            ssize_t done = send(_fd, _request + _requestStart + _sent, _requestLen - _sent,
+                                MSG_NOSIGNAL | MSG_DONTWAIT);
+            if (done < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK)
+                    break;
+                finish(now, false);
+                return;
+            }
+            _sent += done;
+        }
+        if (_sent == _requestLen)
+            _state = STATE_RECEIVING;
+    }
+
+    if (_state == STATE_RECEIVING)
+        receive(now);
+
+    if (_state != STATE_IDLE && now - _startedAt >= _timeout) {
+        _stats.timeouts++;
+        _reused = false; // A slow collector is a failure however the connection came about
+        finish(now, false);
+    }
+}
+
+boolean RFM69Uploader::build()
+{
+    RFM69SpoolStats spool;
+    _spool->stats(spool);
+    if (spool.pending == 0)
+        return false;
+
+    // Wait for a full batch, or for the oldest packet to have waited long enough
+    uint64_t cursor = _spool->tail();
+    uint16_t batch = cursor < _isolateEnd ? _isolate : _batch;
+    RFM69SpoolRecord record;
+    if (spool.pending < batch && _spool->read(&cursor, record)) {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        uint64_t wall = (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+        if (wall >= record.time && wall - record.time < _linger)
+            return false;
+    }
+
+    char* body = _request + HEADROOM;
+    uint32_t len = 0;
+    _batchCount = 0;
+    cursor = _spool->tail();
+    uint64_t next = cursor;
+    while (_batchCount < batch && RFM69_UPLOAD_BODY - len >= LINE_MAX_LEN
+           && _spool->read(&next, record)) {
+        len += snprintf(body + len, RFM69_UPLOAD_BODY - len, "{\"time\":%llu,\"rssi\":%d,\"packet\":\"",
+                        (unsigned long long)record.time, record.rssi);
+        for (uint8_t i = 0; i < record.len; i++) {
+            uint8_t c = record.data[i];
+            if (c == '"' || c == '\\') {
+                body[len++] = '\\';
+                body[len++] = c;
+            } else if (c < 0x20 || c >= 0x7F) {
+                len += snprintf(body + len, 7, "\\u%04x", c);
+            } else {
+                body[len++] = c;
+            }
+        }
+        memcpy(body + len, "\"}\n", 3);
+        len += 3;
+        _batchCount++;
+        cursor = next;
+    }
+    _batchEnd = cursor;
+
+    char headers[HEADROOM];
+    int headersLen = snprintf(headers, sizeof(headers),
+        "POST %s HTTP/1.1\r\nHost: %s:%u\r\nContent-Type: application/x-ndjson\r\nContent-Length: %u\r\n\r\n",
+        _path, _host, _port, len);
+    _requestStart = HEADROOM - headersLen;
+    memcpy(_request + _requestStart, headers, headersLen);
+    _requestLen = headersLen + len;
+    _stats.bytes += len;
+    return true;
+}
+
+void RFM69Uploader::start(uint64_t now)
+{
+    _stats.requests++;
+    _startedAt = now;
+    _sent = 0;
+    _responseLen = 0;
+    _bodyLeft = -1;
+    _chunked = false;
+    _chunkState = CHUNK_SIZE;
+    _chunkLeft = 0;
+    _keepAlive = true;
+    if (_fd >= 0) {
+        _reused = true;
+        _state = STATE_SENDING;
+        return;
+    }
+    _reused = false;
+    _fd = socket(((struct sockaddr*)_address)->sa_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (_fd < 0) {
+        finish(now, false);
+        return;
+    }
+    if (connect(_fd, (struct sockaddr*)_address, _addressLen) == 0)
+        _state = STATE_SENDING;
+    else if (errno == EINPROGRESS)
+        _state = STATE_CONNECTING;
+    else
+        finish(now, false);
+}
+
+void RFM69Uploader::receive(uint64_t now)
+{
+    for (;;) {
+        // Headers are kept, the body is only counted
+        char discard[512];
+        boolean headers = _bodyLeft < 0;
+        char* into = headers ? _response + _responseLen : discard;
+        uint32_t room = headers ? sizeof(_response) - 1 - _responseLen : sizeof(discard);
+        if (room == 0) {
+            finish(now, false); // Headers too long to be a collector's answer
+            return;
+        }
+        ssize_t got = recv(_fd, into, room, MSG_DONTWAIT);
+        if (got < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                finish(now, false);
+            return;
+        }
+        if (got == 0) {
+            // Closed. Fine after an answer with no length, which runs to the close.
+            _keepAlive = false;
+            finish(now, _bodyLeft == INT32_MAX);
+            return;
+        }
+
+        const char* body = into;
+        if (!headers) {
+            if (_bodyLeft != INT32_MAX && !_chunked)
+                _bodyLeft -= got;
+        } else {
+            _responseLen += got;
+            _response[_responseLen] = '\0';
+            char* end = strstr(_response, "\r\n\r\n");
+            if (!end)
+                continue;
+            *end = '\0';
+            int32_t extra = (int32_t)(_response + _responseLen - (end + 4));
+            _bodyLeft = INT32_MAX;
+            for (char* line = strstr(_response, "\r\n"); line; line = strstr(line + 2, "\r\n")) {
+                if (strncasecmp(line + 2, "content-length:", 15) == 0)
+                    _bodyLeft = atoi(line + 17) - extra;
+                else if (headerHas(line + 2, "connection", "close"))
+                    _keepAlive = false;
+                else if (headerHas(line + 2, "transfer-encoding", "chunked"))
+                    _chunked = true;
+            }
+            if (_chunked)
+                _bodyLeft = 1; // Overrides any Content-Length
+            else if (_bodyLeft == INT32_MAX)
+                _keepAlive = false;
+            body = end + 4;
+            got = extra;
+        }
+        if (_chunked && got > 0) {
+            int8_t last = dechunk(body, (uint32_t)got);
+            if (last < 0) {
+                finish(now, false);
+                return;
+            }
+            if (last)
+                _bodyLeft = 0;
+        }
+        if (_bodyLeft <= 0) {
+            finish(now, true);
+            return;
+        }
+    }
+}
+
+// Follows a chunked body through data that may end anywhere in it. The data itself is not kept.
+// \return 1 once the last chunk and its trailers are in, 0 while more is due, -1 if it is malformed
+int8_t RFM69Uploader::dechunk(const char* data, uint32_t len)
+{
+    for (uint32_t i = 0; i < len; i++) {
+        char c = data[i];
+        switch (_chunkState) {
+        case CHUNK_SIZE:
+        case CHUNK_EXTENSION:
+            if (c == '\n') {
+                _chunkState = _chunkLeft ? CHUNK_DATA : CHUNK_TRAILER;
+            } else if (_chunkState == CHUNK_EXTENSION) {
+                // Skipped
+            } else if (isxdigit((unsigned char)c)) {
+                if (_chunkLeft >> 27)
+                    return -1; // Far more than any collector answers with
+                _chunkLeft = _chunkLeft * 16 + (c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10);
+            } else if (c == ';' || c == '\r' || c == ' ' || c == '\t') {
+                _chunkState = CHUNK_EXTENSION;
+            } else {
+                return -1;
+            }
+            break;
+        case CHUNK_DATA: {
+            uint32_t skip = len - i < _chunkLeft ? len - i : _chunkLeft;
+            _chunkLeft -= skip;
+            i += skip - 1;
+            if (!_chunkLeft)
+                _chunkState = CHUNK_DATA_END;
+            break;
+        }
+        case CHUNK_DATA_END:
+            if (c == '\n')
+                _chunkState = CHUNK_SIZE;
+            break;
+        case CHUNK_TRAILER:
+            if (c == '\n')
+                return 1;
+            if (c != '\r')
+                _chunkState = CHUNK_TRAILER_LINE;
+            break;
+        case CHUNK_TRAILER_LINE:
+            if (c == '\n')
+                _chunkState = CHUNK_TRAILER;
+            break;
+        }
+    }
+    return 0;
+}
+
+void RFM69Uploader::finish(uint64_t now, boolean answered)
+{
+    int status = 0;
+    if (answered && strncmp(_response, "HTTP/1.", 7) == 0)
+        status = atoi(_response + 9);
+    if (status >= 200 && status < 300) {
+        _spool->release(_batchEnd);
+        _stats.batches++;
+        _stats.uploaded += _batchCount;
+        _stats.latency = (uint32_t)(now - _startedAt);
+        _stats.backoff = 0;
+        _retryAt = 0;
+        if (_isolate < _batch)
+            _isolate *= 2; // Back towards full batches, past a refused packet
+
+        if (!_keepAlive)
+            disconnect();
+        _state = STATE_IDLE;
+        return;
+    }
+    if (status >= 400 && status < 500 && status != 408 && status != 429) {
+        // Refused for what is in it, so sending it again as it is would only fail again
+        _stats.failures++;
+        if (_batchCount > 1) {
+            if (_spool->tail() >= _isolateEnd)
+                _isolateEnd = _batchEnd;
+            _isolate = _batchCount / 2;
+        } else {
+            _spool->release(_batchEnd);
+            _stats.rejected++;
+        }
+        if (!_keepAlive)
+            disconnect();
+        _state = STATE_IDLE;
+        return;
+    }
+
+    boolean early = !answered && _responseLen == 0;
+    disconnect();
+    _state = STATE_IDLE;
+    if (_reused && early) {
+        // The collector had closed the kept connection while it was idle, try a fresh one
+        _stats.requests--;
+        _stats.bytes -= _requestLen - (HEADROOM - _requestStart);
+        return;
+    }
+    _stats.failures++;
+    _stats.backoff = _stats.backoff ? _stats.backoff * 2 : RFM69_UPLOAD_RETRY_MIN;
+    if (_stats.backoff > RFM69_UPLOAD_RETRY_MAX)
+        _stats.backoff = RFM69_UPLOAD_RETRY_MAX;
+    _retryAt = now + _stats.backoff;
+}
+
+void RFM69Uploader::disconnect()
+{
+    if (_fd >= 0) {
+        close(_fd);
+        _fd = -1;
+    }
+}
+
+void RFM69Uploader::stats(RFM69UploaderStats& stats) const
+{
+    stats = _stats;
+}
+
+void RFM69Uploader::clearStats()
+{
+    memset(&_stats, 0, sizeof(_stats));
+}
+
+#endif
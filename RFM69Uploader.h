@@ -0,0 +1,163 @@
+// RFM69Uploader.h
+//
+// Copyright (C) 2026 the UKHASnet_rfm69 contributors
+//
+// Drains an RFM69Spool to an HTTP collector in batches. Each batch is one POST
+// of newline separated JSON objects,
+//
+//   {"time":1418428800000,"rssi":-92,"packet":"3aT12.3[AB1]"}
+//
+// and the packets in it are only released from the spool once the collector
+// has answered with a 2xx status, so an outage or a stalled connection just
+// leaves them queued. A batch whose answer was lost is sent again, so the
+// collector sees every packet at least once.
+//
+// A 4xx answer, other than 408 and 429, says the batch itself is at fault, so it
+// is not sent again as it is. The batch is halved until the packet the collector
+// refuses is sent on its own, then that packet is released and counted as rejected.
+//
+// The connection is kept between batches. The collector's answer may give a
+// Content-Length, come in chunks or run to the close.
+//
+// Everything is done with non-blocking sockets from poll(), on the same thread
+// as the radio, so the main loop never waits on the network. Only begin()
+// blocks, while it looks the host name up.
+
+#ifndef RFM69Uploader_h
+#define RFM69Uploader_h
+
+#if defined(__linux__) && !defined(ARDUINO)
+
+#include "RFM69Spool.h"
+
+// Most packets in one request
+#ifndef RFM69_UPLOAD_BATCH
+#define RFM69_UPLOAD_BATCH      64
+#endif
+
+// Milliseconds a packet waits for more to fill its batch
+#ifndef RFM69_UPLOAD_LINGER
+#define RFM69_UPLOAD_LINGER     1000
+#endif
+
+// Milliseconds from connecting to the end of the answer before a request is given up
+#ifndef RFM69_UPLOAD_TIMEOUT
+#define RFM69_UPLOAD_TIMEOUT    10000
+#endif
+
+// Wait after a failure, doubling on each one in a row up to the maximum
+#define RFM69_UPLOAD_RETRY_MIN  1000
+#define RFM69_UPLOAD_RETRY_MAX  60000
+
+// Room for the body of one request, enough for a full batch of the longest packets
+// only if they need no escaping, so a batch also ends when it is nearly full
+#define RFM69_UPLOAD_BODY       16384
+
+/// Counters kept by the uploader
+struct RFM69UploaderStats
+{
+    uint32_t    requests;   ///< POSTs started
+    uint32_t    batches;    ///< POSTs answered with a 2xx status
+    uint32_t    uploaded;   ///< Packets released from the spool
+    uint32_t    failures;   ///< POSTs that failed: refused, timed out, error status, closed early
+    uint32_t    timeouts;   ///< POSTs given up after RFM69_UPLOAD_TIMEOUT
+    uint32_t    rejected;   ///< Packets the collector refused on their own, released without being uploaded
+    uint32_t    bytes;      ///< Body bytes sent, including batches sent again
+    uint32_t    latency;    ///< Milliseconds the last successful POST took
+    uint32_t    backoff;    ///< Current wait after a failure, 0 when the last POST worked
+};
+
+class RFM69Uploader
+{
+public:
+    /// \param[in] spool The spool to drain, open() it first
+    RFM69Uploader(RFM69Spool& spool);
+    ~RFM69Uploader();
+
+    /// Sets the collector. Looks the host up, so this blocks.
+    /// \param[in] url "http://host[:port]/path", https is not supported
+    /// \return false if the URL could not be parsed or the host looked up
+    boolean     begin(const char* url);
+
+    /// \param[in] records Most packets in one request, up to RFM69_UPLOAD_BATCH
+    /// \param[in] lingerMs Milliseconds a packet waits for more to fill its batch
+    /// \param[in] timeoutMs Milliseconds a request may take
+    void        setBatch(uint16_t records, uint32_t lingerMs = RFM69_UPLOAD_LINGER,
+                         uint32_t timeoutMs = RFM69_UPLOAD_TIMEOUT);
+
+    /// Moves the upload on as far as it can go without blocking. Call from the main loop.
+    void        poll();
+
+    /// \return true while a request is in progress
+    boolean     busy() const { return _state != STATE_IDLE; }
+
+    void        stats(RFM69UploaderStats& stats) const;
+    void        clearStats();
+
+private:
+    enum State
+    {
+        STATE_IDLE,
+        STATE_CONNECTING,
+        STATE_SENDING,
+        STATE_RECEIVING,
+    };
+
+    // Where a chunked body is up to
+    enum ChunkState
+    {
+        CHUNK_SIZE,         // Hex size of the next chunk
+        CHUNK_EXTENSION,    // Rest of the size line
+        CHUNK_DATA,
+        CHUNK_DATA_END,     // CRLF after the data
+        CHUNK_TRAILER,      // Start of a trailer line, an empty one ends the body
+        CHUNK_TRAILER_LINE,
+    };
+
+    boolean     build();
+    void        start(uint64_t now);
+    void        receive(uint64_t now);
+    int8_t      dechunk(const char* data, uint32_t len);
+    void        finish(uint64_t now, boolean ok);
+    void        disconnect();
+
+    RFM69Spool* _spool;
+    char        _host[128];
+    char        _path[128];
+    uint16_t    _port;
+    uint8_t     _address[128];  // struct sockaddr_storage, kept opaque
+    uint32_t    _addressLen;
+
+    uint16_t    _batch;
+    uint32_t    _linger;
+    uint32_t    _timeout;
+
+    State       _state;
+    int         _fd;
+    boolean     _reused;        // Request sent on a connection kept from the last one
+    boolean     _keepAlive;     // Connection can be kept after this answer
+    uint64_t    _startedAt;
+    uint64_t    _retryAt;
+    uint64_t    _batchEnd;      // Spool cursor after the last packet in the request
+    uint16_t    _batchCount;
+    uint64_t    _isolateEnd;    // Batches stay at _isolate packets up to this cursor, after a rejection
+    uint16_t    _isolate;
+
+    char        _request[512 + RFM69_UPLOAD_BODY];
+    uint32_t    _requestStart;  // Headers are written in front of the body
+    uint32_t    _requestLen;
+    uint32_t    _sent;
+
+    char        _response[1024];
+    uint32_t    _responseLen;
+    int32_t     _bodyLeft;      // Bytes of the answer's body still to come, -1 until the headers are in
+    boolean     _chunked;       // Body is sent in chunks, _bodyLeft stays 1 until the last one
+    ChunkState  _chunkState;
+    uint32_t    _chunkLeft;     // Size of the chunk being read, or being parsed from its size line
+
+    RFM69UploaderStats _stats;
+};
+
+#endif
+
+#endif
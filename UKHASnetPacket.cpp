@@ -0,0 +1,183 @@
+// UKHASnetPacket.cpp
+//
+// Copyright (C) 2026 the UKHASnet_rfm69 contributors
+
+#include "UKHASnetPacket.h"
+
+#if defined(__SSE2__) && !defined(__AVR__)
+#include <emmintrin.h>
+#endif
+
+// Parser states, advanced by each separator
+#define UKHASNET_STATE_DATA     0
+#define UKHASNET_STATE_COMMENT  1   // ':' runs to the path, whatever it contains
+#define UKHASNET_STATE_PATH     2
+#define UKHASNET_STATE_DONE     3
+
+// Start of the data fields, after the repeat digit and the sequence letter
+#define UKHASNET_DATA_START     2
+
+// True for every character the parser has to look at: field types, the comment marker
+// and the path punctuation. Everything else is part of a value or a node name.
+static inline boolean isSeparator(uint8_t c)
+{
+    return (uint8_t)(c - 'A') < 26 || c == ':' || c == '[' || c == ',' || c == ']';
+}
+
+uint32_t ukhasnetHash(const void* data, uint8_t len, uint32_t hash)
+{
+    const uint8_t* p = (const uint8_t*)data;
+    for (uint8_t i = 0; i < len; i++)
+        hash = (hash ^ p[i]) * 16777619UL;
+    return hash;
+}
+
+boolean UKHASnetView::equals(const char* s) const
+{
+    return strlen(s) == len && memcmp(ptr, s, len) == 0;
+}
+
+boolean UKHASnetView::equals(const UKHASnetView& other) const
+{
+    return other.len == len && memcmp(ptr, other.ptr, len) == 0;
+}
+
+boolean UKHASnetPacket::begin(const uint8_t* buf, uint8_t len)
+{
+    // The shortest packet is "0a[X]"
+    if (len < 5 || buf[0] < '0' || buf[0] > '9' || buf[1] < 'a' || buf[1] > 'z')
+        return false;
+    _buf = (const char*)buf;
+    _len = len;
+    _state = UKHASNET_STATE_DATA;
+    _start = UKHASNET_DATA_START;
+    _repeat = buf[0] - '0';
+    _sequence = buf[1];
+    _fieldCount = 0;
+    _pathCount = 0;
+    return true;
+}
+
+// Handles the separator at i. Returns false if the packet is malformed.
+boolean UKHASnetPacket::separator(uint8_t i)
+{
+    char c = _buf[i];
+    switch (_state) {
+    case UKHASNET_STATE_DATA:
+    case UKHASNET_STATE_COMMENT:
+        if (c == ',' || (_state == UKHASNET_STATE_COMMENT && c != '['))
+            return true; // Part of a value
+        if (c == ']')
+            return false;
+        if (_fieldCount)
+            _fields[_fieldCount - 1].value = { _buf + _start, (uint8_t)(i - _start) };
+        else if (i != UKHASNET_DATA_START)
+            return false; // Something other than a field before the first field
+        if (c == '[') {
+            _data = { _buf + UKHASNET_DATA_START, (uint8_t)(i - UKHASNET_DATA_START) };
+            _state = UKHASNET_STATE_PATH;
+        } else {
+            if (_fieldCount == UKHASNET_MAX_FIELDS)
+                return false;
+            _fields[_fieldCount++].type = c;
+            if (c == ':')
+                _state = UKHASNET_STATE_COMMENT;
+        }
+        _start = i + 1;
+        return true;
+
+    case UKHASNET_STATE_PATH:
+        if (c != ',' && c != ']')
+            return c != '[' && c != ':'; // Upper case is fine in node names
+        if (i == _start || _pathCount == UKHASNET_MAX_PATH)
+            return false;
+        _path[_pathCount++] = { _buf + _start, (uint8_t)(i - _start) };
+        _start = i + 1;
+        if (c == ']') {
+            _state = UKHASNET_STATE_DONE;
+            return i == _len - 1; // The path ends the packet
+        }
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+boolean UKHASnetPacket::end()
+{
+    return _state == UKHASNET_STATE_DONE;
+}
+
+boolean UKHASnetPacket::parse(const uint8_t* buf, uint8_t len)
+{
+    if (!begin(buf, len))
+        return false;
+    for (uint8_t i = UKHASNET_DATA_START; i < len; i++)
+        if (isSeparator(buf[i]) && !separator(i))
+            return false;
+    return end();
+}
+
+#if !defined(__AVR__)
+boolean UKHASnetPacket::parseFast(const uint8_t* buf, uint8_t len)
+{
+#if defined(__SSE2__)
+    if (!begin(buf, len))
+        return false;
+
+    // Bias so that 'A' to 'Z' become the 26 smallest signed bytes
+    const __m128i upperBias = _mm_set1_epi8((char)(0x80 - 'A'));
+    const __m128i upperLimit = _mm_set1_epi8((char)(0x80 + 26));
+    const __m128i colon = _mm_set1_epi8(':');
+    const __m128i open = _mm_set1_epi8('[');
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i close = _mm_set1_epi8(']');
+
+    for (uint16_t base = UKHASNET_DATA_START; base < len; base += 16) {
+        __m128i v;
+        uint8_t left = len - base;
+        if (left >= 16) {
+            v = _mm_loadu_si128((const __m128i*)(buf + base));
+        } else {
+            // Do not read past the end of the packet
+            uint8_t tail[16] = { 0 };
+            memcpy(tail, buf + base, left);
+            v = _mm_loadu_si128((const __m128i*)tail);
+        }
+        __m128i hits = _mm_cmplt_epi8(_mm_add_epi8(v, upperBias), upperLimit);
+        hits = _mm_or_si128(hits, _mm_cmpeq_epi8(v, colon));
+        hits = _mm_or_si128(hits, _mm_cmpeq_epi8(v, open));
+        hits = _mm_or_si128(hits, _mm_cmpeq_epi8(v, comma));
+        hits = _mm_or_si128(hits, _mm_cmpeq_epi8(v, close));
+        uint32_t mask = (uint32_t)_mm_movemask_epi8(hits);
+        if (left < 16)
+            mask &= (1U << left) - 1;
+        while (mask) {
+            if (!separator(base + __builtin_ctz(mask)))
+                return false;
+            mask &= mask - 1;
+        }
+    }
+    return end();
+#else
+    return parse(buf, len);
+#endif
+}
+#endif
+
+const UKHASnetField* UKHASnetPacket::find(char type) const
+{
+    for (uint8_t i = 0; i < _fieldCount; i++)
+        if (_fields[i].type == type)
+            return &_fields[i];
+    return NULL;
+}
+
+boolean UKHASnetPacket::pathContains(const char* node) const
+{
+    for (uint8_t i = 0; i < _pathCount; i++)
+        if (_path[i].equals(node))
+            return true;
+    return false;
+}
@@ -0,0 +1,123 @@
+// UKHASnetPacket.h
+//
+// Copyright (C) 2026 the UKHASnet_rfm69 contributors
+//
+// Single pass, allocation free parser for UKHASnet packets such as
+//
+//   3aT12.3,14.1L51.5,-0.1V3.3:hello[AB1,CD2]
+//
+// a repeat count digit, a sequence letter, typed data fields (an upper case
+// letter, or ':' for a comment, followed by its value) and the path of nodes
+// the packet has been through, the first of which is the origin. The parsed
+// packet only holds views into the receive buffer, which must outlive it.
+
+#ifndef UKHASnetPacket_h
+#define UKHASnetPacket_h
+
+#include "UKHASnet_rfm69.h"
+
+// Most data fields and path entries a packet can have. Packets with more do not parse.
+#ifndef UKHASNET_MAX_FIELDS
+#define UKHASNET_MAX_FIELDS 16
+#endif
+#ifndef UKHASNET_MAX_PATH
+#define UKHASNET_MAX_PATH   16
+#endif
+
+// FNV-1a offset basis, what ukhasnetHash() starts from
+#define UKHASNET_HASH_INIT  2166136261UL
+
+/// FNV-1a hash, as used to key nodes and packets in tables and filters
+/// \param[in] data Bytes to hash
+/// \param[in] len Number of bytes
+/// \param[in] hash UKHASNET_HASH_INIT, or the hash of what comes before data to carry it on
+/// \return The hash of everything so far
+uint32_t ukhasnetHash(const void* data, uint8_t len, uint32_t hash = UKHASNET_HASH_INIT);
+
+/// A run of characters inside a received packet. Not NUL terminated.
+struct UKHASnetView
+{
+    const char*     ptr;
+    uint8_t         len;
+
+    /// \return true if the view holds exactly the NUL terminated string s
+    boolean         equals(const char* s) const;
+
+    /// \return true if the view holds exactly the same characters as other
+    boolean         equals(const UKHASnetView& other) const;
+
+    /// \return ukhasnetHash() of the characters, carrying on from hash
+    uint32_t        hash(uint32_t hash = UKHASNET_HASH_INIT) const { return ukhasnetHash(ptr, len, hash); }
+};
+
+/// One data field, eg T12.3 is type 'T' with value "12.3"
+struct UKHASnetField
+{
+    char            type;   ///< Upper case letter, or ':' for a comment
+    UKHASnetView    value;  ///< Everything up to the next field, may be empty
+};
+
+class UKHASnetPacket
+{
+public:
+    /// Parses a packet, as returned by RFM69::recv() or RFM69::recvLease()
+    /// \param[in] buf The packet. Must stay unchanged while this UKHASnetPacket is used.
+    /// \param[in] len Length of the packet
+    /// \return true if the packet is well formed. Otherwise the contents are undefined.
+    boolean         parse(const uint8_t* buf, uint8_t len);
+
+#if !defined(__AVR__)
+    /// Same as parse(), but finds the field and path separators 16 bytes at a time with
+    /// SSE2 where the target has it, for gateways handling traffic from many radios.
+    /// Falls back to parse() elsewhere. Gives exactly the same result as parse().
+    boolean         parseFast(const uint8_t* buf, uint8_t len);
+#endif
+
+    /// \return The number of hops the packet may still be repeated, 0 to 9
+    uint8_t         repeat() const { return _repeat; }
+
+    /// \return The sequence letter, 'a' to 'z'
+    char            sequence() const { return _sequence; }
+
+    /// \return Everything between the sequence letter and the path
+    const UKHASnetView& data() const { return _data; }
+
+    uint8_t         fieldCount() const { return _fieldCount; }
+    const UKHASnetField& field(uint8_t i) const { return _fields[i]; }
+
+    /// \return The first field of the given type, or NULL if there is none
+    const UKHASnetField* find(char type) const;
+
+    /// \return The number of nodes in the path, at least 1
+    uint8_t         pathCount() const { return _pathCount; }
+    const UKHASnetView& path(uint8_t i) const { return _path[i]; }
+
+    /// \return The node that sent the packet first
+    const UKHASnetView& origin() const { return _path[0]; }
+
+    /// \return The node the packet was last heard from
+    const UKHASnetView& lastHop() const { return _path[_pathCount - 1]; }
+
+    /// \return true if node is already in the path
+    boolean         pathContains(const char* node) const;
+
+private:
+    boolean         begin(const uint8_t* buf, uint8_t len);
+    boolean         separator(uint8_t i);
+    boolean         end();
+
+    const char*     _buf;
+    uint8_t         _len;
+    uint8_t         _state;
+    uint8_t         _start;     // First character of the field or node being parsed
+
+    uint8_t         _repeat;
+    char            _sequence;
+    UKHASnetView    _data;
+    uint8_t         _fieldCount;
+    UKHASnetField   _fields[UKHASNET_MAX_FIELDS];
+    uint8_t         _pathCount;
+    UKHASnetView    _path[UKHASNET_MAX_PATH];
+};
+
+#endif
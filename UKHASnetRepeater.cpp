@@ -0,0 +1,152 @@
+// UKHASnetRepeater.cpp
+//
+// Copyright (C) 2026 the UKHASnet_rfm69 contributors
+
+#include "UKHASnetRepeater.h"
+
+#if (UKHASNET_DEDUP_SIZE & (UKHASNET_DEDUP_SIZE - 1)) != 0
+#error UKHASNET_DEDUP_SIZE must be a power of 2
+#endif
+
+// Entry timestamps count in units of 1024ms
+#define DEDUP_TIME(ms)  ((uint16_t)((ms) >> 10))
+
+UKHASnetDedup::UKHASnetDedup()
+{
+    clear();
+}
+
+void UKHASnetDedup::clear()
+{
+    memset(_entries, 0, sizeof(_entries));
+    _sweep = 0;
+}
+
+boolean UKHASnetDedup::expired(const Entry& entry, uint16_t now) const
+{
+    return (uint16_t)(now - entry.seen) > DEDUP_TIME(UKHASNET_DEDUP_EXPIRY);
+}
+
+boolean UKHASnetDedup::seen(const UKHASnetView& origin, char sequence, uint32_t now, boolean remember)
+{
+    // Over the origin and the sequence letter
+    uint32_t key = ukhasnetHash(&sequence, 1, origin.hash());
+    if (key == 0)
+        key = 1; // 0 marks an empty slot
+
+    // Probe a fixed window, rather than stopping at the first empty slot, so that
+    // entries can be emptied when they expire without breaking other keys' chains
+    uint16_t t = DEDUP_TIME(now);
+    Entry* slot = NULL;
+    Entry* oldest = NULL;
+    for (uint8_t probe = 0; probe < UKHASNET_DEDUP_PROBES; probe++) {
+        Entry* entry = &_entries[(key + probe) & (UKHASNET_DEDUP_SIZE - 1)];
+        if (entry->key == key) {
+            boolean recent = !expired(*entry, t);
+            if (remember)
+                entry->seen = t;
+            return recent;
+        }
+        if (!slot && (entry->key == 0 || expired(*entry, t)))
+            slot = entry;
+        if (!oldest || (uint16_t)(t - entry->seen) > (uint16_t)(t - oldest->seen))
+            oldest = entry;
+    }
+    if (!remember)
+        return false;
+    if (!slot)
+        slot = oldest; // Window full of live entries, forget the oldest
+    slot->key = key;
+    slot->seen = t;
+    return false;
+}
+
+void UKHASnetDedup::sweep(uint32_t now)
+{
+    uint16_t t = DEDUP_TIME(now);
+    for (uint8_t i = 0; i < 2; i++) {
+        Entry* entry = &_entries[_sweep++ & (UKHASNET_DEDUP_SIZE - 1)];
+        if (entry->key && expired(*entry, t))
+            entry->key = 0;
+    }
+}
+
+UKHASnetRepeater::UKHASnetRepeater(RFM69& radio, const char* nodeId)
+{
+    _radio = &radio;
+    _nodeIdLen = 0;
+    while (_nodeIdLen < UKHASNET_MAX_NODE_LEN && nodeId[_nodeIdLen]) {
+        _nodeId[_nodeIdLen] = nodeId[_nodeIdLen];
+        _nodeIdLen++;
+    }
+    _nodeId[_nodeIdLen] = '\0';
+    _received = 0;
+    _forwarded = 0;
+    _duplicates = 0;
+    _malformed = 0;
+    _dropped = 0;
+    _drift = NULL;
+}
+
+boolean UKHASnetRepeater::poll()
+{
+    _dedup.sweep(millis());
+    _radio->txPending(); // Moves forwarded packets on, eg after a listen before talk backoff
+    uint8_t len = sizeof(_buf);
+    if (!_radio->recv(_buf, &len))
+        return false;
+    if (!handle(_buf, len))
+        return false;
+    if (_drift) {
+        // Keyed by the last hop, the neighbour this copy came from
+        _drift->heard(_packet.lastHop().hash(), _radio->lastFei());
+    }
+    return true;
+}
+
+boolean UKHASnetRepeater::handle(const uint8_t* buf, uint8_t len)
+{
+    if (!_packet.parse(buf, len)) {
+        _malformed++;
+        return false;
+    }
+    _received++;
+
+    // Our own packets, and ones we have forwarded, come back with us in the path
+    if (_packet.pathContains(_nodeId))
+        return true;
+    // Only remembered if it is forwarded, a copy with hops left may follow one without
+    if (_dedup.seen(_packet.origin(), _packet.sequence(), millis(), _packet.repeat() > 0)) {
+        _duplicates++;
+        return true;
+    }
+    if (_packet.repeat() > 0) {
+        if (forward())
+            _forwarded++;
+        else
+            _dropped++;
+    }
+    return true;
+}
+
+// Queues the current packet with one fewer hop and this node added to the path
+boolean UKHASnetRepeater::forward()
+{
+    const UKHASnetView& last = _packet.lastHop();
+    const uint8_t* src = (const uint8_t*)_packet.data().ptr - 2;
+    uint8_t keep = (const uint8_t*)last.ptr + last.len - src; // Up to the closing ']'
+    uint16_t len = keep + 1 + _nodeIdLen + 1;
+    if (len > RFM69_MAX_MESSAGE_LEN)
+        return false;
+
+    // Straight from the received packet into the transmit queue
+    uint8_t repeat = src[0] - 1;
+    const RFM69Segment segments[] = {
+        { &repeat, 1 },
+        { src + 1, (uint8_t)(keep - 1) },
+        { (const uint8_t*)",", 1 },
+        { (const uint8_t*)_nodeId, _nodeIdLen },
+        { (const uint8_t*)"]", 1 },
+    };
+    return _radio->sendv(segments, sizeof(segments) / sizeof(segments[0]));
+}
@@ -0,0 +1,131 @@
+// UKHASnetRepeater.h
+//
+// Copyright (C) 2026 the UKHASnet_rfm69 contributors
+//
+// Forwarding engine for a UKHASnet repeater. Each packet received through an
+// RFM69 is parsed, and unless it has run out of hops, already passed through
+// this node or was forwarded recently, it is queued for sending again with the
+// repeat count decremented and this node appended to the path.
+//
+// Recently forwarded (origin, sequence) pairs are kept in a fixed size open addressed
+// hash table. A lookup or insert probes at most UKHASNET_DEDUP_PROBES slots, so
+// both are O(1) however full the table is, and entries simply expire after
+// UKHASNET_DEDUP_EXPIRY milliseconds.
+
+#ifndef UKHASnetRepeater_h
+#define UKHASnetRepeater_h
+
+#include "UKHASnet_rfm69.h"
+#include "UKHASnetPacket.h"
+#include "RFM69Drift.h"
+
+// Number of (origin, sequence) pairs remembered. Must be a power of 2.
+// Each entry costs 6 bytes of SRAM on AVR.
+#ifndef UKHASNET_DEDUP_SIZE
+#if defined(__AVR__)
+#define UKHASNET_DEDUP_SIZE     32
+#else
+#define UKHASNET_DEDUP_SIZE     256
+#endif
+#endif
+
+// Slots looked at from a key's home slot before giving up (lookup) or evicting the oldest (insert)
+#ifndef UKHASNET_DEDUP_PROBES
+#define UKHASNET_DEDUP_PROBES   8
+#endif
+
+// Milliseconds a forwarded packet is remembered. Must be well under the time a node
+// takes to get through all 26 sequence letters.
+#ifndef UKHASNET_DEDUP_EXPIRY
+#define UKHASNET_DEDUP_EXPIRY   60000UL
+#endif
+
+// Longest node ID
+#define UKHASNET_MAX_NODE_LEN   16
+
+/// Fixed size table of recently seen (origin, sequence) pairs
+class UKHASnetDedup
+{
+public:
+    UKHASnetDedup();
+
+    /// Forgets everything
+    void            clear();
+
+    /// Looks up a packet and remembers it.
+    /// \param[in] origin The node that sent the packet first
+    /// \param[in] sequence Its sequence letter
+    /// \param[in] now The current millis()
+    /// \param[in] remember false to only look it up, leaving the table as it is
+    /// \return true if it was already there and not expired
+    boolean         seen(const UKHASnetView& origin, char sequence, uint32_t now, boolean remember = true);
+
+    /// Expires a few entries. Call regularly so that old entries are gone long before
+    /// their 16 bit timestamps can wrap round and make them look recent again.
+    void            sweep(uint32_t now);
+
+private:
+    struct Entry
+    {
+        uint32_t    key;    // 0 for an empty slot
+        uint16_t    seen;   // millis() / 1024
+    };
+
+    boolean         expired(const Entry& entry, uint16_t now) const;
+
+    Entry           _entries[UKHASNET_DEDUP_SIZE];
+    uint8_t         _sweep;
+};
+
+class UKHASnetRepeater
+{
+public:
+    /// \param[in] radio The radio to receive and forward with. init() it first.
+    /// \param[in] nodeId This node's ID, as added to the path of forwarded packets.
+    /// Up to UKHASNET_MAX_NODE_LEN characters, copied.
+    UKHASnetRepeater(RFM69& radio, const char* nodeId);
+
+    /// Takes the next received message, if any, and forwards it if it should be.
+    /// Call it from the main loop, it also keeps the transmit queue moving.
+    /// \return true if a valid UKHASnet packet was received, see packet()
+    boolean         poll();
+
+    /// \return The packet from the last successful poll(). Valid until poll() is called again.
+    const UKHASnetPacket& packet() const { return _packet; }
+
+    /// Processes one received message as poll() does, for messages obtained some other way
+    /// \return true if it was a valid UKHASnet packet
+    boolean         handle(const uint8_t* buf, uint8_t len);
+
+    /// Has poll() pass the frequency offset of every valid packet to a drift tracker, against
+    /// the packet's last hop, so the radio stays tuned to its neighbours. Turn the radio's
+    /// AFC on as well, see RFM69::setAfc().
+    /// \param[in] tracker The tracker, or NULL to stop
+    void            setDriftTracker(RFM69DriftTracker* tracker) { _drift = tracker; }
+
+    uint16_t        received() const { return _received; }     ///< Valid packets received
+    uint16_t        forwarded() const { return _forwarded; }   ///< Packets queued to send again
+    uint16_t        duplicates() const { return _duplicates; } ///< Dropped as recently forwarded
+    uint16_t        malformed() const { return _malformed; }   ///< Messages that did not parse
+    uint16_t        dropped() const { return _dropped; }       ///< Too long, or no room to send
+
+private:
+    boolean         forward();
+
+    RFM69*          _radio;
+    char            _nodeId[UKHASNET_MAX_NODE_LEN + 1];
+    uint8_t         _nodeIdLen;
+    UKHASnetDedup   _dedup;
+    RFM69DriftTracker* _drift;
+
+    uint8_t         _buf[RFM69_MAX_MESSAGE_LEN];
+    UKHASnetPacket  _packet;
+
+    uint16_t        _received;
+    uint16_t        _forwarded;
+    uint16_t        _duplicates;
+    uint16_t        _malformed;
+    uint16_t        _dropped;
+};
+
+#endif
@@ -1,249 +1,1393 @@
-// RFM69.cpp
-//
-// Copyright (C) 2014 Phil Crump
-//
-// Based on RF22 Copyright (C) 2011 Mike McCauley ported to mbed by Karl Zweimueller
-// Based on RFM69 LowPowerLabs (https://github.com/LowPowerLab/RFM69/)
-
-
-#include <SPI.h>
-#include "UKHASnet_rfm69.h"
-#include "RFM69Config.h"
-
-RFM69::RFM69()
-{
-    _idleMode = RFM69_MODE_SLEEP; // Default idle state is SLEEP, our lowest power mode
-    _mode = RFM69_MODE_RX; // We start up in RX mode
-    _rxGood = 0;
-    _rxBad = 0;
-    _txGood = 0;
-    _afterTxMode = RFM69_MODE_RX;
-}
-
-boolean RFM69::init()
-{
-    delay(12);
-    _slaveSelectPin = 10;
-    pinMode(_slaveSelectPin, OUTPUT); // Init nSS
-
-    delay(100);
-
-    SPI.setDataMode(SPI_MODE0);
-    SPI.setBitOrder(MSBFIRST);
-    SPI.setClockDivider(SPI_CLOCK_DIV2);
-    SPI.begin();
-    
-    // Set up device
-    for (uint8_t i = 0; CONFIG[i][0] != 255; i++)
-        spiWrite(CONFIG[i][0], CONFIG[i][1]);
-    
-    setMode(_mode);
-
-    // We should check for a device here, maybe set and check mode?
-    
-    //_interrupt.rise(this, &RFM69::isr0);
-    //attachInterrupt(0, RFM69::handleInterrupt, RISING);
-
-    clearTxBuf();
-    clearRxBuf();
-
-    return true;
-}
-
-void RFM69::handleInterrupt()
-{
-    // RX
-    if(_mode == RFM69_MODE_RX) {
-        //_lastRssi = rssiRead();
-        // PAYLOADREADY (incoming packet)
-        if(spiRead(RFM69_REG_28_IRQ_FLAGS2) & RF_IRQFLAGS2_PAYLOADREADY) {
-            _bufLen = spiRead(RFM69_REG_00_FIFO)+1;
-            spiBurstRead(RFM69_REG_00_FIFO, _buf, RFM69_FIFO_SIZE); // Read out full fifo
-            _rxGood++;
-            _rxBufValid = true;
-        }
-    // TX
-    } else if(_mode == RFM69_MODE_TX) {
-    
-        // PacketSent
-        if(spiRead(RFM69_REG_28_IRQ_FLAGS2) & RF_IRQFLAGS2_PACKETSENT) {
-            _txGood++;
-            spiWrite(RFM69_REG_25_DIO_MAPPING1, RF_DIOMAPPING1_DIO0_01);
-            setMode(_afterTxMode);
-            _txPacketSent = true;
-        }
-    }
-}
-
-void RFM69::isr0()
-{
-    handleInterrupt ();
-}
-
-uint8_t RFM69::spiRead(uint8_t reg)
-{
-    noInterrupts();    // Disable Interrupts
-    digitalWrite(_slaveSelectPin, LOW);
-    
-    SPI.transfer(reg & ~RFM69_SPI_WRITE_MASK); // Send the address with the write mask off
-    uint8_t val = SPI.transfer(0); // The written value is ignored, reg value is read
-    
-    digitalWrite(_slaveSelectPin, HIGH);
-    interrupts();     // Enable Interrupts
-    return val;
-}
-
-void RFM69::spiWrite(uint8_t reg, uint8_t val)
-{
-    noInterrupts();    // Disable Interrupts
-    digitalWrite(_slaveSelectPin, LOW);
-    
-    SPI.transfer(reg | RFM69_SPI_WRITE_MASK); // Send the address with the write mask on
-    SPI.transfer(val); // New value follows
-
-    digitalWrite(_slaveSelectPin, HIGH);
-    interrupts();     // Enable Interrupts
-}
-
-void RFM69::spiBurstRead(uint8_t reg, uint8_t* dest, uint8_t len)
-{
-    digitalWrite(_slaveSelectPin, LOW);
-    
-    SPI.transfer(reg & ~RFM69_SPI_WRITE_MASK); // Send the start address with the write mask off
-    while (len--)
-        *dest++ = SPI.transfer(0);
-
-    digitalWrite(_slaveSelectPin, HIGH);
-}
-
-void RFM69::spiBurstWrite(uint8_t reg, const uint8_t* src, uint8_t len)
-{
-    digitalWrite(_slaveSelectPin, LOW);
-    
-    SPI.transfer(reg | RFM69_SPI_WRITE_MASK); // Send the start address with the write mask on
-    while (len--)
-        SPI.transfer(*src++);
-        
-    digitalWrite(_slaveSelectPin, HIGH);
-}
-
-int RFM69::rssiRead()
-{
-    int rssi = 0;
-    //RSSI trigger not needed if DAGC is in continuous mode
-    rssi = -spiRead(RFM69_REG_24_RSSI_VALUE);
-    rssi >>= 1;
-    return rssi;
-}
-
-void RFM69::setMode(uint8_t newMode)
-{
-    spiWrite(RFM69_REG_01_OPMODE, (spiRead(RFM69_REG_01_OPMODE) & 0xE3) | newMode);
-	_mode = newMode;
-}
-void RFM69::setModeSleep()
-{
-    setMode(RFM69_MODE_SLEEP);
-}
-void RFM69::setModeRx()
-{
-    setMode(RFM69_MODE_RX);
-}
-void RFM69::setModeTx()
-{
-    setMode(RFM69_MODE_TX);
-}
-uint8_t  RFM69::mode()
-{
-    return _mode;
-}
-
-void RFM69::clearRxBuf()
-{
-    noInterrupts();   // Disable Interrupts
-    _bufLen = 0;
-    _rxBufValid = false;
-    interrupts();     // Enable Interrupts
-}
-
-boolean RFM69::available()
-{
-    return _rxBufValid;
-}
-
-boolean RFM69::recv(uint8_t* buf, uint8_t* len)
-{
-    if (!available())
-        return false;
-    noInterrupts();   // Disable Interrupts
-    if (*len > _bufLen)
-        *len = _bufLen;
-    memcpy(buf, _buf, *len);
-    clearRxBuf();
-    interrupts();     // Enable Interrupts
-    return true;
-}
-
-void RFM69::clearTxBuf()
-{
-    noInterrupts();   // Disable Interrupts
-    _bufLen = 0;
-    _txBufSentIndex = 0;
-    _txPacketSent = false;
-    interrupts();     // Enable Interrupts
-}
-
-void RFM69::startTransmit()
-{
-    //sendNextFragment(); // Actually the first fragment
-    setModeTx(); // Start the transmitter, turns off the receiver
-    sendTxBuf();
-}
-
-boolean RFM69::send(const uint8_t* data, uint8_t len)
-{
-    clearTxBuf();
-//    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
-    {
-        if (!fillTxBuf(data, len))
-            return false;
-        startTransmit();
-    }
-    spiWrite(RFM69_REG_25_DIO_MAPPING1, RF_DIOMAPPING1_DIO0_00);
-    return true;
-}
-
-boolean RFM69::fillTxBuf(const uint8_t* data, uint8_t len)
-{
-    if (((uint16_t)_bufLen + len) > RFM69_MAX_MESSAGE_LEN)
-        return false;
-    noInterrupts();   // Disable Interrupts
-    memcpy(_buf + _bufLen, data, len);
-    _bufLen += len;
-    interrupts();     // Enable Interrupts
-    return true;
-}
-
-void RFM69::sendTxBuf() {
-    if(_bufLen<RFM69_FIFO_SIZE) {
-        uint8_t* src = _buf;
-        uint8_t len = _bufLen;
-        digitalWrite(_slaveSelectPin, LOW);
-	    SPI.transfer(RFM69_REG_00_FIFO | RFM69_SPI_WRITE_MASK); // Send the start address with the write mask on
-	    SPI.transfer(len);
-    	while (len--)
-        	SPI.transfer(*src++);
-	    digitalWrite(_slaveSelectPin, HIGH);
-    }
-}
-
-void RFM69::readRxBuf()
-{
-    spiBurstRead(RFM69_REG_00_FIFO, _buf, RFM69_FIFO_SIZE);
-    _bufLen += RFM69_FIFO_SIZE;
-}
-
-int RFM69::lastRssi()
-{
-    return _lastRssi;
-}
+// RFM69.cpp
+//
+// Copyright (C) 2014 Phil Crump
+//
+// Based on RF22 Copyright (C) 2011 Mike McCauley ported to mbed by Karl Zweimueller
+// Based on RFM69 LowPowerLabs (https://github.com/LowPowerLab/RFM69/)
+
+
+#include "UKHASnet_rfm69.h"
+#include "RFM69Config.h"
+
+// One bit per register below RFM69_SHADOW_SIZE, set if the register only changes when
+// we write it and so can be held in the shadow cache. Clear for the FIFO, OSC1, LOWBAT,
+// VERSION, AFC/FEI, RSSI, IRQ flags and TEMP registers.
+/*PROGMEM */ static const uint8_t SHADOWABLE[RFM69_SHADOW_SIZE / 8] =
+{
+    0xFE, // 0x00-0x07
+    0xEB, // 0x08-0x0F
+    0xFE, // 0x10-0x17
+    0x3F, // 0x18-0x1F
+    0x60, // 0x20-0x27
+    0xFE, // 0x28-0x2F
+    0xFF, // 0x30-0x37
+    0xFF, // 0x38-0x3F
+    0xFF, // 0x40-0x47
+    0x3F, // 0x48-0x4F
+};
+
+#define SHADOW_BIT(map, reg) ((map)[(reg) >> 3] & (1 << ((reg) & 7)))
+
+// Why the message at the tail of the transmit queue is claimed but not started
+#define TX_WAIT_NONE    0
+#define TX_WAIT_LBT     1   // Backing off before sampling the channel
+#define TX_WAIT_DUTY    2   // Until the duty cycle budget has room for it
+
+// housekeeping() states
+#define HK_IDLE         0
+#define HK_WAKING       1   // In STDBY, waiting for ModeReady
+#define HK_MEASURING    2   // Waiting for TempMeasRunning to clear
+
+// Listen mode timer resolutions in microseconds, indexed by the 2 bit RegListen1 field
+static const uint32_t LISTEN_RESOL_US[4] = { 0, 64, 4100, 262000 };
+
+#if defined(ARDUINO)
+// Instances that init() has attached to each external interrupt, for DIO0 or DIO1
+static RFM69* interruptDevice[RFM69_NUM_INTERRUPTS];
+
+static void interrupt0() { interruptDevice[0]->isr0(); }
+static void interrupt1() { interruptDevice[1]->isr0(); }
+static void interrupt2() { interruptDevice[2]->isr0(); }
+
+static void interrupt0Dio1() { interruptDevice[0]->isr1(); }
+static void interrupt1Dio1() { interruptDevice[1]->isr1(); }
+static void interrupt2Dio1() { interruptDevice[2]->isr1(); }
+
+static void (* const interruptHandler[RFM69_NUM_INTERRUPTS])() = { interrupt0, interrupt1, interrupt2 };
+static void (* const interruptHandlerDio1[RFM69_NUM_INTERRUPTS])() =
+    { interrupt0Dio1, interrupt1Dio1, interrupt2Dio1 };
+
+RFM69::RFM69(uint8_t interrupt, uint8_t slaveSelectPin, uint8_t interruptDio1)
+    : _defaultTransport(slaveSelectPin)
+{
+    _transport = &_defaultTransport; // Hardware SPI
+    _interrupt = interrupt;
+    _interruptDio1 = interruptDio1;
+    construct();
+}
+#endif
+
+RFM69::RFM69(RFM69Transport& transport, uint8_t interrupt, uint8_t interruptDio1)
+{
+    _transport = &transport;
+    _interrupt = interrupt;
+    _interruptDio1 = interruptDio1;
+    construct();
+}
+
+void RFM69::construct()
+{
+    _idleMode = RFM69_MODE_SLEEP; // Default idle state is SLEEP, our lowest power mode
+    _mode = RFM69_MODE_RX; // We start up in RX mode
+    _listen = false;
+    _irqPending = false;
+    _inService = false;
+    _irqFlags1 = 0;
+    _irqFlags2 = 0;
+    _irqRssi = 0;
+    _irqAt = 0;
+    _dio0Sync = false;
+    _syncRssi = 0;
+    _syncRssiValid = false;
+    _noiseFloor = 0;
+    _noiseValid = false;
+    _noiseAt = 0;
+    _hkState = HK_IDLE;
+    _hkInterval = 0;
+    _hkAt = 0;
+    _hkStartedAt = 0;
+    _hkResume = RFM69_MODE_STDBY;
+    _hkWaiting = false;
+    _hkTrim = RF_LOWBAT_TRIM_1835;
+    _hkLowTrim = RF_LOWBAT_TRIM_1835;
+    _hkSupply = 0xFF;
+    _temperature = RFM69_TEMP_UNKNOWN;
+    clearStats();
+    _rxHead = 0;
+    _rxTail = 0;
+    _lastRssi = 0;
+    _lastTimestamp = 0;
+    _lastFei = 0;
+    _txHead = 0;
+    _txTail = 0;
+    _txBusy = false;
+    _txStartedAt = 0;
+    _txRetries = 0;
+    _lbt = false;
+    _lbtThreshold = 0;
+    _aes = false;
+    _afc = false;
+    _frfTrim = 0;
+    _addressHost = false;
+    _nodeAddress = 0;
+    _broadcastAddress = -1;
+    _txWait = TX_WAIT_NONE;
+    _txWaitUntil = 0;
+    _lbtTries = 0;
+    _lbtSeed = 1;
+    _txComposing = false;
+    _txComposeFailed = false;
+    setDutyCycle(0);
+    _txBufSentIndex = 0;
+    resetRxStream();
+    _afterTxMode = RFM69_MODE_RX;
+}
+
+boolean RFM69::init()
+{
+    delay(RFM69_POWER_ON_DELAY);
+
+    _transport->begin();
+    _modeSince = micros(); // The clock may not have been running at construction
+    _lbtSeed ^= (uint16_t)_modeSince; // channelClear() stirs in RSSI noise as well
+
+    // Nothing is known about the radio's registers yet
+    memset(_shadowValid, 0, sizeof(_shadowValid));
+    memset(_shadowDirty, 0, sizeof(_shadowDirty));
+    
+    // Set up device, one burst per run of registers
+    for (const uint8_t* run = CONFIG_RUNS; run[0] != 255; run += 2 + run[1])
+        spiBurstWrite(run[0], run + 2, run[1]);
+    _dio0Sync = true; // CONFIG_RUNS puts SYNCADDRESS on DIO0
+    static const RFM69Channel configChannel =
+        { { UKHASNET_SETTINGS::FRF_MSB, UKHASNET_SETTINGS::FRF_MID, UKHASNET_SETTINGS::FRF_LSB } };
+    setChannel(configChannel); // Puts back any trim
+    
+    setMode(_mode);
+
+    // We should check for a device here, maybe set and check mode?
+
+    clearTxBuf();
+    clearRxBuf();
+
+#if defined(ARDUINO)
+    if (_interrupt < RFM69_NUM_INTERRUPTS) {
+        interruptDevice[_interrupt] = this;
+        attachInterrupt(_interrupt, interruptHandler[_interrupt], RISING);
+    }
+    if (_interruptDio1 < RFM69_NUM_INTERRUPTS && _interruptDio1 != _interrupt) {
+        // FIFOLEVEL, both edges, so that messages longer than the FIFO stream through it
+        interruptDevice[_interruptDio1] = this;
+        attachInterrupt(_interruptDio1, interruptHandlerDio1[_interruptDio1], CHANGE);
+    }
+#endif
+
+    return true;
+}
+
+void RFM69::handleInterrupt()
+{
+    // RX, or a receive window in Listen mode
+    if(_mode == RFM69_MODE_RX || _listen) {
+        uint8_t flags = _irqFlags2;
+        _stats.rxWakeups++;
+
+        if (flags & RF_IRQFLAGS2_FIFOOVERRUN) {
+            // We fell behind, the message is lost. Writing the flag clears it and the FIFO.
+            spiWrite(RFM69_REG_28_IRQ_FLAGS2, RF_IRQFLAGS2_FIFOOVERRUN);
+            resetRxStream();
+            mapDio0(RF_DIOMAPPING1_DIO0_10);
+            regFlush();
+            _stats.rxBad++;
+            return;
+        }
+
+        if (_rxStreaming && (uint32_t)(millis() - _rxStreamAt) > RFM69_RX_STREAM_TIMEOUT)
+            resetRxStream(); // The radio gave up on it
+
+        // SYNCADDRESSMATCH (a packet has started). RegRssiValue, latched alongside the
+        // flags, holds the packet's own signal strength now, but not by PAYLOADREADY.
+        if (_dio0Sync && (_irqFlags1 & RF_IRQFLAGS1_SYNCADDRESSMATCH)) {
+            _syncRssi = _irqRssi;
+            _syncRssiValid = true;
+            mapDio0(RF_DIOMAPPING1_DIO0_01);
+            regFlush();
+        }
+
+        // PAYLOADREADY (incoming packet)
+        if(flags & RF_IRQFLAGS2_PAYLOADREADY) {
+            // The sync is missed if it is on DIO0 already (or DIO0 never signalled it, as
+            // in Listen mode), so use what was just latched
+            int8_t rssi = !_dio0Sync && _syncRssiValid ? _syncRssi : _irqRssi;
+            _syncRssiValid = false;
+            if (!_dio0Sync)
+                mapDio0(RF_DIOMAPPING1_DIO0_10); // Ready for the next one
+            regFlush();
+            // The AFC ran at the start of this packet, and the radio clears its value at
+            // the start of the next one
+            int16_t fei = 0;
+            if (_afc) {
+                uint8_t afc[2];
+                spiBurstRead(RFM69_REG_1F_AFC_MSB, afc, 2);
+                fei = (int16_t)(((uint16_t)afc[0] << 8) | afc[1]);
+            }
+            if (!_rxStreaming) {
+                uint8_t head = _rxHead;
+                if ((uint8_t)(head - _rxTail) == RFM69_RX_QUEUE_LEN) {
+                    // Queue full, drain the FIFO so the receiver can carry on
+                    spiBurstRead(RFM69_REG_00_FIFO, NULL, RFM69_FIFO_SIZE);
+                    _stats.rxOverflows++;
+                    return;
+                }
+                RxSlot* slot = &_rxQueue[head & (RFM69_RX_QUEUE_LEN - 1)];
+                slot->len = spiRead(RFM69_REG_00_FIFO);
+#if RFM69_MAX_MESSAGE_LEN < 255
+                if (slot->len > RFM69_MAX_MESSAGE_LEN)
+                    slot->len = RFM69_MAX_MESSAGE_LEN;
+#endif
+                spiBurstRead(RFM69_REG_00_FIFO, slot->data, slot->len); // Only what was sent
+            } else {
+                // The rest of a streamed message is all in the FIFO now
+                readRxBuf(_rxStreamLen - _rxStreamPos);
+                _rxStreaming = false;
+                if (_rxStreamDiscard) {
+                    _stats.rxOverflows++;
+                    return;
+                }
+            }
+            if (!(flags & RF_IRQFLAGS2_CRCOK)) {
+                // Drained but not published, so the slot is reused
+                _stats.rxCrcErrors++;
+                _stats.rxBad++;
+                return;
+            }
+            RxSlot* slot = &_rxQueue[_rxHead & (RFM69_RX_QUEUE_LEN - 1)];
+            if (_addressHost && (slot->len == 0
+                                 || (slot->data[0] != _nodeAddress && slot->data[0] != _broadcastAddress))) {
+                _stats.rxForeign++;
+                return;
+            }
+            slot->rssi = rssi;
+            slot->fei = fei;
+            slot->timestamp = _irqAt;
+            int8_t bin = (slot->rssi + 120) / 10;
+            _stats.rssi[bin < 0 ? 0 : bin >= RFM69_STATS_RSSI_BINS ? RFM69_STATS_RSSI_BINS - 1 : bin]++;
+            _stats.rxGood++;
+            RFM69_BARRIER(); // Slot contents must be complete before it is published
+            _rxHead = _rxHead + 1;
+            if (_listen)
+                setMode(RFM69_LISTEN_WAKE_MODE); // Woken up, stay awake for what follows
+
+        // FIFOLEVEL (a message longer than the threshold is arriving). With AES the FIFO
+        // only holds the message once it has been decrypted, at PAYLOADREADY.
+        } else if ((flags & RF_IRQFLAGS2_FIFOLEVEL) && !_aes) {
+            // More than RF_FIFOTHRESH_VALUE bytes are waiting, take that many
+            uint8_t len = RF_FIFOTHRESH_VALUE;
+            if (!_rxStreaming) {
+                uint8_t head = _rxHead;
+                _rxStreaming = true;
+                _rxStreamDiscard = (uint8_t)(head - _rxTail) == RFM69_RX_QUEUE_LEN;
+                _rxStreamLen = spiRead(RFM69_REG_00_FIFO);
+                _rxStreamPos = 0;
+                if (!_rxStreamDiscard)
+                    _rxQueue[head & (RFM69_RX_QUEUE_LEN - 1)].len = _rxStreamLen;
+                len--;
+            }
+            if (len > _rxStreamLen - _rxStreamPos)
+                len = _rxStreamLen - _rxStreamPos;
+            readRxBuf(len);
+        }
+    // TX
+    } else if(_mode == RFM69_MODE_TX) {
+        uint8_t flags = _irqFlags2;
+    
+        // PacketSent
+        if(flags & RF_IRQFLAGS2_PACKETSENT) {
+            _stats.txGood++;
+            uint32_t latency = _irqAt - _txStartedAt;
+            uint8_t bin = 0;
+            while (bin < RFM69_STATS_LATENCY_BINS - 1 && latency >= (1UL << bin))
+                bin++;
+            _stats.txLatency[bin]++;
+            _txTail++;
+            if (_txHead != _txTail && (_lbt || _dutyPermille)) {
+                // More queued, but it may have to wait for the channel or the duty cycle
+                tryTransmit();
+            } else if (_txHead != _txTail) {
+                // More queued, go straight on to the next one. PACKETSENT is only cleared by
+                // leaving TX, so pass through STDBY rather than back to _afterTxMode.
+                setMode(RFM69_MODE_STDBY);
+                _txBufSentIndex = 0;
+                _txStartedAt = millis();
+                _txRetries = 0;
+                sendTxBuf();
+                setModeTx();
+            } else {
+                mapDio0(RF_DIOMAPPING1_DIO0_10);
+                setMode(_afterTxMode);
+                _txPacketSent = true;
+                _txBusy = false;
+            }
+
+        // FIFOLEVEL clear, there is room for more of a long message
+        } else if (!(flags & RF_IRQFLAGS2_FIFOLEVEL)) {
+            sendTxBuf();
+        }
+    }
+}
+
+void RFM69::latchInterrupt()
+{
+    // RegRssiValue, the two DIO mapping registers, then the flags
+    uint8_t regs[5];
+    spiBurstRead(RFM69_REG_24_RSSI_VALUE, regs, 5);
+    _irqRssi = -(regs[0] >> 1);
+    _irqFlags1 = regs[3];
+    _irqFlags2 = regs[4];
+    _irqAt = millis();
+    _irqPending = true;
+}
+
+void RFM69::isr0()
+{
+    latchInterrupt();
+#if !defined(RFM69_DEFER_BOTTOM_HALF)
+    service();
+#endif
+}
+
+void RFM69::isr1()
+{
+    latchInterrupt();
+#if !defined(RFM69_DEFER_BOTTOM_HALF)
+    service();
+#endif
+}
+
+void RFM69::service()
+{
+    noInterrupts();
+    if (_inService || !_irqPending) {
+        // Nested in the bottom half, which will pick up the new flags when it loops
+        interrupts();
+        return;
+    }
+    _inService = true;
+    interrupts();     // Only the top half needs to hold off other interrupts
+
+    while (_irqPending) {
+        _irqPending = false;
+        handleInterrupt();
+    }
+    _inService = false;
+}
+
+uint8_t RFM69::spiRead(uint8_t reg)
+{
+    uint8_t addr = reg & ~RFM69_SPI_WRITE_MASK; // Send the address with the write mask off
+    uint8_t val;
+
+    noInterrupts();    // Disable Interrupts
+    _transport->select();
+    _transport->transfer(&addr, NULL, 1);
+    _transport->transfer(NULL, &val, 1); // The written value is ignored, reg value is read
+    _transport->deselect();
+    busUsed(2);
+    interrupts();     // Enable Interrupts
+    return val;
+}
+
+void RFM69::spiWrite(uint8_t reg, uint8_t val)
+{
+    uint8_t frame[2];
+    frame[0] = reg | RFM69_SPI_WRITE_MASK; // Send the address with the write mask on
+    frame[1] = val; // New value follows
+
+    noInterrupts();    // Disable Interrupts
+    _transport->select();
+    _transport->transfer(frame, NULL, 2);
+    _transport->deselect();
+    busUsed(2);
+    shadowUpdate(reg, &val, 1);
+    interrupts();     // Enable Interrupts
+}
+
+void RFM69::spiBurstRead(uint8_t reg, uint8_t* dest, uint8_t len)
+{
+    uint8_t addr = reg & ~RFM69_SPI_WRITE_MASK; // Send the start address with the write mask off
+
+    noInterrupts();    // The top half may use the bus from an interrupt
+    _transport->select();
+    _transport->transfer(&addr, NULL, 1);
+    _transport->transfer(NULL, dest, len);
+    _transport->deselect();
+    busUsed(1 + len);
+    interrupts();     // Enable Interrupts
+}
+
+void RFM69::spiBurstWrite(uint8_t reg, const uint8_t* src, uint8_t len)
+{
+    uint8_t addr = reg | RFM69_SPI_WRITE_MASK; // Send the start address with the write mask on
+
+    noInterrupts();    // The top half may use the bus from an interrupt
+    _transport->select();
+    _transport->transfer(&addr, NULL, 1);
+    _transport->transfer(src, NULL, len);
+    _transport->deselect();
+    busUsed(1 + len);
+    shadowUpdate(reg, src, len);
+    interrupts();     // Enable Interrupts
+}
+
+// Keeps the shadow in step with registers written behind its back
+void RFM69::shadowUpdate(uint8_t reg, const uint8_t* src, uint8_t len)
+{
+    if (reg == RFM69_REG_00_FIFO)
+        return; // FIFO bursts do not auto-increment
+    for (; len && reg < RFM69_SHADOW_SIZE; len--, reg++, src++) {
+        if (!SHADOW_BIT(SHADOWABLE, reg))
+            continue;
+        _shadow[reg] = shadowValue(reg, *src);
+        _shadowValid[reg >> 3] |= 1 << (reg & 7);
+        _shadowDirty[reg >> 3] &= ~(1 << (reg & 7));
+    }
+}
+
+// Strips write-only trigger bits, so rewriting a shadowed value never re-triggers them
+uint8_t RFM69::shadowValue(uint8_t reg, uint8_t val)
+{
+    if (reg == RFM69_REG_01_OPMODE)
+        return val & ~RF_OPMODE_LISTENABORT;
+    if (reg == RFM69_REG_3D_PACKET_CONFIG2)
+        return val & ~RF_PACKET2_RXRESTART;
+    return val;
+}
+
+uint8_t RFM69::regRead(uint8_t reg)
+{
+    if (reg >= RFM69_SHADOW_SIZE || !SHADOW_BIT(SHADOWABLE, reg))
+        return spiRead(reg);
+    if (!SHADOW_BIT(_shadowValid, reg)) {
+        _shadow[reg] = spiRead(reg);
+        _shadowValid[reg >> 3] |= 1 << (reg & 7);
+    }
+    return _shadow[reg];
+}
+
+void RFM69::regWrite(uint8_t reg, uint8_t val)
+{
+    if (reg >= RFM69_SHADOW_SIZE || !SHADOW_BIT(SHADOWABLE, reg)) {
+        spiWrite(reg, val);
+        return;
+    }
+    noInterrupts();    // Disable Interrupts
+    if (!SHADOW_BIT(_shadowValid, reg) || _shadow[reg] != val || val != shadowValue(reg, val)) {
+        _shadow[reg] = val;
+        _shadowValid[reg >> 3] |= 1 << (reg & 7);
+        _shadowDirty[reg >> 3] |= 1 << (reg & 7);
+    }
+    interrupts();     // Enable Interrupts
+}
+
+void RFM69::regFlush()
+{
+    noInterrupts();    // Disable Interrupts
+    uint8_t reg = 0;
+    while (reg < RFM69_SHADOW_SIZE) {
+        if (!SHADOW_BIT(_shadowDirty, reg)) {
+            reg++;
+            continue;
+        }
+        // Extend the run over further dirty registers, bridging short gaps of known ones
+        uint8_t start = reg;
+        uint8_t end = reg + 1;
+        uint8_t scan = end;
+        while (scan < RFM69_SHADOW_SIZE) {
+            if (SHADOW_BIT(_shadowDirty, scan)) {
+                end = ++scan;
+                continue;
+            }
+            if (!SHADOW_BIT(_shadowValid, scan) || scan - end >= RFM69_SHADOW_MERGE_GAP)
+                break;
+            scan++;
+        }
+        uint8_t addr = start | RFM69_SPI_WRITE_MASK;
+        _transport->select();
+        _transport->transfer(&addr, NULL, 1);
+        _transport->transfer(_shadow + start, NULL, end - start);
+        _transport->deselect();
+        busUsed(1 + end - start);
+        for (uint8_t r = start; r < end; r++) {
+            _shadowDirty[r >> 3] &= ~(1 << (r & 7));
+            _shadow[r] = shadowValue(r, _shadow[r]);
+        }
+        reg = end;
+    }
+    interrupts();     // Enable Interrupts
+}
+
+boolean RFM69::setFrequency(float centre, float afcPullInRange)
+{
+    if (centre <= 0 || afcPullInRange < 0)
+        return false;
+    uint32_t hz = (uint32_t)(centre * 1000000.0 + 0.5);
+    uint8_t afcBw = rfm69RxBwBits((uint32_t)(afcPullInRange * 1000000.0 + 0.5));
+    if (!rfm69FrfValid(hz) || afcBw == 0xFF)
+        return false;
+
+    regWrite(RFM69_REG_1A_AFC_BW, RF_AFCBW_DCCFREQAFC_100 | afcBw);
+    regFlush();
+    setChannel(rfm69Channel(hz));
+    return true;
+}
+
+void RFM69::setChannel(const RFM69Channel& channel)
+{
+    _channel = channel;
+    RFM69Channel tuned = channel;
+    if (_frfTrim) {
+        uint32_t frf = (((uint32_t)channel.frf[0] << 16) | ((uint32_t)channel.frf[1] << 8) | channel.frf[2])
+            + (int32_t)_frfTrim;
+        tuned.frf[0] = (uint8_t)(frf >> 16);
+        tuned.frf[1] = (uint8_t)(frf >> 8);
+        tuned.frf[2] = (uint8_t)frf;
+    }
+    if (regRead(RFM69_REG_07_FRF_MSB) == tuned.frf[0]
+        && regRead(RFM69_REG_08_FRF_MID) == tuned.frf[1]
+        && regRead(RFM69_REG_09_FRF_LSB) == tuned.frf[2])
+        return;
+    // The synthesiser retunes when the LSB is written, so all three go in one burst
+    spiBurstWrite(RFM69_REG_07_FRF_MSB, tuned.frf, 3);
+}
+
+void RFM69::setFrequencyTrim(int16_t steps)
+{
+    _frfTrim = steps;
+    setChannel(_channel);
+}
+
+void RFM69::setAfc(boolean on)
+{
+    // AfcAutoclear starts each packet's correction from zero, so the value read back is
+    // that packet's own offset
+    regWrite(RFM69_REG_1E_AFC_FEI, on ? RF_AFCFEI_AFCAUTO_ON | RF_AFCFEI_AFCAUTOCLEAR_ON
+                                      : RF_AFCFEI_AFCAUTO_OFF | RF_AFCFEI_AFCAUTOCLEAR_OFF);
+    regFlush();
+    noInterrupts();   // Keep the interrupt handler from reading half of it
+    _afc = on;
+    interrupts();     // Enable Interrupts
+}
+
+void RFM69::setTxPower(uint8_t power)
+{
+    if (power < RFM69_PA_DBM_MIN)
+        power = RFM69_PA_DBM_MIN;
+    if (power > RFM69_PA_DBM_MAX)
+        power = RFM69_PA_DBM_MAX;
+    regWrite(RFM69_REG_11_PA_LEVEL, rfm69PaLevelReg(power));
+    regFlush();
+}
+
+int RFM69::rssiRead()
+{
+    int rssi = 0;
+    //RSSI trigger not needed if DAGC is in continuous mode
+    rssi = -spiRead(RFM69_REG_24_RSSI_VALUE);
+    rssi >>= 1;
+    return rssi;
+}
+
+void RFM69::setMode(uint8_t newMode)
+{
+    dwell();
+    if (newMode != RFM69_MODE_RX || _listen)
+        resetRxStream(); // Leaving RX loses whatever was half received
+    uint8_t opmode = (regRead(RFM69_REG_01_OPMODE) & 0xE3) | newMode;
+    if (_listen) {
+        // Listen mode is left with two writes: ListenAbort with ListenOn clear, then
+        // the same without ListenAbort. Both carry the new mode.
+        opmode &= ~RF_OPMODE_LISTEN_ON;
+        spiWrite(RFM69_REG_01_OPMODE, opmode | RF_OPMODE_LISTENABORT);
+        spiWrite(RFM69_REG_01_OPMODE, opmode);
+        _listen = false;
+    } else {
+        regWrite(RFM69_REG_01_OPMODE, opmode);
+        regFlush();
+    }
+	_mode = newMode;
+}
+void RFM69::setModeSleep()
+{
+    setMode(RFM69_MODE_SLEEP);
+}
+void RFM69::setModeRx()
+{
+    setMode(RFM69_MODE_RX);
+}
+void RFM69::setModeTx()
+{
+    setMode(RFM69_MODE_TX);
+}
+// Picks the finest RegListen1 resolution that can express us with an 8 bit coefficient
+// \return The resolution as a 2 bit field, or 0 if us is out of range
+static uint8_t listenCoef(uint32_t us, uint8_t* coef)
+{
+    for (uint8_t resol = 1; resol < 4; resol++) {
+        uint32_t c = (us + LISTEN_RESOL_US[resol] / 2) / LISTEN_RESOL_US[resol];
+        if (c <= 255) {
+            *coef = c ? c : 1;
+            return resol;
+        }
+    }
+    return 0;
+}
+
+boolean RFM69::setListen(uint32_t idleUs, uint32_t rxUs, uint8_t criteria)
+{
+    uint8_t coefIdle, coefRx;
+    uint8_t resolIdle = listenCoef(idleUs, &coefIdle);
+    uint8_t resolRx = listenCoef(rxUs, &coefRx);
+    if (!resolIdle || !resolRx)
+        return false;
+
+    // Stay awake until PayloadReady, then go back to the duty cycle. The interrupt handler
+    // takes the radio out of Listen mode as soon as it has the packet anyway.
+    regWrite(RFM69_REG_0D_LISTEN1, (resolIdle << 6) | (resolRx << 4) | criteria | RF_LISTEN1_END_01);
+    regWrite(RFM69_REG_0E_LISTEN2, coefIdle);
+    regWrite(RFM69_REG_0F_LISTEN3, coefRx);
+    regFlush();
+    return true;
+}
+
+void RFM69::setModeListen()
+{
+    if (_listen)
+        return;
+    // ListenOn must be set from STDBY. The receive windows use the RX set up, with
+    // PAYLOADREADY on DIO0, so that a packet wakes the radio whatever the RSSI.
+    setMode(RFM69_MODE_STDBY);
+    mapDio0(RF_DIOMAPPING1_DIO0_01);
+    regWrite(RFM69_REG_01_OPMODE, regRead(RFM69_REG_01_OPMODE) | RF_OPMODE_LISTEN_ON);
+    regFlush();
+    dwell();
+    _listen = true;
+}
+
+boolean RFM69::listening()
+{
+    return _listen;
+}
+
+uint32_t RFM69::listenCurrent()
+{
+    uint8_t listen1 = regRead(RFM69_REG_0D_LISTEN1);
+    uint64_t idleUs = (uint64_t)LISTEN_RESOL_US[listen1 >> 6] * regRead(RFM69_REG_0E_LISTEN2);
+    uint64_t rxUs = (uint64_t)LISTEN_RESOL_US[(listen1 >> 4) & 0x03] * regRead(RFM69_REG_0F_LISTEN3);
+    if (idleUs + rxUs == 0)
+        return RFM69_CURRENT_IDLE;
+    return (uint32_t)((RFM69_CURRENT_IDLE * idleUs + RFM69_CURRENT_RX * rxUs) / (idleUs + rxUs));
+}
+
+uint8_t  RFM69::mode()
+{
+    return _mode;
+}
+
+void RFM69::clearRxBuf()
+{
+    noInterrupts();   // Disable Interrupts
+    _rxTail = _rxHead;
+    interrupts();     // Enable Interrupts
+}
+
+boolean RFM69::available()
+{
+    if (_mode == RFM69_MODE_RX && !_listen && (uint32_t)(millis() - _noiseAt) >= RFM69_NOISE_INTERVAL)
+        sampleNoise();
+    if (_hkInterval)
+        housekeeping();
+    return _rxHead != _rxTail;
+}
+
+// RF_LOWBAT_TRIM_* thresholds in mV
+/*PROGMEM */ static const uint16_t LOWBAT_MV[8] = { 1695, 1764, 1835, 1905, 1976, 2045, 2116, 2185 };
+
+void RFM69::setHousekeeping(uint32_t intervalMs, uint8_t lowBatTrim)
+{
+    _hkLowTrim = lowBatTrim & 0x07;
+    _hkInterval = intervalMs;
+    if (!intervalMs) {
+        if (_hkState != HK_IDLE)
+            setMode(_hkResume);
+        _hkState = HK_IDLE;
+        spiWrite(RFM69_REG_0C_LOWBAT, RF_LOWBAT_OFF | RF_LOWBAT_TRIM_1835);
+        return;
+    }
+    // First compare with the threshold asked for, so lowBattery() is right from the start
+    _hkTrim = _hkLowTrim;
+    _hkSupply = 0xFF;
+    spiWrite(RFM69_REG_0C_LOWBAT, RF_LOWBAT_ON | _hkTrim);
+    _hkAt = millis() - intervalMs; // Due now
+}
+
+void RFM69::housekeeping()
+{
+    if (_hkState == HK_IDLE) {
+        if (!_hkInterval || (uint32_t)(millis() - _hkAt) < _hkInterval)
+            return;
+        // Only in a gap: nothing being sent or waiting to be, no interrupt waiting to be
+        // handled, and in RX a quiet channel, as a packet in its preamble has no sync yet
+        if (_listen || _mode == RFM69_MODE_TX || _txHead != _txTail || _rxStreaming || _irqPending
+            || (_mode == RFM69_MODE_RX && !channelClear())) {
+            if (!_hkWaiting)
+                _stats.hkDeferred++;
+            _hkWaiting = true;
+            return;
+        }
+        _hkWaiting = false;
+        _hkResume = _mode;
+        _hkStartedAt = micros();
+        if (_mode != RFM69_MODE_STDBY)
+            setMode(RFM69_MODE_STDBY);
+        _hkState = HK_WAKING;
+    } else if (_mode != RFM69_MODE_STDBY) {
+        // Something was sent, or the mode changed, in between steps. Start again later.
+        _hkState = HK_IDLE;
+        return;
+    }
+
+    if (_hkState == HK_WAKING) {
+        // From SLEEP the oscillator takes a while to start
+        if (!(spiRead(RFM69_REG_27_IRQ_FLAGS1) & RF_IRQFLAGS1_MODEREADY))
+            return;
+        spiWrite(RFM69_REG_4E_TEMP1, RF_TEMP1_MEAS_START | RF_TEMP1_ADCLOWPOWER_ON);
+        _hkState = HK_MEASURING;
+        return; // Takes about 100us, come back for it
+    }
+
+    if (spiRead(RFM69_REG_4E_TEMP1) & RF_TEMP1_MEAS_RUNNING)
+        return;
+    _temperature = (int8_t)(RFM69_TEMP_OFFSET - (int)spiRead(RFM69_REG_4F_TEMP2));
+
+    // One comparison per reading: step the threshold up while the supply is above it, and
+    // down while below, so it ends up going back and forth across the supply
+    boolean below = spiRead(RFM69_REG_0C_LOWBAT) & RF_LOWBAT_MONITOR;
+    if (below) {
+        _hkSupply = _hkTrim;
+        if (_hkTrim > 0)
+            _hkTrim--;
+    } else {
+        _hkSupply = _hkTrim + 1;
+        if (_hkTrim < 7)
+            _hkTrim++;
+    }
+    spiWrite(RFM69_REG_0C_LOWBAT, RF_LOWBAT_ON | _hkTrim);
+
+    if (_hkResume == RFM69_MODE_RX)
+        mapDio0(RF_DIOMAPPING1_DIO0_10); // Back to waiting for a sync word
+    if (_hkResume != RFM69_MODE_STDBY)
+        setMode(_hkResume);
+    _stats.hkRxOffUs += _hkResume == RFM69_MODE_RX ? micros() - _hkStartedAt : 0;
+    _stats.hkReadings++;
+    _hkAt = millis();
+    _hkState = HK_IDLE;
+}
+
+int8_t RFM69::temperature()
+{
+    return _temperature;
+}
+
+uint16_t RFM69::supplyMv()
+{
+    return _hkSupply == 0xFF || _hkSupply == 0 ? 0 : LOWBAT_MV[_hkSupply - 1];
+}
+
+boolean RFM69::lowBattery()
+{
+    return _hkSupply != 0xFF && _hkSupply <= _hkLowTrim;
+}
+
+uint8_t RFM69::housekeepingFields(char* buf, uint8_t size)
+{
+    char out[12];
+    uint8_t len = 0;
+    if (_temperature != RFM69_TEMP_UNKNOWN) {
+        out[len++] = 'T';
+        int t = _temperature;
+        if (t < 0) {
+            out[len++] = '-';
+            t = -t;
+        }
+        if (t >= 100)
+            out[len++] = '0' + t / 100;
+        if (t >= 10)
+            out[len++] = '0' + t / 10 % 10;
+        out[len++] = '0' + t % 10;
+    }
+    if (_hkSupply != 0xFF && _hkSupply > 0 && _hkSupply < 8) {
+        uint16_t cv = (LOWBAT_MV[_hkSupply - 1] + 5) / 10; // 1.98V as 198
+        out[len++] = 'V';
+        out[len++] = '0' + cv / 100;
+        out[len++] = '.';
+        out[len++] = '0' + cv / 10 % 10;
+        out[len++] = '0' + cv % 10;
+    }
+    if (len == 0 || len >= size)
+        return 0;
+    memcpy(buf, out, len);
+    buf[len] = '\0';
+    return len;
+}
+
+void RFM69::sampleNoise()
+{
+    _noiseAt = millis();
+    if (_rxStreaming)
+        return;
+    uint8_t regs[4];
+    spiBurstRead(RFM69_REG_24_RSSI_VALUE, regs, 4);
+    if (regs[3] & RF_IRQFLAGS1_SYNCADDRESSMATCH)
+        return; // That is a packet, not the channel
+    int16_t sample = -(int16_t)regs[0] * 8; // 1/16 dB
+    if (!_noiseValid) {
+        _noiseFloor = sample;
+        _noiseValid = true;
+    } else if (sample < _noiseFloor) {
+        // Follow a quieter channel quickly, and a noisier one slowly, at most 1dB a
+        // sample, so that the preambles of packets and other short bursts barely lift it
+        _noiseFloor += (sample - _noiseFloor - 3) / 4;
+    } else {
+        int16_t step = (sample - _noiseFloor + 15) / 16;
+        _noiseFloor += step > 16 ? 16 : step;
+    }
+}
+
+int RFM69::noiseFloor()
+{
+    return _noiseValid ? (_noiseFloor - 8) / 16 : 0;
+}
+
+int RFM69::linkMargin()
+{
+    return _noiseValid ? _lastRssi - noiseFloor() : 0;
+}
+
+void RFM69::setRssiThreshold(int dbm)
+{
+    if (dbm > 0)
+        dbm = 0;
+    if (dbm < -127)
+        dbm = -127;
+    regWrite(RFM69_REG_29_RSSI_THRESHOLD, (uint8_t)(-dbm * 2));
+    regFlush();
+}
+
+void RFM69::mapDio0(uint8_t mapping)
+{
+    // DIO1 stays on FIFOLEVEL, mapping 00
+    regWrite(RFM69_REG_25_DIO_MAPPING1, mapping);
+    _dio0Sync = mapping == RF_DIOMAPPING1_DIO0_10;
+}
+
+boolean RFM69::recv(uint8_t* buf, uint8_t* len)
+{
+    const uint8_t* data;
+    uint8_t dataLen;
+    if (!recvLease(&data, &dataLen))
+        return false;
+    if (*len > dataLen)
+        *len = dataLen;
+    memcpy(buf, data, *len);
+    recvRelease();
+    return true;
+}
+
+boolean RFM69::recvLease(const uint8_t** buf, uint8_t* len)
+{
+    if (!available())
+        return false;
+    // No need to mask interrupts, the interrupt handler never touches the slot at _rxTail
+    RFM69_BARRIER(); // Do not read the slot before seeing it published
+    RxSlot* slot = &_rxQueue[_rxTail & (RFM69_RX_QUEUE_LEN - 1)];
+    *buf = slot->data;
+    *len = slot->len;
+    _lastRssi = slot->rssi;
+    _lastTimestamp = slot->timestamp;
+    _lastFei = slot->fei;
+    return true;
+}
+
+void RFM69::recvRelease()
+{
+    if (!available())
+        return;
+    RFM69_BARRIER(); // Finish with the slot before handing it back
+    _rxTail = _rxTail + 1;
+}
+
+void RFM69::clearTxBuf()
+{
+    _txQueue[_txHead & (RFM69_TX_QUEUE_LEN - 1)].len = 0;
+}
+
+void RFM69::startTransmit()
+{
+    _txWait = TX_WAIT_NONE;
+    // Load the FIFO from STDBY so that the RX interrupt path leaves it alone
+    boolean receiving = _mode == RFM69_MODE_RX || _listen;
+    setMode(RFM69_MODE_STDBY);
+    if (receiving) // Throw away the start of any packet that was arriving
+        spiWrite(RFM69_REG_28_IRQ_FLAGS2, RF_IRQFLAGS2_FIFOOVERRUN);
+    _txPacketSent = false;
+    _txBufSentIndex = 0;
+    _txStartedAt = millis();
+    _txRetries = 0;
+    sendTxBuf();
+    mapDio0(RF_DIOMAPPING1_DIO0_00); // PACKETSENT on DIO0
+    setModeTx(); // Start the transmitter, turns off the receiver
+}
+
+void RFM69::restartTransmit()
+{
+    setMode(RFM69_MODE_STDBY);
+    if (++_txRetries > RFM69_TX_RETRIES) {
+        // Give up on it and carry on with the rest of the queue
+        _stats.txDropped++;
+        _txTail++;
+        _txRetries = 0;
+        if (_txHead == _txTail) {
+            mapDio0(RF_DIOMAPPING1_DIO0_10);
+            setMode(_afterTxMode);
+            _txBusy = false;
+            return;
+        }
+    } else {
+        _stats.txRestarts++;
+    }
+    // Whatever made it into the FIFO last time is thrown away. Writing FifoOverrun clears it.
+    spiWrite(RFM69_REG_28_IRQ_FLAGS2, RF_IRQFLAGS2_FIFOOVERRUN);
+    _txBufSentIndex = 0;
+    _txStartedAt = millis();
+    sendTxBuf();
+    setModeTx();
+}
+
+boolean RFM69::send(const uint8_t* data, uint8_t len)
+{
+    return sendAsync(data, len);
+}
+
+boolean RFM69::sendAsync(const uint8_t* data, uint8_t len)
+{
+    if (len == 0 || _txComposing)
+        return false;
+    if (!fillTxBuf(data, len))
+        return false;
+    queueTxBuf();
+    return true;
+}
+
+boolean RFM69::sendv(const RFM69Segment* segments, uint8_t count)
+{
+    if (!beginPacket())
+        return false;
+    for (uint8_t i = 0; i < count; i++)
+        write(segments[i].data, segments[i].len);
+    return endPacket();
+}
+
+boolean RFM69::beginPacket()
+{
+    if (_txComposing || (uint8_t)(_txHead - _txTail) == RFM69_TX_QUEUE_LEN)
+        return false;
+    clearTxBuf();
+    _txComposing = true;
+    _txComposeFailed = false;
+    return true;
+}
+
+boolean RFM69::write(const uint8_t* data, uint8_t len)
+{
+    if (!_txComposing || _txComposeFailed)
+        return false;
+    if (!appendTxBuf(data, len))
+        _txComposeFailed = true;
+    return !_txComposeFailed;
+}
+
+boolean RFM69::write(const char* str)
+{
+    size_t len = strlen(str);
+    if (len > RFM69_MAX_MESSAGE_LEN) {
+        _txComposeFailed = true;
+        return false;
+    }
+    return write((const uint8_t*)str, (uint8_t)len);
+}
+
+boolean RFM69::endPacket()
+{
+    if (!_txComposing)
+        return false;
+    _txComposing = false;
+    if (_txComposeFailed || _txQueue[_txHead & (RFM69_TX_QUEUE_LEN - 1)].len == 0)
+        return false;
+    queueTxBuf();
+    return true;
+}
+
+void RFM69::queueTxBuf()
+{
+    _txQueue[_txHead & (RFM69_TX_QUEUE_LEN - 1)].queuedAt = millis();
+    RFM69_BARRIER(); // Slot contents must be complete before it is queued
+    _txHead++;
+
+    // Claim the transmitter if it is idle. If the interrupt handler is still busy
+    // sending it will pick this message up from the queue by itself.
+    noInterrupts();   // Disable Interrupts
+    boolean idle = !_txBusy;
+    _txBusy = true;
+    interrupts();     // Enable Interrupts
+    if (idle)
+        tryTransmit();
+}
+
+void RFM69::tryTransmit()
+{
+    while (_dutyPermille) {
+        TxSlot* slot = &_txQueue[_txTail & (RFM69_TX_QUEUE_LEN - 1)];
+        uint32_t freeAt;
+        if (dutyRoom(airtime(slot->len), &freeAt))
+            break;
+        if (freeAt && (uint32_t)(freeAt - slot->queuedAt) <= RFM69_DUTY_MAX_DEFER) {
+            if (_txWait != TX_WAIT_DUTY)
+                _stats.txDeferred++;
+            if (_mode == RFM69_MODE_TX) {
+                // Straight after PACKETSENT, go back to the idle mode in the meantime
+                mapDio0(RF_DIOMAPPING1_DIO0_10);
+                setMode(_afterTxMode);
+            }
+            _txWait = TX_WAIT_DUTY;
+            _txWaitUntil = freeAt;
+            return;
+        }
+        // Too long ever to fit, or it would be stale by the time it did
+        _stats.txExpired++;
+        _txWait = TX_WAIT_NONE;
+        _txTail++;
+        if (_txHead == _txTail) {
+            if (_mode == RFM69_MODE_TX) {
+                mapDio0(RF_DIOMAPPING1_DIO0_10);
+                setMode(_afterTxMode);
+            }
+            _txBusy = false;
+            return;
+        }
+    }
+    if (_lbt) {
+        _lbtTries = 0;
+        backoff();
+    } else {
+        startTransmit();
+    }
+}
+
+uint32_t RFM69::airtime(uint8_t len)
+{
+    uint16_t bytes = ((uint16_t)regRead(RFM69_REG_2C_PREAMBLE_MSB) << 8) | regRead(RFM69_REG_2D_PREAMBLE_LSB);
+    uint8_t syncConfig = regRead(RFM69_REG_2E_SYNC_CONFIG);
+    if (syncConfig & RF_SYNC_ON)
+        bytes += ((syncConfig >> 3) & 0x07) + 1;
+    uint8_t packetConfig = regRead(RFM69_REG_37_PACKET_CONFIG1);
+    uint16_t body = packetConfig & RF_PACKET1_FORMAT_VARIABLE ? len : regRead(RFM69_REG_38_PAYLOAD_LENGTH);
+    if (_aes) {
+        // Encrypted in whole blocks of 16, after the address byte
+        uint8_t address = packetConfig & (RF_PACKET1_ADRSFILTERING_NODE | RF_PACKET1_ADRSFILTERING_NODEBROADCAST) ? 1 : 0;
+        if (body > address)
+            body = address + ((body - address + 15) & ~15);
+    }
+    if (packetConfig & RF_PACKET1_FORMAT_VARIABLE)
+        body++; // Length byte
+    if (packetConfig & RF_PACKET1_CRC_ON)
+        body += 2;
+    if (packetConfig & RF_PACKET1_DCFREE_MANCHESTER)
+        body *= 2; // Everything after the sync word goes at half the rate
+    uint32_t total = (uint32_t)bytes + body;
+    // 8 bits at FXOSC / br bits per second, FXOSC being 32MHz. Split so it stays in 32 bits.
+    uint16_t br = ((uint16_t)regRead(RFM69_REG_03_BITRATE_MSB) << 8) | regRead(RFM69_REG_04_BITRATE_LSB);
+    return total * (br / 4) + total * (br % 4) / 4;
+}
+
+void RFM69::setDutyCycle(uint16_t permille, uint32_t windowMs)
+{
+    noInterrupts();   // The interrupt handler charges messages to the buckets
+    _dutyPermille = permille >= 1000 ? 0 : permille;
+    _dutyBudget = windowMs * permille;
+    // All but the current bucket cover the whole window, so the limit holds over any
+    // window, not just those that line up with the buckets
+    _dutyBucketLen = windowMs / (RFM69_DUTY_BUCKETS - 1);
+    if (_dutyBucketLen == 0)
+        _dutyBucketLen = 1;
+    memset(_dutyBuckets, 0, sizeof(_dutyBuckets));
+    _dutyBucket = 0;
+    _dutyBucketAt = millis();
+    _dutyUsed = 0;
+    interrupts();     // Enable Interrupts
+}
+
+uint32_t RFM69::airtimeUsed()
+{
+    noInterrupts();   // Disable Interrupts
+    dutyAdvance();
+    uint32_t used = _dutyUsed;
+    interrupts();     // Enable Interrupts
+    return used;
+}
+
+void RFM69::dutyAdvance()
+{
+    uint32_t now = millis();
+    for (uint8_t i = 0; i < RFM69_DUTY_BUCKETS && now - _dutyBucketAt >= _dutyBucketLen; i++) {
+        _dutyBucketAt += _dutyBucketLen;
+        _dutyBucket = (_dutyBucket + 1) % RFM69_DUTY_BUCKETS;
+        _dutyUsed -= _dutyBuckets[_dutyBucket];
+        _dutyBuckets[_dutyBucket] = 0;
+    }
+    if (now - _dutyBucketAt >= _dutyBucketLen)
+        _dutyBucketAt = now; // Idle for longer than the window, all buckets are empty anyway
+}
+
+boolean RFM69::dutyRoom(uint32_t us, uint32_t* freeAt)
+{
+    dutyAdvance();
+    if (_dutyUsed + us <= _dutyBudget)
+        return true;
+    // Oldest buckets first, find when enough of the window has moved on
+    *freeAt = 0;
+    if (us > _dutyBudget)
+        return false;
+    uint32_t used = _dutyUsed;
+    for (uint8_t k = 1; k < RFM69_DUTY_BUCKETS; k++) {
+        used -= _dutyBuckets[(_dutyBucket + k) % RFM69_DUTY_BUCKETS];
+        if (used + us <= _dutyBudget) {
+            *freeAt = _dutyBucketAt + k * _dutyBucketLen;
+            return false;
+        }
+    }
+    *freeAt = _dutyBucketAt + RFM69_DUTY_BUCKETS * _dutyBucketLen;
+    return false;
+}
+
+uint8_t RFM69::txPending()
+{
+    if (_txWait == TX_WAIT_DUTY && (int32_t)(millis() - _txWaitUntil) >= 0) {
+        tryTransmit();
+    } else if (_txWait == TX_WAIT_LBT && (int32_t)(millis() - _txWaitUntil) >= 0) {
+        if (channelClear()) {
+            startTransmit();
+        } else if (_lbtTries >= RFM69_LBT_TRIES) {
+            _stats.txForced++;
+            startTransmit();
+        } else {
+            _stats.txBackoffs++;
+            _lbtTries++;
+            backoff();
+        }
+    } else if (_txBusy && _txWait == TX_WAIT_NONE && (uint32_t)(millis() - _txStartedAt) > RFM69_TX_TIMEOUT) {
+        restartTransmit(); // PACKETSENT never came
+    }
+    return _txHead - _txTail;
+}
+
+void RFM69::setEncryptionKey(const uint8_t* key)
+{
+    // Through the shadow, so RegPacketConfig2 and the key registers after it go in one burst
+    uint8_t config2 = regRead(RFM69_REG_3D_PACKET_CONFIG2) & ~RF_PACKET2_AES_ON;
+    if (key) {
+        for (uint8_t i = 0; i < 16; i++)
+            regWrite(RFM69_REG_3E_AES_KEY1 + i, key[i]);
+        config2 |= RF_PACKET2_AES_ON;
+    }
+    regWrite(RFM69_REG_3D_PACKET_CONFIG2, config2);
+    regFlush();
+    _aes = key != NULL;
+}
+
+void RFM69::setAddressFilter(int node, int broadcast, boolean inRadio)
+{
+    uint8_t filtering = RF_PACKET1_ADRSFILTERING_OFF;
+    if (node >= 0 && inRadio)
+        filtering = broadcast >= 0 ? RF_PACKET1_ADRSFILTERING_NODEBROADCAST : RF_PACKET1_ADRSFILTERING_NODE;
+    noInterrupts();   // The interrupt handler checks addresses on the host
+    _addressHost = node >= 0 && !inRadio;
+    _nodeAddress = (uint8_t)node;
+    _broadcastAddress = broadcast >= 0 ? (uint8_t)broadcast : -1;
+    interrupts();     // Enable Interrupts
+    // RegPacketConfig1 to RegBroadcastAdrs, one burst
+    uint8_t config1 = regRead(RFM69_REG_37_PACKET_CONFIG1)
+        & ~(RF_PACKET1_ADRSFILTERING_NODE | RF_PACKET1_ADRSFILTERING_NODEBROADCAST);
+    regWrite(RFM69_REG_37_PACKET_CONFIG1, config1 | filtering);
+    if (node >= 0)
+        regWrite(RFM69_REG_39_NODE_ADRS, (uint8_t)node);
+    if (broadcast >= 0)
+        regWrite(RFM69_REG_3A_BROADCAST_ADRS, (uint8_t)broadcast);
+    regFlush();
+}
+
+boolean RFM69::sendTo(uint8_t address, const uint8_t* data, uint8_t len)
+{
+    RFM69Segment segments[2] = { { &address, 1 }, { data, len } };
+    return sendv(segments, 2);
+}
+
+void RFM69::setLbt(boolean on, int threshold)
+{
+    _lbt = on;
+    _lbtThreshold = threshold < -127 ? -127 : threshold > 0 ? 0 : threshold;
+}
+
+boolean RFM69::channelClear()
+{
+    uint8_t regs[4];
+    spiBurstRead(RFM69_REG_24_RSSI_VALUE, regs, 4);
+    _lbtSeed = (_lbtSeed << 1 | _lbtSeed >> 15) ^ regs[0];
+    int threshold = _lbtThreshold ? _lbtThreshold
+        : _noiseValid ? noiseFloor() + RFM69_LBT_MARGIN : RFM69_LBT_THRESHOLD;
+    return !(regs[3] & RF_IRQFLAGS1_SYNCADDRESSMATCH) && -(regs[0] >> 1) < threshold;
+}
+
+void RFM69::backoff()
+{
+    uint8_t be = RFM69_LBT_MIN_BE + _lbtTries;
+    if (be > RFM69_LBT_MAX_BE)
+        be = RFM69_LBT_MAX_BE;
+    // xorshift, so that nodes that heard the same packet pick different slots
+    uint16_t x = _lbtSeed ? _lbtSeed : 1;
+    x ^= x << 7;
+    x ^= x >> 9;
+    x ^= x << 8;
+    _lbtSeed = x;
+    _txWaitUntil = millis() + (1 + x % (1U << be)) * RFM69_LBT_SLOT;
+    if (_mode != RFM69_MODE_RX || _listen) {
+        // Listen while waiting, RSSI is valid well within a slot
+        mapDio0(RF_DIOMAPPING1_DIO0_10);
+        setMode(RFM69_MODE_RX);
+    }
+    _txWait = TX_WAIT_LBT;
+}
+
+boolean RFM69::fillTxBuf(const uint8_t* data, uint8_t len)
+{
+    clearTxBuf();
+    return appendTxBuf(data, len);
+}
+
+boolean RFM69::appendTxBuf(const uint8_t* data, uint8_t len)
+{
+    if ((uint8_t)(_txHead - _txTail) == RFM69_TX_QUEUE_LEN)
+        return false; // No free slot
+    TxSlot* slot = &_txQueue[_txHead & (RFM69_TX_QUEUE_LEN - 1)];
+    if (((uint16_t)slot->len + len) > (_aes ? RFM69_AES_MAX_LEN : RFM69_MAX_MESSAGE_LEN))
+        return false;
+    memcpy(slot->data + slot->len, data, len);
+    slot->len += len;
+    return true;
+}
+
+void RFM69::sendTxBuf() {
+    TxSlot* slot = &_txQueue[_txTail & (RFM69_TX_QUEUE_LEN - 1)];
+    uint8_t addr = RFM69_REG_00_FIFO | RFM69_SPI_WRITE_MASK; // Send the start address with the write mask on
+    uint8_t room;
+
+    if (_txBufSentIndex != 0 && _txBufSentIndex >= slot->len)
+        return; // All of it is in the FIFO already
+
+    if (_txBufSentIndex == 0 && _dutyPermille) {
+        // Charge it to the duty cycle as it goes on air
+        dutyAdvance();
+        uint32_t us = airtime(slot->len);
+        _dutyBuckets[_dutyBucket] += us;
+        _dutyUsed += us;
+    }
+
+    noInterrupts();    // Disable Interrupts, so no other transaction starts mid-burst
+    _transport->select();
+    _transport->transfer(&addr, NULL, 1);
+    if (_txBufSentIndex == 0) {
+        // Start of the message, the FIFO is empty
+        _transport->transfer(&slot->len, NULL, 1);
+        room = RFM69_FIFO_SIZE - 1;
+    } else {
+        // FIFOLEVEL has dropped, so no more than RF_FIFOTHRESH_VALUE bytes are left in it
+        room = RFM69_FIFO_SIZE - RF_FIFOTHRESH_VALUE - 1;
+    }
+    uint8_t len = slot->len - _txBufSentIndex;
+    if (len > room)
+        len = room;
+    _transport->transfer(slot->data + _txBufSentIndex, NULL, len);
+    _transport->deselect();
+    busUsed((_txBufSentIndex == 0 ? 2 : 1) + len);
+    _txBufSentIndex += len;
+    interrupts();     // Enable Interrupts
+}
+
+void RFM69::readRxBuf(uint8_t len)
+{
+    uint8_t* dest = NULL;
+    if (!_rxStreamDiscard)
+        dest = _rxQueue[_rxHead & (RFM69_RX_QUEUE_LEN - 1)].data + _rxStreamPos;
+    spiBurstRead(RFM69_REG_00_FIFO, dest, len);
+    _rxStreamPos += len;
+    _rxStreamAt = millis();
+}
+
+void RFM69::resetRxStream()
+{
+    _rxStreaming = false;
+    _rxStreamDiscard = false;
+    _syncRssiValid = false;
+    _rxStreamPos = 0;
+    _rxStreamLen = 0;
+}
+
+int RFM69::lastRssi()
+{
+    return _lastRssi;
+}
+
+uint32_t RFM69::lastTimestamp()
+{
+    return _lastTimestamp;
+}
+
+int16_t RFM69::lastFei()
+{
+    return _lastFei;
+}
+
+uint16_t RFM69::rxOverflows()
+{
+    return _stats.rxOverflows;
+}
+
+void RFM69::dwell()
+{
+    uint32_t now = micros();
+    uint32_t us = now - _modeSince;
+    _modeSince = now;
+    uint8_t bucket = _listen ? RFM69_STATS_LISTEN
+        : _mode == RFM69_MODE_SLEEP ? RFM69_STATS_SLEEP
+        : _mode == RFM69_MODE_RX ? RFM69_STATS_RX
+        : _mode == RFM69_MODE_TX ? RFM69_STATS_TX : RFM69_STATS_STDBY;
+    us += _dwellUs[bucket];
+    _stats.dwellMs[bucket] += us / 1000;
+    _dwellUs[bucket] = us % 1000;
+}
+
+void RFM69::stats(RFM69Stats& stats)
+{
+    noInterrupts();   // Disable Interrupts
+    dwell();
+    stats = _stats;
+    interrupts();     // Enable Interrupts
+}
+
+void RFM69::clearStats()
+{
+    noInterrupts();   // Disable Interrupts
+    memset(&_stats, 0, sizeof(_stats));
+    memset(_dwellUs, 0, sizeof(_dwellUs));
+    _modeSince = micros();
+    interrupts();     // Enable Interrupts
+}
@@ -1,958 +1,1635 @@
-// RFM69.h
-// Author: Phil Crump (phildcrump@gmail.com)
-// Copyright (C) 2014 Phil Crump
-// Based on RF22.h
-// Author: Mike McCauley (mikem@open.com.au)
-// Copyright (C) 2011 Mike McCauley
-
-#ifndef RFM69_h
-#define RFM69_h
-
-#define boolean bool
-
-#define RFM69_SPI_WRITE_MASK 0x80
-
-// This is the maximum message length that can be supported by this library. Limited by
-// the single message length octet in the header. 
-// Yes, 255 is correct even though the FIFO size in the RF22 is only
-// 64 octets. We use interrupts to refill the Tx FIFO during transmission and to empty the
-// Rx FIFO during reception
-// Can be pre-defined to a smaller size (to save SRAM) prior to including this header
-#define RFM69_MAX_MESSAGE_LEN 64
-
-// Max number of octets the RFM69 FIFO can hold
-#define RFM69_FIFO_SIZE 64
-
-#define RFM69_MODE_SLEEP    0x00 // 0.1uA
-#define RFM69_MODE_STDBY    0x04 // 1.25mA
-#define RFM69_MODE_RX       0x10 // 16mA
-#define RFM69_MODE_TX       0x0c // >33mA
-
-
-// These values we set for FIFO thresholds are actually the same as the POR values
-#define RF22_TXFFAEM_THRESHOLD 4
-#define RF22_RXFFAFULL_THRESHOLD 55
-
-
-// Register names
-
-#define RFM69_REG_00_FIFO           0x00
-#define RFM69_REG_01_OPMODE         0x01
-#define RFM69_REG_02_DATA_MODUL     0x02
-#define RFM69_REG_03_BITRATE_MSB    0x03
-#define RFM69_REG_04_BITRATE_LSB    0x04
-#define RFM69_REG_05_FDEV_MSB       0x05
-#define RFM69_REG_06_FDEV_LSB       0x06
-#define RFM69_REG_07_FRF_MSB        0x07
-#define RFM69_REG_08_FRF_MID        0x08
-#define RFM69_REG_09_FRF_LSB        0x09
-#define RFM69_REG_0A_OSC1           0x0A
-#define RFM69_REG_0B_AFC_CTRL       0x0B
-#define RFM69_REG_0D_LISTEN1        0x0D
-#define RFM69_REG_0E_LISTEN2        0x0E
-#define RFM69_REG_0F_LISTEN3        0x0F
-#define RFM69_REG_10_VERSION        0x10 //Version and serial number
-#define RFM69_REG_11_PA_LEVEL       0x11
-#define RFM69_REG_12_PA_RAMP        0x12
-#define RFM69_REG_13_OCP            0x13
-#define RFM69_REG_18_LNA            0x18
-#define RFM69_REG_19_RX_BW          0x19
-#define RFM69_REG_1A_AFC_BW         0x1A
-#define RFM69_REG_1B_OOK_PEAK       0x1B
-#define RFM69_REG_1C_OOK_AVG        0x1C
-#define RFM69_REG_1D_OOF_FIX        0x1D
-#define RFM69_REG_1E_AFC_FEI        0x1E
-#define RFM69_REG_1F_AFC_MSB        0x1F
-#define RFM69_REG_20_AFC_LSB        0x20
-#define RFM69_REG_21_FEI_MSB        0x21
-#define RFM69_REG_22_FEI_LSB        0x22
-#define RFM69_REG_23_RSSI_CONFIG    0x23
-#define RFM69_REG_24_RSSI_VALUE     0x24
-#define RFM69_REG_25_DIO_MAPPING1   0x25
-#define RFM69_REG_26_DIO_MAPPING2   0x26
-#define RFM69_REG_27_IRQ_FLAGS1     0x27
-#define RFM69_REG_28_IRQ_FLAGS2     0x28
-#define RFM69_REG_29_RSSI_THRESHOLD 0x29
-#define RFM69_REG_2A_RX_TIMEOUT1    0x2A
-#define RFM69_REG_2B_RX_TIMEOUT2    0x2B
-#define RFM69_REG_2C_PREAMBLE_MSB   0x2C
-#define RFM69_REG_2D_PREAMBLE_LSB   0x2D
-#define RFM69_REG_2E_SYNC_CONFIG    0x2E
-#define RFM69_REG_2F_SYNCVALUE1     0x2F
-#define RFM69_REG_30_SYNCVALUE2     0x30
-// Sync values 1-8 go here
-#define RFM69_REG_37_PACKET_CONFIG1 0x37
-#define RFM69_REG_38_PAYLOAD_LENGTH 0x38
-// Node address, broadcast address go here
-#define RFM69_REG_3B_AUTOMODES      0x3B
-#define RFM69_REG_3C_FIFO_THRESHOLD 0x3C
-#define RFM69_REG_3D_PACKET_CONFIG2 0x3D
-// AES Key 1-16 go here
-#define RFM69_REG_4E_TEMP1          0x4E
-#define RFM69_REG_4F_TEMP2          0x4F
-#define RFM69_REG_58_TEST_LNA       0x58
-#define RFM69_REG_5A_TEST_PA1       0x5A
-#define RFM69_REG_5C_TEST_PA2       0x5C
-#define RFM69_REG_6F_TEST_DAGC      0x6F
-#define RFM69_REG_71_TEST_AFC       0x71
-
-//******************************************************
-// RF69/SX1231 bit control definition
-//******************************************************
-// RegOpMode
-#define RF_OPMODE_SEQUENCER_OFF             0x80
-#define RF_OPMODE_SEQUENCER_ON              0x00  // Default
-
-#define RF_OPMODE_LISTEN_ON                     0x40
-#define RF_OPMODE_LISTEN_OFF                    0x00  // Default
-
-#define RF_OPMODE_LISTENABORT                   0x20
-
-#define RF_OPMODE_SLEEP                           0x00
-#define RF_OPMODE_STANDBY                         0x04  // Default
-#define RF_OPMODE_SYNTHESIZER                   0x08
-#define RF_OPMODE_TRANSMITTER                   0x0C
-#define RF_OPMODE_RECEIVER                      0x10
-
-// RegDataModul
-#define RF_DATAMODUL_DATAMODE_PACKET                  0x00  // Default
-#define RF_DATAMODUL_DATAMODE_CONTINUOUS            0x40
-#define RF_DATAMODUL_DATAMODE_CONTINUOUSNOBSYNC 0x60
-
-#define RF_DATAMODUL_MODULATIONTYPE_FSK             0x00  // Default
-#define RF_DATAMODUL_MODULATIONTYPE_OOK             0x08
-
-#define RF_DATAMODUL_MODULATIONSHAPING_00           0x00  // Default
-#define RF_DATAMODUL_MODULATIONSHAPING_01           0x01
-#define RF_DATAMODUL_MODULATIONSHAPING_10           0x02
-#define RF_DATAMODUL_MODULATIONSHAPING_11           0x03
-
-// RegOsc1
-#define RF_OSC1_RCCAL_START             0x80
-#define RF_OSC1_RCCAL_DONE              0x40
-
-// RegAfcCtrl
-#define RF_AFCLOWBETA_ON                    0x20
-#define RF_AFCLOWBETA_OFF                   0x00    // Default
-
-// RegLowBat
-#define RF_LOWBAT_MONITOR                   0x10
-#define RF_LOWBAT_ON                            0x08
-#define RF_LOWBAT_OFF                           0x00  // Default
-
-#define RF_LOWBAT_TRIM_1695             0x00
-#define RF_LOWBAT_TRIM_1764             0x01
-#define RF_LOWBAT_TRIM_1835             0x02  // Default
-#define RF_LOWBAT_TRIM_1905             0x03
-#define RF_LOWBAT_TRIM_1976             0x04
-#define RF_LOWBAT_TRIM_2045             0x05
-#define RF_LOWBAT_TRIM_2116             0x06
-#define RF_LOWBAT_TRIM_2185             0x07
-
-
-// RegListen1
-#define RF_LISTEN1_RESOL_64             0x50
-#define RF_LISTEN1_RESOL_4100           0xA0  // Default
-#define RF_LISTEN1_RESOL_262000     0xF0
-
-#define RF_LISTEN1_CRITERIA_RSSI                  0x00  // Default
-#define RF_LISTEN1_CRITERIA_RSSIANDSYNC   0x08
-
-#define RF_LISTEN1_END_00                             0x00
-#define RF_LISTEN1_END_01                             0x02  // Default
-#define RF_LISTEN1_END_10                             0x04
-
-
-// RegListen2
-#define RF_LISTEN2_COEFIDLE_VALUE               0xF5 // Default
-
-// RegListen3
-#define RF_LISTEN3_COEFRX_VALUE                 0x20 // Default
-
-// RegPaLevel
-#define RF_PALEVEL_PA0_ON         0x80  // Default
-#define RF_PALEVEL_PA0_OFF      0x00
-#define RF_PALEVEL_PA1_ON           0x40
-#define RF_PALEVEL_PA1_OFF      0x00  // Default
-#define RF_PALEVEL_PA2_ON           0x20
-#define RF_PALEVEL_PA2_OFF      0x00  // Default
-
-
-// RegPaRamp
-#define RF_PARAMP_3400                      0x00
-#define RF_PARAMP_2000                      0x01
-#define RF_PARAMP_1000                      0x02
-#define RF_PARAMP_500                           0x03
-#define RF_PARAMP_250                           0x04
-#define RF_PARAMP_125                           0x05
-#define RF_PARAMP_100                           0x06
-#define RF_PARAMP_62                            0x07
-#define RF_PARAMP_50                            0x08
-#define RF_PARAMP_40                            0x09  // Default
-#define RF_PARAMP_31                            0x0A
-#define RF_PARAMP_25                            0x0B
-#define RF_PARAMP_20                            0x0C
-#define RF_PARAMP_15                            0x0D
-#define RF_PARAMP_12                            0x0E
-#define RF_PARAMP_10                            0x0F
-
-
-// RegOcp
-#define RF_OCP_OFF                              0x0F
-#define RF_OCP_ON                                 0x1A  // Default
-
-#define RF_OCP_TRIM_45                      0x00
-#define RF_OCP_TRIM_50                      0x01
-#define RF_OCP_TRIM_55                      0x02
-#define RF_OCP_TRIM_60                      0x03
-#define RF_OCP_TRIM_65                      0x04
-#define RF_OCP_TRIM_70                      0x05
-#define RF_OCP_TRIM_75                      0x06
-#define RF_OCP_TRIM_80                      0x07
-#define RF_OCP_TRIM_85                      0x08
-#define RF_OCP_TRIM_90                      0x09
-#define RF_OCP_TRIM_95                      0x0A
-#define RF_OCP_TRIM_100                     0x0B  // Default
-#define RF_OCP_TRIM_105                     0x0C
-#define RF_OCP_TRIM_110                     0x0D
-#define RF_OCP_TRIM_115                     0x0E
-#define RF_OCP_TRIM_120                     0x0F
-
-
-// RegAgcRef
-#define RF_AGCREF_AUTO_ON                   0x40  // Default
-#define RF_AGCREF_AUTO_OFF              0x00
-
-#define RF_AGCREF_LEVEL_MINUS80     0x00  // Default
-#define RF_AGCREF_LEVEL_MINUS81     0x01
-#define RF_AGCREF_LEVEL_MINUS82     0x02
-#define RF_AGCREF_LEVEL_MINUS83     0x03
-#define RF_AGCREF_LEVEL_MINUS84     0x04
-#define RF_AGCREF_LEVEL_MINUS85     0x05
-#define RF_AGCREF_LEVEL_MINUS86     0x06
-#define RF_AGCREF_LEVEL_MINUS87     0x07
-#define RF_AGCREF_LEVEL_MINUS88     0x08
-#define RF_AGCREF_LEVEL_MINUS89     0x09
-#define RF_AGCREF_LEVEL_MINUS90     0x0A
-#define RF_AGCREF_LEVEL_MINUS91     0x0B
-#define RF_AGCREF_LEVEL_MINUS92     0x0C
-#define RF_AGCREF_LEVEL_MINUS93     0x0D
-#define RF_AGCREF_LEVEL_MINUS94     0x0E
-#define RF_AGCREF_LEVEL_MINUS95     0x0F
-#define RF_AGCREF_LEVEL_MINUS96     0x10
-#define RF_AGCREF_LEVEL_MINUS97     0x11
-#define RF_AGCREF_LEVEL_MINUS98     0x12
-#define RF_AGCREF_LEVEL_MINUS99     0x13
-#define RF_AGCREF_LEVEL_MINUS100    0x14
-#define RF_AGCREF_LEVEL_MINUS101    0x15
-#define RF_AGCREF_LEVEL_MINUS102    0x16
-#define RF_AGCREF_LEVEL_MINUS103    0x17
-#define RF_AGCREF_LEVEL_MINUS104    0x18
-#define RF_AGCREF_LEVEL_MINUS105    0x19
-#define RF_AGCREF_LEVEL_MINUS106    0x1A
-#define RF_AGCREF_LEVEL_MINUS107    0x1B
-#define RF_AGCREF_LEVEL_MINUS108    0x1C
-#define RF_AGCREF_LEVEL_MINUS109    0x1D
-#define RF_AGCREF_LEVEL_MINUS110    0x1E
-#define RF_AGCREF_LEVEL_MINUS111    0x1F
-#define RF_AGCREF_LEVEL_MINUS112    0x20
-#define RF_AGCREF_LEVEL_MINUS113    0x21
-#define RF_AGCREF_LEVEL_MINUS114    0x22
-#define RF_AGCREF_LEVEL_MINUS115    0x23
-#define RF_AGCREF_LEVEL_MINUS116    0x24
-#define RF_AGCREF_LEVEL_MINUS117    0x25
-#define RF_AGCREF_LEVEL_MINUS118    0x26
-#define RF_AGCREF_LEVEL_MINUS119    0x27
-#define RF_AGCREF_LEVEL_MINUS120    0x28
-#define RF_AGCREF_LEVEL_MINUS121    0x29
-#define RF_AGCREF_LEVEL_MINUS122    0x2A
-#define RF_AGCREF_LEVEL_MINUS123    0x2B
-#define RF_AGCREF_LEVEL_MINUS124    0x2C
-#define RF_AGCREF_LEVEL_MINUS125    0x2D
-#define RF_AGCREF_LEVEL_MINUS126    0x2E
-#define RF_AGCREF_LEVEL_MINUS127    0x2F
-#define RF_AGCREF_LEVEL_MINUS128    0x30
-#define RF_AGCREF_LEVEL_MINUS129    0x31
-#define RF_AGCREF_LEVEL_MINUS130    0x32
-#define RF_AGCREF_LEVEL_MINUS131    0x33
-#define RF_AGCREF_LEVEL_MINUS132    0x34
-#define RF_AGCREF_LEVEL_MINUS133    0x35
-#define RF_AGCREF_LEVEL_MINUS134    0x36
-#define RF_AGCREF_LEVEL_MINUS135    0x37
-#define RF_AGCREF_LEVEL_MINUS136    0x38
-#define RF_AGCREF_LEVEL_MINUS137    0x39
-#define RF_AGCREF_LEVEL_MINUS138    0x3A
-#define RF_AGCREF_LEVEL_MINUS139    0x3B
-#define RF_AGCREF_LEVEL_MINUS140    0x3C
-#define RF_AGCREF_LEVEL_MINUS141    0x3D
-#define RF_AGCREF_LEVEL_MINUS142    0x3E
-#define RF_AGCREF_LEVEL_MINUS143    0x3F
-
-
-// RegAgcThresh1
-#define RF_AGCTHRESH1_SNRMARGIN_000     0x00
-#define RF_AGCTHRESH1_SNRMARGIN_001     0x20
-#define RF_AGCTHRESH1_SNRMARGIN_010     0x40
-#define RF_AGCTHRESH1_SNRMARGIN_011     0x60
-#define RF_AGCTHRESH1_SNRMARGIN_100     0x80
-#define RF_AGCTHRESH1_SNRMARGIN_101     0xA0  // Default
-#define RF_AGCTHRESH1_SNRMARGIN_110     0xC0
-#define RF_AGCTHRESH1_SNRMARGIN_111     0xE0
-
-#define RF_AGCTHRESH1_STEP1_0                   0x00
-#define RF_AGCTHRESH1_STEP1_1                   0x01
-#define RF_AGCTHRESH1_STEP1_2                   0x02
-#define RF_AGCTHRESH1_STEP1_3                   0x03
-#define RF_AGCTHRESH1_STEP1_4                   0x04
-#define RF_AGCTHRESH1_STEP1_5                   0x05
-#define RF_AGCTHRESH1_STEP1_6                   0x06
-#define RF_AGCTHRESH1_STEP1_7                   0x07
-#define RF_AGCTHRESH1_STEP1_8                   0x08
-#define RF_AGCTHRESH1_STEP1_9                   0x09
-#define RF_AGCTHRESH1_STEP1_10              0x0A
-#define RF_AGCTHRESH1_STEP1_11              0x0B
-#define RF_AGCTHRESH1_STEP1_12              0x0C
-#define RF_AGCTHRESH1_STEP1_13              0x0D
-#define RF_AGCTHRESH1_STEP1_14              0x0E
-#define RF_AGCTHRESH1_STEP1_15              0x0F
-#define RF_AGCTHRESH1_STEP1_16              0x10  // Default
-#define RF_AGCTHRESH1_STEP1_17              0x11
-#define RF_AGCTHRESH1_STEP1_18              0x12
-#define RF_AGCTHRESH1_STEP1_19              0x13
-#define RF_AGCTHRESH1_STEP1_20              0x14
-#define RF_AGCTHRESH1_STEP1_21              0x15
-#define RF_AGCTHRESH1_STEP1_22              0x16
-#define RF_AGCTHRESH1_STEP1_23              0x17
-#define RF_AGCTHRESH1_STEP1_24              0x18
-#define RF_AGCTHRESH1_STEP1_25              0x19
-#define RF_AGCTHRESH1_STEP1_26              0x1A
-#define RF_AGCTHRESH1_STEP1_27              0x1B
-#define RF_AGCTHRESH1_STEP1_28              0x1C
-#define RF_AGCTHRESH1_STEP1_29              0x1D
-#define RF_AGCTHRESH1_STEP1_30              0x1E
-#define RF_AGCTHRESH1_STEP1_31              0x1F
-
-
-// RegAgcThresh2
-#define RF_AGCTHRESH2_STEP2_0                   0x00
-#define RF_AGCTHRESH2_STEP2_1                   0x10
-#define RF_AGCTHRESH2_STEP2_2                   0x20
-#define RF_AGCTHRESH2_STEP2_3                   0x30  // XXX wrong -- Default
-#define RF_AGCTHRESH2_STEP2_4                   0x40
-#define RF_AGCTHRESH2_STEP2_5                   0x50
-#define RF_AGCTHRESH2_STEP2_6                   0x60
-#define RF_AGCTHRESH2_STEP2_7                   0x70    // default
-#define RF_AGCTHRESH2_STEP2_8                   0x80
-#define RF_AGCTHRESH2_STEP2_9                   0x90
-#define RF_AGCTHRESH2_STEP2_10              0xA0
-#define RF_AGCTHRESH2_STEP2_11              0xB0
-#define RF_AGCTHRESH2_STEP2_12              0xC0
-#define RF_AGCTHRESH2_STEP2_13              0xD0
-#define RF_AGCTHRESH2_STEP2_14              0xE0
-#define RF_AGCTHRESH2_STEP2_15              0xF0
-
-#define RF_AGCTHRESH2_STEP3_0                   0x00
-#define RF_AGCTHRESH2_STEP3_1                   0x01
-#define RF_AGCTHRESH2_STEP3_2                   0x02
-#define RF_AGCTHRESH2_STEP3_3                   0x03
-#define RF_AGCTHRESH2_STEP3_4                   0x04
-#define RF_AGCTHRESH2_STEP3_5                   0x05
-#define RF_AGCTHRESH2_STEP3_6                   0x06
-#define RF_AGCTHRESH2_STEP3_7                   0x07
-#define RF_AGCTHRESH2_STEP3_8                   0x08
-#define RF_AGCTHRESH2_STEP3_9                   0x09
-#define RF_AGCTHRESH2_STEP3_10              0x0A
-#define RF_AGCTHRESH2_STEP3_11              0x0B  // Default
-#define RF_AGCTHRESH2_STEP3_12              0x0C
-#define RF_AGCTHRESH2_STEP3_13              0x0D
-#define RF_AGCTHRESH2_STEP3_14              0x0E
-#define RF_AGCTHRESH2_STEP3_15              0x0F
-
-
-// RegAgcThresh3
-#define RF_AGCTHRESH3_STEP4_0                   0x00
-#define RF_AGCTHRESH3_STEP4_1                   0x10
-#define RF_AGCTHRESH3_STEP4_2                   0x20
-#define RF_AGCTHRESH3_STEP4_3                   0x30
-#define RF_AGCTHRESH3_STEP4_4                   0x40
-#define RF_AGCTHRESH3_STEP4_5                   0x50
-#define RF_AGCTHRESH3_STEP4_6                   0x60
-#define RF_AGCTHRESH3_STEP4_7                   0x70
-#define RF_AGCTHRESH3_STEP4_8                   0x80
-#define RF_AGCTHRESH3_STEP4_9                   0x90  // Default
-#define RF_AGCTHRESH3_STEP4_10              0xA0
-#define RF_AGCTHRESH3_STEP4_11              0xB0
-#define RF_AGCTHRESH3_STEP4_12              0xC0
-#define RF_AGCTHRESH3_STEP4_13              0xD0
-#define RF_AGCTHRESH3_STEP4_14              0xE0
-#define RF_AGCTHRESH3_STEP4_15              0xF0
-
-#define RF_AGCTHRESH3_STEP5_0                   0x00
-#define RF_AGCTHRESH3_STEP5_1                   0x01
-#define RF_AGCTHRESH3_STEP5_2                   0x02
-#define RF_AGCTHRESH3_STEP5_3                   0x03
-#define RF_AGCTHRESH3_STEP5_4                   0x04
-#define RF_AGCTHRESH3_STEP5_5                   0x05
-#define RF_AGCTHRESH3_STEP5_6                   0x06
-#define RF_AGCTHRESH3_STEP5_7                   0x07
-#define RF_AGCTHRES33_STEP5_8                   0x08
-#define RF_AGCTHRESH3_STEP5_9                   0x09
-#define RF_AGCTHRESH3_STEP5_10              0x0A
-#define RF_AGCTHRESH3_STEP5_11              0x0B  // Default
-#define RF_AGCTHRESH3_STEP5_12              0x0C
-#define RF_AGCTHRESH3_STEP5_13              0x0D
-#define RF_AGCTHRESH3_STEP5_14              0x0E
-#define RF_AGCTHRESH3_STEP5_15              0x0F
-
-
-// RegLna
-#define RF_LNA_ZIN_50                               0x00
-#define RF_LNA_ZIN_200                            0x80  // Default
-
-#define RF_LNA_LOWPOWER_OFF                     0x00  // Default
-#define RF_LNA_LOWPOWER_ON                      0x40
-
-#define RF_LNA_CURRENTGAIN                      0x38
-
-#define RF_LNA_GAINSELECT_AUTO              0x00  // Default
-#define RF_LNA_GAINSELECT_MAX                   0x01
-#define RF_LNA_GAINSELECT_MAXMINUS6     0x02
-#define RF_LNA_GAINSELECT_MAXMINUS12    0x03
-#define RF_LNA_GAINSELECT_MAXMINUS24    0x04
-#define RF_LNA_GAINSELECT_MAXMINUS36    0x05
-#define RF_LNA_GAINSELECT_MAXMINUS48    0x06
-
-
-// RegRxBw
-#define RF_RXBW_DCCFREQ_000                     0x00
-#define RF_RXBW_DCCFREQ_001                     0x20
-#define RF_RXBW_DCCFREQ_010                     0x40  // Default
-#define RF_RXBW_DCCFREQ_011                     0x60
-#define RF_RXBW_DCCFREQ_100                     0x80
-#define RF_RXBW_DCCFREQ_101                     0xA0
-#define RF_RXBW_DCCFREQ_110                     0xC0
-#define RF_RXBW_DCCFREQ_111                     0xE0
-
-#define RF_RXBW_MANT_16                           0x00
-#define RF_RXBW_MANT_20                           0x08
-#define RF_RXBW_MANT_24                           0x10  // Default
-
-#define RF_RXBW_EXP_0                               0x00
-#define RF_RXBW_EXP_1                           0x01
-#define RF_RXBW_EXP_2                           0x02
-#define RF_RXBW_EXP_3                               0x03
-#define RF_RXBW_EXP_4                           0x04
-#define RF_RXBW_EXP_5                           0x05  // Default
-#define RF_RXBW_EXP_6                             0x06
-#define RF_RXBW_EXP_7                             0x07
-
-
-// RegAfcBw
-#define RF_AFCBW_DCCFREQAFC_000             0x00
-#define RF_AFCBW_DCCFREQAFC_001             0x20
-#define RF_AFCBW_DCCFREQAFC_010             0x40
-#define RF_AFCBW_DCCFREQAFC_011             0x60
-#define RF_AFCBW_DCCFREQAFC_100             0x80  // Default
-#define RF_AFCBW_DCCFREQAFC_101             0xA0
-#define RF_AFCBW_DCCFREQAFC_110             0xC0
-#define RF_AFCBW_DCCFREQAFC_111             0xE0
-
-#define RF_AFCBW_MANTAFC_16                     0x00
-#define RF_AFCBW_MANTAFC_20                     0x08  // Default
-#define RF_AFCBW_MANTAFC_24                     0x10
-
-#define RF_AFCBW_EXPAFC_0                         0x00
-#define RF_AFCBW_EXPAFC_1                       0x01
-#define RF_AFCBW_EXPAFC_2                       0x02
-#define RF_AFCBW_EXPAFC_3                       0x03  // Default
-#define RF_AFCBW_EXPAFC_4                       0x04
-#define RF_AFCBW_EXPAFC_5                       0x05
-#define RF_AFCBW_EXPAFC_6                         0x06
-#define RF_AFCBW_EXPAFC_7                       0x07
-
-
-// RegOokPeak
-#define RF_OOKPEAK_THRESHTYPE_FIXED             0x00
-#define RF_OOKPEAK_THRESHTYPE_PEAK              0x40  // Default
-#define RF_OOKPEAK_THRESHTYPE_AVERAGE           0x80
-
-#define RF_OOKPEAK_PEAKTHRESHSTEP_000           0x00  // Default
-#define RF_OOKPEAK_PEAKTHRESHSTEP_001           0x08
-#define RF_OOKPEAK_PEAKTHRESHSTEP_010           0x10
-#define RF_OOKPEAK_PEAKTHRESHSTEP_011           0x18
-#define RF_OOKPEAK_PEAKTHRESHSTEP_100           0x20
-#define RF_OOKPEAK_PEAKTHRESHSTEP_101           0x28
-#define RF_OOKPEAK_PEAKTHRESHSTEP_110           0x30
-#define RF_OOKPEAK_PEAKTHRESHSTEP_111           0x38
-
-#define RF_OOKPEAK_PEAKTHRESHDEC_000            0x00  // Default
-#define RF_OOKPEAK_PEAKTHRESHDEC_001            0x01
-#define RF_OOKPEAK_PEAKTHRESHDEC_010            0x02
-#define RF_OOKPEAK_PEAKTHRESHDEC_011            0x03
-#define RF_OOKPEAK_PEAKTHRESHDEC_100            0x04
-#define RF_OOKPEAK_PEAKTHRESHDEC_101            0x05
-#define RF_OOKPEAK_PEAKTHRESHDEC_110            0x06
-#define RF_OOKPEAK_PEAKTHRESHDEC_111            0x07
-
-
-// RegOokAvg
-#define RF_OOKAVG_AVERAGETHRESHFILT_00      0x00
-#define RF_OOKAVG_AVERAGETHRESHFILT_01      0x40
-#define RF_OOKAVG_AVERAGETHRESHFILT_10      0x80  // Default
-#define RF_OOKAVG_AVERAGETHRESHFILT_11      0xC0
-
-
-// RegOokFix
-#define RF_OOKFIX_FIXEDTHRESH_VALUE             0x06  // Default
-
-
-// RegAfcFei
-#define RF_AFCFEI_FEI_DONE                          0x40
-#define RF_AFCFEI_FEI_START                         0x20
-#define RF_AFCFEI_AFC_DONE                          0x10
-#define RF_AFCFEI_AFCAUTOCLEAR_ON               0x08
-#define RF_AFCFEI_AFCAUTOCLEAR_OFF              0x00  // Default
-
-#define RF_AFCFEI_AFCAUTO_ON                        0x04
-#define RF_AFCFEI_AFCAUTO_OFF                       0x00  // Default
-
-#define RF_AFCFEI_AFC_CLEAR                         0x02
-#define RF_AFCFEI_AFC_START                         0x01
-
-// RegRssiConfig
-#define RF_RSSI_FASTRX_ON                             0x08
-#define RF_RSSI_FASTRX_OFF                          0x00  // Default
-#define RF_RSSI_DONE                                    0x02
-#define RF_RSSI_START                                   0x01
-
-
-// RegDioMapping1
-#define RF_DIOMAPPING1_DIO0_00                  0x00  // Default
-#define RF_DIOMAPPING1_DIO0_01                  0x40
-#define RF_DIOMAPPING1_DIO0_10                  0x80
-#define RF_DIOMAPPING1_DIO0_11                  0xC0
-
-#define RF_DIOMAPPING1_DIO1_00                      0x00  // Default
-#define RF_DIOMAPPING1_DIO1_01                  0x10
-#define RF_DIOMAPPING1_DIO1_10                  0x20
-#define RF_DIOMAPPING1_DIO1_11                  0x30
-
-#define RF_DIOMAPPING1_DIO2_00                  0x00  // Default
-#define RF_DIOMAPPING1_DIO2_01                  0x04
-#define RF_DIOMAPPING1_DIO2_10                  0x08
-#define RF_DIOMAPPING1_DIO2_11                  0x0C
-
-#define RF_DIOMAPPING1_DIO3_00                  0x00  // Default
-#define RF_DIOMAPPING1_DIO3_01                  0x01
-#define RF_DIOMAPPING1_DIO3_10                  0x02
-#define RF_DIOMAPPING1_DIO3_11                  0x03
-
-
-// RegDioMapping2
-#define RF_DIOMAPPING2_DIO4_00                  0x00  // Default
-#define RF_DIOMAPPING2_DIO4_01                  0x40
-#define RF_DIOMAPPING2_DIO4_10                  0x80
-#define RF_DIOMAPPING2_DIO4_11                  0xC0
-
-#define RF_DIOMAPPING2_DIO5_00                  0x00  // Default
-#define RF_DIOMAPPING2_DIO5_01                  0x10
-#define RF_DIOMAPPING2_DIO5_10                  0x20
-#define RF_DIOMAPPING2_DIO5_11                  0x30
-
-#define RF_DIOMAPPING2_CLKOUT_32                0x00
-#define RF_DIOMAPPING2_CLKOUT_16                0x01
-#define RF_DIOMAPPING2_CLKOUT_8                 0x02
-#define RF_DIOMAPPING2_CLKOUT_4                   0x03
-#define RF_DIOMAPPING2_CLKOUT_2                 0x04
-#define RF_DIOMAPPING2_CLKOUT_1                 0x05
-#define RF_DIOMAPPING2_CLKOUT_RC                0x06
-#define RF_DIOMAPPING2_CLKOUT_OFF                 0x07  // Default
-
-
-// RegIrqFlags1
-#define RF_IRQFLAGS1_MODEREADY                    0x80
-#define RF_IRQFLAGS1_RXREADY                        0x40
-#define RF_IRQFLAGS1_TXREADY                        0x20
-#define RF_IRQFLAGS1_PLLLOCK                        0x10
-#define RF_IRQFLAGS1_RSSI                             0x08
-#define RF_IRQFLAGS1_TIMEOUT                        0x04
-#define RF_IRQFLAGS1_AUTOMODE                       0x02
-#define RF_IRQFLAGS1_SYNCADDRESSMATCH           0x01
-
-// RegIrqFlags2
-#define RF_IRQFLAGS2_FIFOFULL                       0x80
-#define RF_IRQFLAGS2_FIFONOTEMPTY                 0x40
-#define RF_IRQFLAGS2_FIFOLEVEL                    0x20
-#define RF_IRQFLAGS2_FIFOOVERRUN                  0x10
-#define RF_IRQFLAGS2_PACKETSENT                   0x08
-#define RF_IRQFLAGS2_PAYLOADREADY                 0x04
-#define RF_IRQFLAGS2_CRCOK                          0x02
-#define RF_IRQFLAGS2_LOWBAT                         0x01
-
-// RegRssiThresh
-#define RF_RSSITHRESH_VALUE                         0xE4  // Default
-
-// RegRxTimeout1
-#define RF_RXTIMEOUT1_RXSTART_VALUE             0x00  // Default
-
-// RegRxTimeout2
-#define RF_RXTIMEOUT2_RSSITHRESH_VALUE      0x00  // Default
-
-// RegPreamble
-#define RF_PREAMBLESIZE_MSB_VALUE                 0x00  // Default
-#define RF_PREAMBLESIZE_LSB_VALUE                 0x03  // Default
-
-
-// RegSyncConfig
-#define RF_SYNC_ON                              0x80  // Default
-#define RF_SYNC_OFF                             0x00
-
-#define RF_SYNC_FIFOFILL_AUTO           0x00  // Default -- when sync interrupt occurs
-#define RF_SYNC_FIFOFILL_MANUAL     0x40
-
-#define RF_SYNC_SIZE_1                      0x00
-#define RF_SYNC_SIZE_2                      0x08
-#define RF_SYNC_SIZE_3                      0x10
-#define RF_SYNC_SIZE_4                      0x18  // Default
-#define RF_SYNC_SIZE_5                      0x20
-#define RF_SYNC_SIZE_6                      0x28
-#define RF_SYNC_SIZE_7                      0x30
-#define RF_SYNC_SIZE_8                      0x38
-
-#define RF_SYNC_TOL_0                           0x00  // Default
-#define RF_SYNC_TOL_1                           0x01
-#define RF_SYNC_TOL_2                           0x02
-#define RF_SYNC_TOL_3                           0x03
-#define RF_SYNC_TOL_4                           0x04
-#define RF_SYNC_TOL_5                           0x05
-#define RF_SYNC_TOL_6                           0x06
-#define RF_SYNC_TOL_7                           0x07
-
-
-// RegSyncValue1-8
-#define RF_SYNC_BYTE1_VALUE             0x00  // Default
-#define RF_SYNC_BYTE2_VALUE             0x00  // Default
-#define RF_SYNC_BYTE3_VALUE             0x00  // Default
-#define RF_SYNC_BYTE4_VALUE             0x00  // Default
-#define RF_SYNC_BYTE5_VALUE             0x00  // Default
-#define RF_SYNC_BYTE6_VALUE             0x00  // Default
-#define RF_SYNC_BYTE7_VALUE             0x00  // Default
-#define RF_SYNC_BYTE8_VALUE             0x00  // Default
-
-
-// RegPacketConfig1
-#define RF_PACKET1_FORMAT_FIXED             0x00  // Default
-#define RF_PACKET1_FORMAT_VARIABLE      0x80
-
-#define RF_PACKET1_DCFREE_OFF                   0x00  // Default
-#define RF_PACKET1_DCFREE_MANCHESTER    0x20
-#define RF_PACKET1_DCFREE_WHITENING     0x40
-
-#define RF_PACKET1_CRC_ON                         0x10  // Default
-#define RF_PACKET1_CRC_OFF                      0x00
-
-#define RF_PACKET1_CRCAUTOCLEAR_ON      0x00  // Default
-#define RF_PACKET1_CRCAUTOCLEAR_OFF     0x08
-
-#define RF_PACKET1_ADRSFILTERING_OFF                  0x00  // Default
-#define RF_PACKET1_ADRSFILTERING_NODE                 0x02
-#define RF_PACKET1_ADRSFILTERING_NODEBROADCAST  0x04
-
-
-// RegPayloadLength
-#define RF_PAYLOADLENGTH_VALUE                  0x40  // Default
-
-// RegBroadcastAdrs
-#define RF_BROADCASTADDRESS_VALUE               0x00
-
-
-// RegAutoModes
-#define RF_AUTOMODES_ENTER_OFF                        0x00  // Default
-#define RF_AUTOMODES_ENTER_FIFONOTEMPTY           0x20
-#define RF_AUTOMODES_ENTER_FIFOLEVEL                0x40
-#define RF_AUTOMODES_ENTER_CRCOK                      0x60
-#define RF_AUTOMODES_ENTER_PAYLOADREADY           0x80
-#define RF_AUTOMODES_ENTER_SYNCADRSMATCH          0xA0
-#define RF_AUTOMODES_ENTER_PACKETSENT               0xC0
-#define RF_AUTOMODES_ENTER_FIFOEMPTY                0xE0
-
-#define RF_AUTOMODES_EXIT_OFF                           0x00  // Default
-#define RF_AUTOMODES_EXIT_FIFOEMPTY               0x04
-#define RF_AUTOMODES_EXIT_FIFOLEVEL               0x08
-#define RF_AUTOMODES_EXIT_CRCOK                       0x0C
-#define RF_AUTOMODES_EXIT_PAYLOADREADY          0x10
-#define RF_AUTOMODES_EXIT_SYNCADRSMATCH           0x14
-#define RF_AUTOMODES_EXIT_PACKETSENT              0x18
-#define RF_AUTOMODES_EXIT_RXTIMEOUT                 0x1C
-
-#define RF_AUTOMODES_INTERMEDIATE_SLEEP           0x00  // Default
-#define RF_AUTOMODES_INTERMEDIATE_STANDBY         0x01
-#define RF_AUTOMODES_INTERMEDIATE_RECEIVER      0x02
-#define RF_AUTOMODES_INTERMEDIATE_TRANSMITTER   0x03
-
-
-// RegFifoThresh
-#define RF_FIFOTHRESH_TXSTART_FIFOTHRESH          0x00
-#define RF_FIFOTHRESH_TXSTART_FIFONOTEMPTY      0x80  // Default
-
-#define RF_FIFOTHRESH_VALUE                             0x0F  // Default
-
-
-// RegPacketConfig2
-#define RF_PACKET2_RXRESTARTDELAY_1BIT            0x00  // Default
-#define RF_PACKET2_RXRESTARTDELAY_2BITS           0x10
-#define RF_PACKET2_RXRESTARTDELAY_4BITS         0x20
-#define RF_PACKET2_RXRESTARTDELAY_8BITS         0x30
-#define RF_PACKET2_RXRESTARTDELAY_16BITS          0x40
-#define RF_PACKET2_RXRESTARTDELAY_32BITS        0x50
-#define RF_PACKET2_RXRESTARTDELAY_64BITS        0x60
-#define RF_PACKET2_RXRESTARTDELAY_128BITS         0x70
-#define RF_PACKET2_RXRESTARTDELAY_256BITS       0x80
-#define RF_PACKET2_RXRESTARTDELAY_512BITS       0x90
-#define RF_PACKET2_RXRESTARTDELAY_1024BITS      0xA0
-#define RF_PACKET2_RXRESTARTDELAY_2048BITS      0xB0
-#define RF_PACKET2_RXRESTARTDELAY_NONE            0xC0
-#define RF_PACKET2_RXRESTART                            0x04
-
-#define RF_PACKET2_AUTORXRESTART_ON                 0x02  // Default
-#define RF_PACKET2_AUTORXRESTART_OFF                0x00
-
-#define RF_PACKET2_AES_ON                                 0x01
-#define RF_PACKET2_AES_OFF                              0x00  // Default
-
-
-// RegAesKey1-16
-#define RF_AESKEY1_VALUE                        0x00  // Default
-#define RF_AESKEY2_VALUE                        0x00  // Default
-#define RF_AESKEY3_VALUE                        0x00  // Default
-#define RF_AESKEY4_VALUE                        0x00  // Default
-#define RF_AESKEY5_VALUE                        0x00  // Default
-#define RF_AESKEY6_VALUE                        0x00  // Default
-#define RF_AESKEY7_VALUE                        0x00  // Default
-#define RF_AESKEY8_VALUE                        0x00  // Default
-#define RF_AESKEY9_VALUE                        0x00  // Default
-#define RF_AESKEY10_VALUE                       0x00  // Default
-#define RF_AESKEY11_VALUE                       0x00  // Default
-#define RF_AESKEY12_VALUE                       0x00  // Default
-#define RF_AESKEY13_VALUE                       0x00  // Default
-#define RF_AESKEY14_VALUE                       0x00  // Default
-#define RF_AESKEY15_VALUE                       0x00  // Default
-#define RF_AESKEY16_VALUE                       0x00  // Default
-
-
-// RegTemp1
-#define RF_TEMP1_MEAS_START                 0x08
-#define RF_TEMP1_MEAS_RUNNING               0x04
-#define RF_TEMP1_ADCLOWPOWER_ON         0x01  // Default
-#define RF_TEMP1_ADCLOWPOWER_OFF        0x00
-
-// RegTestDagc
-#define RF_DAGC_NORMAL              0x00  // Reset value
-#define RF_DAGC_IMPROVED_LOWBETA1   0x20  //
-#define RF_DAGC_IMPROVED_LOWBETA0   0x30  // Recommended default
-
-
-class RFM69
-{
-public:
-
-    /// Constructor. You can have multiple instances, but each instance must have its own
-    /// interrupt and slave select pin. After constructing, you must call init() to initialise the intnerface
-    /// and the radio module
-    /// \param[in] slaveSelectPin the Arduino pin number of the output to use to select the RF22 before
-    /// accessing it. Defaults to the normal SS pin for your Arduino (D10 for Diecimila, Uno etc, D53 for Mega)
-    /// \param[in] interrupt The interrupt number to use. Default is interrupt 0 (Arduino input pin 2)
-    RFM69();
-  
-    /// Initialises this instance and the radio module connected to it.
-    /// The following steps are taken:
-    /// - Initialise the slave select pin and the SPI interface library
-    /// - Software reset the RF22 module
-    /// - Checks the connected RF22 module is either a RF22_DEVICE_TYPE_RX_TRX or a RF22_DEVICE_TYPE_TX
-    /// - Attaches an interrupt handler
-    /// - Configures the RF22 module
-    /// - Sets the frequncy to 434.0 MHz
-    /// - Sets the modem data rate to FSK_Rb2_4Fd36
-    /// \return  true if everything was successful
-    boolean        init();
-
-    /// Reads a single register from the RF22
-    /// \param[in] reg Register number, one of RF22_REG_*
-    /// \return The value of the register
-    uint8_t        spiRead(uint8_t reg);
-
-    /// Writes a single byte to the RF22
-    /// \param[in] reg Register number, one of RF22_REG_*
-    /// \param[in] val The value to write
-    void           spiWrite(uint8_t reg, uint8_t val);
-
-    /// Reads a number of consecutive registers from the RF22 using burst read mode
-    /// \param[in] reg Register number of the first register, one of RF22_REG_*
-    /// \param[in] dest Array to write the register values to. Must be at least len bytes
-    /// \param[in] len Number of bytes to read
-    void           spiBurstRead(uint8_t reg, uint8_t* dest, uint8_t len);
-
-    /// Write a number of consecutive registers using burst write mode
-    /// \param[in] reg Register number of the first register, one of RF22_REG_*
-    /// \param[in] src Array of new register values to write. Must be at least len bytes
-    /// \param[in] len Number of bytes to write
-    void           spiBurstWrite(uint8_t reg, const uint8_t* src, uint8_t len);
-
-    /// Sets the transmitter and receiver centre frequency
-    /// \param[in] centre Frequency in MHz. 240.0 to 960.0. Caution, some versions of RF22 and derivatives 
-    /// implemented more restricted frequency ranges.
-    /// \param[in] afcPullInRange Sets the AF Pull In Range in MHz. Defaults to 0.05MHz (50kHz). Range is 0.0 to 0.159375
-    /// for frequencies 240.0 to 480MHz, and 0.0 to 0.318750MHz for  frequencies 480.0 to 960MHz, 
-    /// \return true if the selected frquency centre + (fhch * fhs) is within range and the afcPullInRange is within range
-    boolean        setFrequency(float centre, float afcPullInRange = 0.05);
-    
-    /// Reads and returns the current RSSI value from register RF22_REG_26_RSSI. If you want to find the RSSI
-    /// of the last received message, use lastRssi() instead.
-    /// \return The current RSSI value 
-    int             rssiRead();
-
-    /// Reads and returns the current EZMAC value from register RF22_REG_31_EZMAC_STATUS
-    /// \return The current EZMAC value
-    uint8_t        ezmacStatusRead();
-
-    /// Sets the parameters for the RF22 Idle mode in register RF22_REG_07_OPERATING_MODE. 
-    /// Idle mode is the mode the RF22 will be in when not transmitting or receiving. The default idle mode 
-    /// is RF22_XTON ie READY mode. 
-    /// \param[in] mode Mask of mode bits, using RF22_SWRES, RF22_ENLBD, RF22_ENWT, 
-    /// RF22_X32KSEL, RF22_PLLON, RF22_XTON.
-    void           setMode(uint8_t mode);
-
-    /// If current mode is Rx or Tx changes it to Idle. If the transmitter or receiver is running, 
-    /// disables them.
-    void           setModeSleep();
-
-    /// If current mode is Tx or Idle, changes it to Rx. 
-    /// Starts the receiver in the RF22.
-    void           setModeRx();
-
-    /// If current mode is Rx or Idle, changes it to Rx. 
-    /// Starts the transmitter in the RF22.
-    void           setModeTx();
-
-    /// Returns the operating mode of the library.
-    /// \return the current mode, one of RF22_MODE_*
-    uint8_t        mode();
-
-    /// Sets the transmitter power output level in register RF22_REG_6D_TX_POWER.
-    /// Be a good neighbour and set the lowest power level you need.
-    /// After init(), the power wil be set to RF22_TXPOW_8DBM.
-    /// Caution: In some countries you may only select RF22_TXPOW_17DBM if you
-    /// are also using frequency hopping.
-    /// \param[in] power Transmitter power level, one of RF22_TXPOW_*
-    void           setTxPower(uint8_t power);
-
-    /// Starts the receiver and checks whether a received message is available.
-    /// This can be called multiple times in a timeout loop
-    /// \return true if a complete, valid message has been received and is able to be retrieved by
-    /// recv()
-    boolean        available();
-
-    /// Turns the receiver on if it not already on.
-    /// If there is a valid message available, copy it to buf and return true
-    /// else return false.
-    /// If a message is copied, *len is set to the length (Caution, 0 length messages are permitted).
-    /// You should be sure to call this function frequently enough to not miss any messages
-    /// It is recommended that you call it in your main loop.
-    /// \param[in] buf Location to copy the received message
-    /// \param[in,out] len Pointer to available space in buf. Set to the actual number of octets copied.
-    /// \return true if a valid message was copied to buf
-    boolean        recv(uint8_t* buf, uint8_t* len);
-
-    /// Waits until any previous transmit packet is finished being transmitted with waitPacketSent().
-    /// Then loads a message into the transmitter and starts the transmitter. Note that a message length
-    /// of 0 is NOT permitted. 
-    /// \param[in] data Array of data to be sent
-    /// \param[in] len Number of bytes of data to send (> 0)
-    /// \return true if the message length was valid and it was correctly queued for transmit
-    boolean        send(const uint8_t* data, uint8_t len);
-
-    /// Returns the RSSI (Receiver Signal Strength Indicator)
-    /// of the last received message. This measurement is taken when 
-    /// the preamble has been received. It is a (non-linear) measure of the received signal strength.
-    /// \return The RSSI
-    int             lastRssi();
-    void         isr0();
-
-protected:
-    
-    
-    /// This is a low level function to handle the interrupts for one instance of RF22.
-    /// Called automatically by isr0() and isr1()
-    /// Should not need to be called.
-    void         handleInterrupt();
-
-    /// Clears the receiver buffer.
-    /// Internal use only
-    void           clearRxBuf();
-
-    /// Clears the transmitter buffer
-    /// Internal use only
-    void           clearTxBuf();
-
-    /// Fills the transmitter buffer with the data of a mesage to be sent
-    /// \param[in] data Array of data bytes to be sent (1 to 255)
-    /// \param[in] len Number of data bytes in data (> 0)
-    /// \return true if the message length is valid
-    boolean           fillTxBuf(const uint8_t* data, uint8_t len);
-
-    /// Appends the transmitter buffer with the data of a mesage to be sent
-    /// \param[in] data Array of data bytes to be sent (0 to 255)
-    /// \param[in] len Number of data bytes in data
-    /// \return false if the resulting message would exceed RF22_MAX_MESSAGE_LEN, else true
-    boolean           appendTxBuf(const uint8_t* data, uint8_t len);
-
-    void        sendTxBuf();
-    
-    void        readRxBuf();
-
-    /// Start the transmission of the contents 
-    /// of the Tx buffer
-    void           startTransmit();
-
-    /// ReStart the transmission of the contents 
-    /// of the Tx buffer after a atransmission failure
-    void           restartTransmit();
-
-protected:
-    //GenericSPIClass*    _spi;
-
-    /// Low level interrupt service routine for RF22 connected to interrupt 0
-    //static void         isr0();
-
-    /// Low level interrupt service routine for RF22 connected to interrupt 1
-    //static void         isr1();
-private:    
-   
-    volatile uint8_t    _mode;
-
-    uint8_t             _sleepMode;
-    uint8_t             _idleMode;
-    uint8_t             _afterTxMode;
-    uint8_t          _slaveSelectPin;
-    //SPI                 _spi;
-    //InterruptIn         _interrupt;
-    uint8_t             _deviceType;
-
-    // These volatile members may get changed in the interrupt service routine
-    volatile uint8_t    _bufLen;
-    uint8_t             _buf[RFM69_MAX_MESSAGE_LEN];
-
-    volatile boolean    _rxBufValid;
-
-    volatile boolean    _txPacketSent;
-    volatile uint8_t    _txBufSentIndex;
-  
-    volatile uint16_t   _rxBad;
-    volatile uint16_t   _rxGood;
-    volatile uint16_t   _txGood;
-
-    volatile int        _lastRssi;
-};
-
-
-#endif 
+// RFM69.h
+// Author: Phil Crump (phildcrump@gmail.com)
+// Copyright (C) 2014 Phil Crump
+// Based on RF22.h
+// Author: Mike McCauley (mikem@open.com.au)
+// Copyright (C) 2011 Mike McCauley
+
+#ifndef RFM69_h
+#define RFM69_h
+
+#include "RFM69Platform.h"
+#include "RFM69Transport.h"
+
+#define boolean bool
+
+#define RFM69_SPI_WRITE_MASK 0x80
+
+// Crystal frequency. Bitrate, deviation and carrier registers are all in units of this,
+// the synthesiser step FSTEP is RFM69_FXOSC / 2^19 (61.035Hz)
+#define RFM69_FXOSC 32000000UL
+
+// This is the maximum message length that can be supported by this library. Limited by
+// the single message length octet in the header. 
+// Yes, 255 is correct even though the FIFO size in the RF22 is only
+// 64 octets. We use interrupts to refill the Tx FIFO during transmission and to empty the
+// Rx FIFO during reception
+// Can be pre-defined to a smaller size (to save SRAM) prior to including this header.
+// The queues hold RFM69_RX_QUEUE_LEN + RFM69_TX_QUEUE_LEN messages of this size, which
+// does not fit in the 2K of an ATmega328, so AVR builds default to a single FIFO's worth.
+#ifndef RFM69_MAX_MESSAGE_LEN
+#if defined(__AVR__)
+#define RFM69_MAX_MESSAGE_LEN 64
+#else
+#define RFM69_MAX_MESSAGE_LEN 255
+#endif
+#endif
+
+// Registers 0x00 to RFM69_SHADOW_SIZE - 1 are candidates for the register shadow cache.
+// That covers everything up to the end of the AES key, the test registers are always
+// accessed directly.
+#define RFM69_SHADOW_SIZE 0x50
+
+// When flushing the shadow, dirty registers separated by no more than this many clean
+// registers whose value is known are written in the same burst
+#define RFM69_SHADOW_MERGE_GAP 2
+
+// A message in the middle of being received is abandoned if the FIFO has not needed
+// draining for this many milliseconds, eg the radio dropped it on a CRC error
+#ifndef RFM69_RX_STREAM_TIMEOUT
+#define RFM69_RX_STREAM_TIMEOUT 250
+#endif
+
+// Mode the radio is left in when Listen mode wakes on a packet: RX to hear repeats and
+// replies at full sensitivity, or STDBY / SLEEP to handle one packet per wake up
+#ifndef RFM69_LISTEN_WAKE_MODE
+#define RFM69_LISTEN_WAKE_MODE RFM69_MODE_RX
+#endif
+
+// Number of external interrupts init() can attach DIO0 to
+#define RFM69_NUM_INTERRUPTS 3
+
+// Interrupt number meaning DIO0 (or DIO1) is not wired to an interrupt, isr0() (isr1()) is called
+// by the application
+#define RFM69_NO_INTERRUPT 0xFF
+
+// Define to run the bottom half of the interrupt handler (draining the FIFO) from the
+// application, by calling service(), instead of from isr0() with interrupts re-enabled
+//#define RFM69_DEFER_BOTTOM_HALF
+
+// Milliseconds init() waits before talking to the radio. The datasheet asks for 10ms after
+// power on reset; the rest lets the supply settle on boards that power the module up with
+// the microcontroller.
+#ifndef RFM69_POWER_ON_DELAY
+#define RFM69_POWER_ON_DELAY 100
+#endif
+
+// Max number of octets the RFM69 FIFO can hold
+#define RFM69_FIFO_SIZE 64
+
+// Number of received packets that can wait between the interrupt handler and recv().
+// Must be a power of 2. Each slot costs RFM69_MAX_MESSAGE_LEN + 6 bytes of SRAM.
+// Can be pre-defined to a smaller size (to save SRAM) prior to including this header
+#ifndef RFM69_RX_QUEUE_LEN
+#define RFM69_RX_QUEUE_LEN 4
+#endif
+
+#if (RFM69_RX_QUEUE_LEN & (RFM69_RX_QUEUE_LEN - 1)) != 0 || RFM69_RX_QUEUE_LEN > 128
+#error "RFM69_RX_QUEUE_LEN must be a power of 2, no larger than 128"
+#endif
+
+// Number of messages that can be queued for transmission by sendAsync(), including the
+// one on air. Must be a power of 2. Each slot costs RFM69_MAX_MESSAGE_LEN + 5 bytes of SRAM.
+// Can be pre-defined to a smaller size (to save SRAM) prior to including this header
+#ifndef RFM69_TX_QUEUE_LEN
+#define RFM69_TX_QUEUE_LEN 4
+#endif
+
+// A message that has not raised PACKETSENT this many milliseconds after it was started, eg
+// because the FIFO ran dry, is loaded and sent again by txPending(), up to RFM69_TX_RETRIES
+// times before it is dropped
+#ifndef RFM69_TX_TIMEOUT
+#define RFM69_TX_TIMEOUT 2000
+#endif
+#ifndef RFM69_TX_RETRIES
+#define RFM69_TX_RETRIES 2
+#endif
+
+// Milliseconds between the samples of RegRssiValue that available() takes in RX, between
+// packets, to estimate the noise floor
+#ifndef RFM69_NOISE_INTERVAL
+#define RFM69_NOISE_INTERVAL 100
+#endif
+
+// Milliseconds between the temperature and supply readings taken by housekeeping(), by
+// default, see setHousekeeping()
+#ifndef RFM69_HOUSEKEEPING_INTERVAL
+#define RFM69_HOUSEKEEPING_INTERVAL 60000UL
+#endif
+
+// RegTemp2 reads this less the die temperature in degrees C. It varies by a few degrees
+// from chip to chip, calibrate against a thermometer.
+#ifndef RFM69_TEMP_OFFSET
+#define RFM69_TEMP_OFFSET 165
+#endif
+
+// temperature() before the first reading
+#define RFM69_TEMP_UNKNOWN  (-128)
+
+// Listen before talk, see setLbt(). Before each message the transmitter waits a random
+// 1 to 2^BE slots of RFM69_LBT_SLOT ms in RX, then sends if the channel is clear. BE
+// starts at RFM69_LBT_MIN_BE and goes up by one, to RFM69_LBT_MAX_BE, each time the
+// channel is found busy. After RFM69_LBT_TRIES busy samples the message is sent anyway.
+#ifndef RFM69_LBT_SLOT
+#define RFM69_LBT_SLOT 10
+#endif
+#ifndef RFM69_LBT_MIN_BE
+#define RFM69_LBT_MIN_BE 2
+#endif
+#ifndef RFM69_LBT_MAX_BE
+#define RFM69_LBT_MAX_BE 5
+#endif
+#ifndef RFM69_LBT_TRIES
+#define RFM69_LBT_TRIES 6
+#endif
+
+// The channel is busy at this many dB over noiseFloor(), or at RFM69_LBT_THRESHOLD dBm
+// before there is a noise floor estimate, unless setLbt() is given a threshold
+#ifndef RFM69_LBT_MARGIN
+#define RFM69_LBT_MARGIN 10
+#endif
+#ifndef RFM69_LBT_THRESHOLD
+#define RFM69_LBT_THRESHOLD -90
+#endif
+
+// Address every node takes messages for as well as its own, unless setAddressFilter()
+// is told otherwise
+#define RFM69_BROADCAST_ADDRESS 0xFF
+
+// Longest message with AES on, see setEncryptionKey(). The radio encrypts the message
+// as a whole, so it has to go into the FIFO in one go.
+#define RFM69_AES_MAX_LEN (RFM69_FIFO_SIZE - 1)
+
+// Duty cycle limit, see setDutyCycle(). Airtime is counted in RFM69_DUTY_BUCKETS
+// buckets covering the window. A message that could not go on air within
+// RFM69_DUTY_MAX_DEFER ms of being queued is dropped as stale.
+#ifndef RFM69_DUTY_BUCKETS
+#define RFM69_DUTY_BUCKETS 13
+#endif
+#ifndef RFM69_DUTY_WINDOW
+#define RFM69_DUTY_WINDOW 3600000UL
+#endif
+#ifndef RFM69_DUTY_MAX_DEFER
+#define RFM69_DUTY_MAX_DEFER 60000UL
+#endif
+
+#if (RFM69_TX_QUEUE_LEN & (RFM69_TX_QUEUE_LEN - 1)) != 0 || RFM69_TX_QUEUE_LEN > 128
+#error "RFM69_TX_QUEUE_LEN must be a power of 2, no larger than 128"
+#endif
+
+#define RFM69_MODE_SLEEP    0x00 // 0.1uA
+#define RFM69_MODE_STDBY    0x04 // 1.25mA
+#define RFM69_MODE_RX       0x10 // 16mA
+#define RFM69_MODE_TX       0x0c // >33mA
+
+// Supply current in each mode in nA, from the figures above, for the power model.
+// RFM69_CURRENT_IDLE is Listen mode between receive windows, with only the RC oscillator running.
+#define RFM69_CURRENT_SLEEP 100UL
+#define RFM69_CURRENT_IDLE  1200UL
+#define RFM69_CURRENT_STDBY 1250000UL
+#define RFM69_CURRENT_RX    16000000UL
+#define RFM69_CURRENT_TX    33000000UL
+
+
+// These values we set for FIFO thresholds are actually the same as the POR values
+#define RF22_TXFFAEM_THRESHOLD 4
+#define RF22_RXFFAFULL_THRESHOLD 55
+
+
+// Register names
+
+#define RFM69_REG_00_FIFO           0x00
+#define RFM69_REG_01_OPMODE         0x01
+#define RFM69_REG_02_DATA_MODUL     0x02
+#define RFM69_REG_03_BITRATE_MSB    0x03
+#define RFM69_REG_04_BITRATE_LSB    0x04
+#define RFM69_REG_05_FDEV_MSB       0x05
+#define RFM69_REG_06_FDEV_LSB       0x06
+#define RFM69_REG_07_FRF_MSB        0x07
+#define RFM69_REG_08_FRF_MID        0x08
+#define RFM69_REG_09_FRF_LSB        0x09
+#define RFM69_REG_0A_OSC1           0x0A
+#define RFM69_REG_0B_AFC_CTRL       0x0B
+#define RFM69_REG_0C_LOWBAT         0x0C
+#define RFM69_REG_0D_LISTEN1        0x0D
+#define RFM69_REG_0E_LISTEN2        0x0E
+#define RFM69_REG_0F_LISTEN3        0x0F
+#define RFM69_REG_10_VERSION        0x10 //Version and serial number
+#define RFM69_REG_11_PA_LEVEL       0x11
+#define RFM69_REG_12_PA_RAMP        0x12
+#define RFM69_REG_13_OCP            0x13
+#define RFM69_REG_18_LNA            0x18
+#define RFM69_REG_19_RX_BW          0x19
+#define RFM69_REG_1A_AFC_BW         0x1A
+#define RFM69_REG_1B_OOK_PEAK       0x1B
+#define RFM69_REG_1C_OOK_AVG        0x1C
+#define RFM69_REG_1D_OOF_FIX        0x1D
+#define RFM69_REG_1E_AFC_FEI        0x1E
+#define RFM69_REG_1F_AFC_MSB        0x1F
+#define RFM69_REG_20_AFC_LSB        0x20
+#define RFM69_REG_21_FEI_MSB        0x21
+#define RFM69_REG_22_FEI_LSB        0x22
+#define RFM69_REG_23_RSSI_CONFIG    0x23
+#define RFM69_REG_24_RSSI_VALUE     0x24
+#define RFM69_REG_25_DIO_MAPPING1   0x25
+#define RFM69_REG_26_DIO_MAPPING2   0x26
+#define RFM69_REG_27_IRQ_FLAGS1     0x27
+#define RFM69_REG_28_IRQ_FLAGS2     0x28
+#define RFM69_REG_29_RSSI_THRESHOLD 0x29
+#define RFM69_REG_2A_RX_TIMEOUT1    0x2A
+#define RFM69_REG_2B_RX_TIMEOUT2    0x2B
+#define RFM69_REG_2C_PREAMBLE_MSB   0x2C
+#define RFM69_REG_2D_PREAMBLE_LSB   0x2D
+#define RFM69_REG_2E_SYNC_CONFIG    0x2E
+#define RFM69_REG_2F_SYNCVALUE1     0x2F
+#define RFM69_REG_30_SYNCVALUE2     0x30
+// Sync values 1-8 go here
+#define RFM69_REG_37_PACKET_CONFIG1 0x37
+#define RFM69_REG_38_PAYLOAD_LENGTH 0x38
+#define RFM69_REG_39_NODE_ADRS      0x39
+#define RFM69_REG_3A_BROADCAST_ADRS 0x3A
+#define RFM69_REG_3B_AUTOMODES      0x3B
+#define RFM69_REG_3C_FIFO_THRESHOLD 0x3C
+#define RFM69_REG_3D_PACKET_CONFIG2 0x3D
+#define RFM69_REG_3E_AES_KEY1       0x3E
+// AES Key 2-16 go here
+#define RFM69_REG_4E_TEMP1          0x4E
+#define RFM69_REG_4F_TEMP2          0x4F
+#define RFM69_REG_58_TEST_LNA       0x58
+#define RFM69_REG_5A_TEST_PA1       0x5A
+#define RFM69_REG_5C_TEST_PA2       0x5C
+#define RFM69_REG_6F_TEST_DAGC      0x6F
+#define RFM69_REG_71_TEST_AFC       0x71
+
+//******************************************************
+// RF69/SX1231 bit control definition
+//******************************************************
+// RegOpMode
+#define RF_OPMODE_SEQUENCER_OFF             0x80
+#define RF_OPMODE_SEQUENCER_ON              0x00  // Default
+
+#define RF_OPMODE_LISTEN_ON                     0x40
+#define RF_OPMODE_LISTEN_OFF                    0x00  // Default
+
+#define RF_OPMODE_LISTENABORT                   0x20
+
+#define RF_OPMODE_SLEEP                           0x00
+#define RF_OPMODE_STANDBY                         0x04  // Default
+#define RF_OPMODE_SYNTHESIZER                   0x08
+#define RF_OPMODE_TRANSMITTER                   0x0C
+#define RF_OPMODE_RECEIVER                      0x10
+
+// RegDataModul
+#define RF_DATAMODUL_DATAMODE_PACKET                  0x00  // Default
+#define RF_DATAMODUL_DATAMODE_CONTINUOUS            0x40
+#define RF_DATAMODUL_DATAMODE_CONTINUOUSNOBSYNC 0x60
+
+#define RF_DATAMODUL_MODULATIONTYPE_FSK             0x00  // Default
+#define RF_DATAMODUL_MODULATIONTYPE_OOK             0x08
+
+#define RF_DATAMODUL_MODULATIONSHAPING_00           0x00  // Default
+#define RF_DATAMODUL_MODULATIONSHAPING_01           0x01
+#define RF_DATAMODUL_MODULATIONSHAPING_10           0x02
+#define RF_DATAMODUL_MODULATIONSHAPING_11           0x03
+
+// RegOsc1
+#define RF_OSC1_RCCAL_START             0x80
+#define RF_OSC1_RCCAL_DONE              0x40
+
+// RegAfcCtrl
+#define RF_AFCLOWBETA_ON                    0x20
+#define RF_AFCLOWBETA_OFF                   0x00    // Default
+
+// RegLowBat
+#define RF_LOWBAT_MONITOR                   0x10
+#define RF_LOWBAT_ON                            0x08
+#define RF_LOWBAT_OFF                           0x00  // Default
+
+#define RF_LOWBAT_TRIM_1695             0x00
+#define RF_LOWBAT_TRIM_1764             0x01
+#define RF_LOWBAT_TRIM_1835             0x02  // Default
+#define RF_LOWBAT_TRIM_1905             0x03
+#define RF_LOWBAT_TRIM_1976             0x04
+#define RF_LOWBAT_TRIM_2045             0x05
+#define RF_LOWBAT_TRIM_2116             0x06
+#define RF_LOWBAT_TRIM_2185             0x07
+
+
+// RegListen1
+#define RF_LISTEN1_RESOL_64             0x50
+#define RF_LISTEN1_RESOL_4100           0xA0  // Default
+#define RF_LISTEN1_RESOL_262000     0xF0
+
+#define RF_LISTEN1_RESOL_IDLE_64        0x40
+#define RF_LISTEN1_RESOL_IDLE_4100      0x80  // Default
+#define RF_LISTEN1_RESOL_IDLE_262000    0xC0
+
+#define RF_LISTEN1_RESOL_RX_64          0x10  // Default
+#define RF_LISTEN1_RESOL_RX_4100        0x20
+#define RF_LISTEN1_RESOL_RX_262000      0x30
+
+#define RF_LISTEN1_CRITERIA_RSSI                  0x00  // Default
+#define RF_LISTEN1_CRITERIA_RSSIANDSYNC   0x08
+
+#define RF_LISTEN1_END_00                             0x00
+#define RF_LISTEN1_END_01                             0x02  // Default
+#define RF_LISTEN1_END_10                             0x04
+
+
+// RegListen2
+#define RF_LISTEN2_COEFIDLE_VALUE               0xF5 // Default
+
+// RegListen3
+#define RF_LISTEN3_COEFRX_VALUE                 0x20 // Default
+
+// RegPaLevel
+#define RF_PALEVEL_PA0_ON         0x80  // Default
+#define RF_PALEVEL_PA0_OFF      0x00
+#define RF_PALEVEL_PA1_ON           0x40
+#define RF_PALEVEL_PA1_OFF      0x00  // Default
+#define RF_PALEVEL_PA2_ON           0x20
+#define RF_PALEVEL_PA2_OFF      0x00  // Default
+
+
+// RegPaRamp
+#define RF_PARAMP_3400                      0x00
+#define RF_PARAMP_2000                      0x01
+#define RF_PARAMP_1000                      0x02
+#define RF_PARAMP_500                           0x03
+#define RF_PARAMP_250                           0x04
+#define RF_PARAMP_125                           0x05
+#define RF_PARAMP_100                           0x06
+#define RF_PARAMP_62                            0x07
+#define RF_PARAMP_50                            0x08
+#define RF_PARAMP_40                            0x09  // Default
+#define RF_PARAMP_31                            0x0A
+#define RF_PARAMP_25                            0x0B
+#define RF_PARAMP_20                            0x0C
+#define RF_PARAMP_15                            0x0D
+#define RF_PARAMP_12                            0x0E
+#define RF_PARAMP_10                            0x0F
+
+
+// RegOcp
+#define RF_OCP_OFF                              0x0F
+#define RF_OCP_ON                                 0x1A  // Default
+
+#define RF_OCP_TRIM_45                      0x00
+#define RF_OCP_TRIM_50                      0x01
+#define RF_OCP_TRIM_55                      0x02
+#define RF_OCP_TRIM_60                      0x03
+#define RF_OCP_TRIM_65                      0x04
+#define RF_OCP_TRIM_70                      0x05
+#define RF_OCP_TRIM_75                      0x06
+#define RF_OCP_TRIM_80                      0x07
+#define RF_OCP_TRIM_85                      0x08
+#define RF_OCP_TRIM_90                      0x09
+#define RF_OCP_TRIM_95                      0x0A
+#define RF_OCP_TRIM_100                     0x0B  // Default
+#define RF_OCP_TRIM_105                     0x0C
+#define RF_OCP_TRIM_110                     0x0D
+#define RF_OCP_TRIM_115                     0x0E
+#define RF_OCP_TRIM_120                     0x0F
+
+
+// RegAgcRef
+#define RF_AGCREF_AUTO_ON                   0x40  // Default
+#define RF_AGCREF_AUTO_OFF              0x00
+
+#define RF_AGCREF_LEVEL_MINUS80     0x00  // Default
+#define RF_AGCREF_LEVEL_MINUS81     0x01
+#define RF_AGCREF_LEVEL_MINUS82     0x02
+#define RF_AGCREF_LEVEL_MINUS83     0x03
+#define RF_AGCREF_LEVEL_MINUS84     0x04
+#define RF_AGCREF_LEVEL_MINUS85     0x05
+#define RF_AGCREF_LEVEL_MINUS86     0x06
+#define RF_AGCREF_LEVEL_MINUS87     0x07
+#define RF_AGCREF_LEVEL_MINUS88     0x08
+#define RF_AGCREF_LEVEL_MINUS89     0x09
+#define RF_AGCREF_LEVEL_MINUS90     0x0A
+#define RF_AGCREF_LEVEL_MINUS91     0x0B
+#define RF_AGCREF_LEVEL_MINUS92     0x0C
+#define RF_AGCREF_LEVEL_MINUS93     0x0D
+#define RF_AGCREF_LEVEL_MINUS94     0x0E
+#define RF_AGCREF_LEVEL_MINUS95     0x0F
+#define RF_AGCREF_LEVEL_MINUS96     0x10
+#define RF_AGCREF_LEVEL_MINUS97     0x11
+#define RF_AGCREF_LEVEL_MINUS98     0x12
+#define RF_AGCREF_LEVEL_MINUS99     0x13
+#define RF_AGCREF_LEVEL_MINUS100    0x14
+#define RF_AGCREF_LEVEL_MINUS101    0x15
+#define RF_AGCREF_LEVEL_MINUS102    0x16
+#define RF_AGCREF_LEVEL_MINUS103    0x17
+#define RF_AGCREF_LEVEL_MINUS104    0x18
+#define RF_AGCREF_LEVEL_MINUS105    0x19
+#define RF_AGCREF_LEVEL_MINUS106    0x1A
+#define RF_AGCREF_LEVEL_MINUS107    0x1B
+#define RF_AGCREF_LEVEL_MINUS108    0x1C
+#define RF_AGCREF_LEVEL_MINUS109    0x1D
+#define RF_AGCREF_LEVEL_MINUS110    0x1E
+#define RF_AGCREF_LEVEL_MINUS111    0x1F
+#define RF_AGCREF_LEVEL_MINUS112    0x20
+#define RF_AGCREF_LEVEL_MINUS113    0x21
+#define RF_AGCREF_LEVEL_MINUS114    0x22
+#define RF_AGCREF_LEVEL_MINUS115    0x23
+#define RF_AGCREF_LEVEL_MINUS116    0x24
+#define RF_AGCREF_LEVEL_MINUS117    0x25
+#define RF_AGCREF_LEVEL_MINUS118    0x26
+#define RF_AGCREF_LEVEL_MINUS119    0x27
+#define RF_AGCREF_LEVEL_MINUS120    0x28
+#define RF_AGCREF_LEVEL_MINUS121    0x29
+#define RF_AGCREF_LEVEL_MINUS122    0x2A
+#define RF_AGCREF_LEVEL_MINUS123    0x2B
+#define RF_AGCREF_LEVEL_MINUS124    0x2C
+#define RF_AGCREF_LEVEL_MINUS125    0x2D
+#define RF_AGCREF_LEVEL_MINUS126    0x2E
+#define RF_AGCREF_LEVEL_MINUS127    0x2F
+#define RF_AGCREF_LEVEL_MINUS128    0x30
+#define RF_AGCREF_LEVEL_MINUS129    0x31
+#define RF_AGCREF_LEVEL_MINUS130    0x32
+#define RF_AGCREF_LEVEL_MINUS131    0x33
+#define RF_AGCREF_LEVEL_MINUS132    0x34
+#define RF_AGCREF_LEVEL_MINUS133    0x35
+#define RF_AGCREF_LEVEL_MINUS134    0x36
+#define RF_AGCREF_LEVEL_MINUS135    0x37
+#define RF_AGCREF_LEVEL_MINUS136    0x38
+#define RF_AGCREF_LEVEL_MINUS137    0x39
+#define RF_AGCREF_LEVEL_MINUS138    0x3A
+#define RF_AGCREF_LEVEL_MINUS139    0x3B
+#define RF_AGCREF_LEVEL_MINUS140    0x3C
+#define RF_AGCREF_LEVEL_MINUS141    0x3D
+#define RF_AGCREF_LEVEL_MINUS142    0x3E
+#define RF_AGCREF_LEVEL_MINUS143    0x3F
+
+
+// RegAgcThresh1
+#define RF_AGCTHRESH1_SNRMARGIN_000     0x00
+#define RF_AGCTHRESH1_SNRMARGIN_001     0x20
+#define RF_AGCTHRESH1_SNRMARGIN_010     0x40
+#define RF_AGCTHRESH1_SNRMARGIN_011     0x60
+#define RF_AGCTHRESH1_SNRMARGIN_100     0x80
+#define RF_AGCTHRESH1_SNRMARGIN_101     0xA0  // Default
+#define RF_AGCTHRESH1_SNRMARGIN_110     0xC0
+#define RF_AGCTHRESH1_SNRMARGIN_111     0xE0
+
+#define RF_AGCTHRESH1_STEP1_0                   0x00
+#define RF_AGCTHRESH1_STEP1_1                   0x01
+#define RF_AGCTHRESH1_STEP1_2                   0x02
+#define RF_AGCTHRESH1_STEP1_3                   0x03
+#define RF_AGCTHRESH1_STEP1_4                   0x04
+#define RF_AGCTHRESH1_STEP1_5                   0x05
+#define RF_AGCTHRESH1_STEP1_6                   0x06
+#define RF_AGCTHRESH1_STEP1_7                   0x07
+#define RF_AGCTHRESH1_STEP1_8                   0x08
+#define RF_AGCTHRESH1_STEP1_9                   0x09
+#define RF_AGCTHRESH1_STEP1_10              0x0A
+#define RF_AGCTHRESH1_STEP1_11              0x0B
+#define RF_AGCTHRESH1_STEP1_12              0x0C
+#define RF_AGCTHRESH1_STEP1_13              0x0D
+#define RF_AGCTHRESH1_STEP1_14              0x0E
+#define RF_AGCTHRESH1_STEP1_15              0x0F
+#define RF_AGCTHRESH1_STEP1_16              0x10  // Default
+#define RF_AGCTHRESH1_STEP1_17              0x11
+#define RF_AGCTHRESH1_STEP1_18              0x12
+#define RF_AGCTHRESH1_STEP1_19              0x13
+#define RF_AGCTHRESH1_STEP1_20              0x14
+#define RF_AGCTHRESH1_STEP1_21              0x15
+#define RF_AGCTHRESH1_STEP1_22              0x16
+#define RF_AGCTHRESH1_STEP1_23              0x17
+#define RF_AGCTHRESH1_STEP1_24              0x18
+#define RF_AGCTHRESH1_STEP1_25              0x19
+#define RF_AGCTHRESH1_STEP1_26              0x1A
+#define RF_AGCTHRESH1_STEP1_27              0x1B
+#define RF_AGCTHRESH1_STEP1_28              0x1C
+#define RF_AGCTHRESH1_STEP1_29              0x1D
+#define RF_AGCTHRESH1_STEP1_30              0x1E
+#define RF_AGCTHRESH1_STEP1_31              0x1F
+
+
+// RegAgcThresh2
+#define RF_AGCTHRESH2_STEP2_0                   0x00
+#define RF_AGCTHRESH2_STEP2_1                   0x10
+#define RF_AGCTHRESH2_STEP2_2                   0x20
+#define RF_AGCTHRESH2_STEP2_3                   0x30  // XXX wrong -- Default
+#define RF_AGCTHRESH2_STEP2_4                   0x40
+#define RF_AGCTHRESH2_STEP2_5                   0x50
+#define RF_AGCTHRESH2_STEP2_6                   0x60
+#define RF_AGCTHRESH2_STEP2_7                   0x70    // default
+#define RF_AGCTHRESH2_STEP2_8                   0x80
+#define RF_AGCTHRESH2_STEP2_9                   0x90
+#define RF_AGCTHRESH2_STEP2_10              0xA0
+#define RF_AGCTHRESH2_STEP2_11              0xB0
+#define RF_AGCTHRESH2_STEP2_12              0xC0
+#define RF_AGCTHRESH2_STEP2_13              0xD0
+#define RF_AGCTHRESH2_STEP2_14              0xE0
+#define RF_AGCTHRESH2_STEP2_15              0xF0
+
+#define RF_AGCTHRESH2_STEP3_0                   0x00
+#define RF_AGCTHRESH2_STEP3_1                   0x01
+#define RF_AGCTHRESH2_STEP3_2                   0x02
+#define RF_AGCTHRESH2_STEP3_3                   0x03
+#define RF_AGCTHRESH2_STEP3_4                   0x04
+#define RF_AGCTHRESH2_STEP3_5                   0x05
+#define RF_AGCTHRESH2_STEP3_6                   0x06
+#define RF_AGCTHRESH2_STEP3_7                   0x07
+#define RF_AGCTHRESH2_STEP3_8                   0x08
+#define RF_AGCTHRESH2_STEP3_9                   0x09
+#define RF_AGCTHRESH2_STEP3_10              0x0A
+#define RF_AGCTHRESH2_STEP3_11              0x0B  // Default
+#define RF_AGCTHRESH2_STEP3_12              0x0C
+#define RF_AGCTHRESH2_STEP3_13              0x0D
+#define RF_AGCTHRESH2_STEP3_14              0x0E
+#define RF_AGCTHRESH2_STEP3_15              0x0F
+
+
+// RegAgcThresh3
+#define RF_AGCTHRESH3_STEP4_0                   0x00
+#define RF_AGCTHRESH3_STEP4_1                   0x10
+#define RF_AGCTHRESH3_STEP4_2                   0x20
+#define RF_AGCTHRESH3_STEP4_3                   0x30
+#define RF_AGCTHRESH3_STEP4_4                   0x40
+#define RF_AGCTHRESH3_STEP4_5                   0x50
+#define RF_AGCTHRESH3_STEP4_6                   0x60
+#define RF_AGCTHRESH3_STEP4_7                   0x70
+#define RF_AGCTHRESH3_STEP4_8                   0x80
+#define RF_AGCTHRESH3_STEP4_9                   0x90  // Default
+#define RF_AGCTHRESH3_STEP4_10              0xA0
+#define RF_AGCTHRESH3_STEP4_11              0xB0
+#define RF_AGCTHRESH3_STEP4_12              0xC0
+#define RF_AGCTHRESH3_STEP4_13              0xD0
+#define RF_AGCTHRESH3_STEP4_14              0xE0
+#define RF_AGCTHRESH3_STEP4_15              0xF0
+
+#define RF_AGCTHRESH3_STEP5_0                   0x00
+#define RF_AGCTHRESH3_STEP5_1                   0x01
+#define RF_AGCTHRESH3_STEP5_2                   0x02
+#define RF_AGCTHRESH3_STEP5_3                   0x03
+#define RF_AGCTHRESH3_STEP5_4                   0x04
+#define RF_AGCTHRESH3_STEP5_5                   0x05
+#define RF_AGCTHRESH3_STEP5_6                   0x06
+#define RF_AGCTHRESH3_STEP5_7                   0x07
+#define RF_AGCTHRES33_STEP5_8                   0x08
+#define RF_AGCTHRESH3_STEP5_9                   0x09
+#define RF_AGCTHRESH3_STEP5_10              0x0A
+#define RF_AGCTHRESH3_STEP5_11              0x0B  // Default
+#define RF_AGCTHRESH3_STEP5_12              0x0C
+#define RF_AGCTHRESH3_STEP5_13              0x0D
+#define RF_AGCTHRESH3_STEP5_14              0x0E
+#define RF_AGCTHRESH3_STEP5_15              0x0F
+
+
+// RegLna
+#define RF_LNA_ZIN_50                               0x00
+#define RF_LNA_ZIN_200                            0x80  // Default
+
+#define RF_LNA_LOWPOWER_OFF                     0x00  // Default
+#define RF_LNA_LOWPOWER_ON                      0x40
+
+#define RF_LNA_CURRENTGAIN                      0x38
+
+#define RF_LNA_GAINSELECT_AUTO              0x00  // Default
+#define RF_LNA_GAINSELECT_MAX                   0x01
+#define RF_LNA_GAINSELECT_MAXMINUS6     0x02
+#define RF_LNA_GAINSELECT_MAXMINUS12    0x03
+#define RF_LNA_GAINSELECT_MAXMINUS24    0x04
+#define RF_LNA_GAINSELECT_MAXMINUS36    0x05
+#define RF_LNA_GAINSELECT_MAXMINUS48    0x06
+
+
+// RegRxBw
+#define RF_RXBW_DCCFREQ_000                     0x00
+#define RF_RXBW_DCCFREQ_001                     0x20
+#define RF_RXBW_DCCFREQ_010                     0x40  // Default
+#define RF_RXBW_DCCFREQ_011                     0x60
+#define RF_RXBW_DCCFREQ_100                     0x80
+#define RF_RXBW_DCCFREQ_101                     0xA0
+#define RF_RXBW_DCCFREQ_110                     0xC0
+#define RF_RXBW_DCCFREQ_111                     0xE0
+
+#define RF_RXBW_MANT_16                           0x00
+#define RF_RXBW_MANT_20                           0x08
+#define RF_RXBW_MANT_24                           0x10  // Default
+
+#define RF_RXBW_EXP_0                               0x00
+#define RF_RXBW_EXP_1                           0x01
+#define RF_RXBW_EXP_2                           0x02
+#define RF_RXBW_EXP_3                               0x03
+#define RF_RXBW_EXP_4                           0x04
+#define RF_RXBW_EXP_5                           0x05  // Default
+#define RF_RXBW_EXP_6                             0x06
+#define RF_RXBW_EXP_7                             0x07
+
+
+// RegAfcBw
+#define RF_AFCBW_DCCFREQAFC_000             0x00
+#define RF_AFCBW_DCCFREQAFC_001             0x20
+#define RF_AFCBW_DCCFREQAFC_010             0x40
+#define RF_AFCBW_DCCFREQAFC_011             0x60
+#define RF_AFCBW_DCCFREQAFC_100             0x80  // Default
+#define RF_AFCBW_DCCFREQAFC_101             0xA0
+#define RF_AFCBW_DCCFREQAFC_110             0xC0
+#define RF_AFCBW_DCCFREQAFC_111             0xE0
+
+#define RF_AFCBW_MANTAFC_16                     0x00
+#define RF_AFCBW_MANTAFC_20                     0x08  // Default
+#define RF_AFCBW_MANTAFC_24                     0x10
+
+#define RF_AFCBW_EXPAFC_0                         0x00
+#define RF_AFCBW_EXPAFC_1                       0x01
+#define RF_AFCBW_EXPAFC_2                       0x02
+#define RF_AFCBW_EXPAFC_3                       0x03  // Default
+#define RF_AFCBW_EXPAFC_4                       0x04
+#define RF_AFCBW_EXPAFC_5                       0x05
+#define RF_AFCBW_EXPAFC_6                         0x06
+#define RF_AFCBW_EXPAFC_7                       0x07
+
+
+// RegOokPeak
+#define RF_OOKPEAK_THRESHTYPE_FIXED             0x00
+#define RF_OOKPEAK_THRESHTYPE_PEAK              0x40  // Default
+#define RF_OOKPEAK_THRESHTYPE_AVERAGE           0x80
+
+#define RF_OOKPEAK_PEAKTHRESHSTEP_000           0x00  // Default
+#define RF_OOKPEAK_PEAKTHRESHSTEP_001           0x08
+#define RF_OOKPEAK_PEAKTHRESHSTEP_010           0x10
+#define RF_OOKPEAK_PEAKTHRESHSTEP_011           0x18
+#define RF_OOKPEAK_PEAKTHRESHSTEP_100           0x20
+#define RF_OOKPEAK_PEAKTHRESHSTEP_101           0x28
+#define RF_OOKPEAK_PEAKTHRESHSTEP_110           0x30
+#define RF_OOKPEAK_PEAKTHRESHSTEP_111           0x38
+
+#define RF_OOKPEAK_PEAKTHRESHDEC_000            0x00  // Default
+#define RF_OOKPEAK_PEAKTHRESHDEC_001            0x01
+#define RF_OOKPEAK_PEAKTHRESHDEC_010            0x02
+#define RF_OOKPEAK_PEAKTHRESHDEC_011            0x03
+#define RF_OOKPEAK_PEAKTHRESHDEC_100            0x04
+#define RF_OOKPEAK_PEAKTHRESHDEC_101            0x05
+#define RF_OOKPEAK_PEAKTHRESHDEC_110            0x06
+#define RF_OOKPEAK_PEAKTHRESHDEC_111            0x07
+
+
+// RegOokAvg
+#define RF_OOKAVG_AVERAGETHRESHFILT_00      0x00
+#define RF_OOKAVG_AVERAGETHRESHFILT_01      0x40
+#define RF_OOKAVG_AVERAGETHRESHFILT_10      0x80  // Default
+#define RF_OOKAVG_AVERAGETHRESHFILT_11      0xC0
+
+
+// RegOokFix
+#define RF_OOKFIX_FIXEDTHRESH_VALUE             0x06  // Default
+
+
+// RegAfcFei
+#define RF_AFCFEI_FEI_DONE                          0x40
+#define RF_AFCFEI_FEI_START                         0x20
+#define RF_AFCFEI_AFC_DONE                          0x10
+#define RF_AFCFEI_AFCAUTOCLEAR_ON               0x08
+#define RF_AFCFEI_AFCAUTOCLEAR_OFF              0x00  // Default
+
+#define RF_AFCFEI_AFCAUTO_ON                        0x04
+#define RF_AFCFEI_AFCAUTO_OFF                       0x00  // Default
+
+#define RF_AFCFEI_AFC_CLEAR                         0x02
+#define RF_AFCFEI_AFC_START                         0x01
+
+// RegRssiConfig
+#define RF_RSSI_FASTRX_ON                             0x08
+#define RF_RSSI_FASTRX_OFF                          0x00  // Default
+#define RF_RSSI_DONE                                    0x02
+#define RF_RSSI_START                                   0x01
+
+
+// RegDioMapping1
+#define RF_DIOMAPPING1_DIO0_00                  0x00  // Default
+#define RF_DIOMAPPING1_DIO0_01                  0x40
+#define RF_DIOMAPPING1_DIO0_10                  0x80
+#define RF_DIOMAPPING1_DIO0_11                  0xC0
+
+#define RF_DIOMAPPING1_DIO1_00                      0x00  // Default
+#define RF_DIOMAPPING1_DIO1_01                  0x10
+#define RF_DIOMAPPING1_DIO1_10                  0x20
+#define RF_DIOMAPPING1_DIO1_11                  0x30
+
+#define RF_DIOMAPPING1_DIO2_00                  0x00  // Default
+#define RF_DIOMAPPING1_DIO2_01                  0x04
+#define RF_DIOMAPPING1_DIO2_10                  0x08
+#define RF_DIOMAPPING1_DIO2_11                  0x0C
+
+#define RF_DIOMAPPING1_DIO3_00                  0x00  // Default
+#define RF_DIOMAPPING1_DIO3_01                  0x01
+#define RF_DIOMAPPING1_DIO3_10                  0x02
+#define RF_DIOMAPPING1_DIO3_11                  0x03
+
+
+// RegDioMapping2
+#define RF_DIOMAPPING2_DIO4_00                  0x00  // Default
+#define RF_DIOMAPPING2_DIO4_01                  0x40
+#define RF_DIOMAPPING2_DIO4_10                  0x80
+#define RF_DIOMAPPING2_DIO4_11                  0xC0
+
+#define RF_DIOMAPPING2_DIO5_00                  0x00  // Default
+#define RF_DIOMAPPING2_DIO5_01                  0x10
+#define RF_DIOMAPPING2_DIO5_10                  0x20
+#define RF_DIOMAPPING2_DIO5_11                  0x30
+
+#define RF_DIOMAPPING2_CLKOUT_32                0x00
+#define RF_DIOMAPPING2_CLKOUT_16                0x01
+#define RF_DIOMAPPING2_CLKOUT_8                 0x02
+#define RF_DIOMAPPING2_CLKOUT_4                   0x03
+#define RF_DIOMAPPING2_CLKOUT_2                 0x04
+#define RF_DIOMAPPING2_CLKOUT_1                 0x05
+#define RF_DIOMAPPING2_CLKOUT_RC                0x06
+#define RF_DIOMAPPING2_CLKOUT_OFF                 0x07  // Default
+
+
+// RegIrqFlags1
+#define RF_IRQFLAGS1_MODEREADY                    0x80
+#define RF_IRQFLAGS1_RXREADY                        0x40
+#define RF_IRQFLAGS1_TXREADY                        0x20
+#define RF_IRQFLAGS1_PLLLOCK                        0x10
+#define RF_IRQFLAGS1_RSSI                             0x08
+#define RF_IRQFLAGS1_TIMEOUT                        0x04
+#define RF_IRQFLAGS1_AUTOMODE                       0x02
+#define RF_IRQFLAGS1_SYNCADDRESSMATCH           0x01
+
+// RegIrqFlags2
+#define RF_IRQFLAGS2_FIFOFULL                       0x80
+#define RF_IRQFLAGS2_FIFONOTEMPTY                 0x40
+#define RF_IRQFLAGS2_FIFOLEVEL                    0x20
+#define RF_IRQFLAGS2_FIFOOVERRUN                  0x10
+#define RF_IRQFLAGS2_PACKETSENT                   0x08
+#define RF_IRQFLAGS2_PAYLOADREADY                 0x04
+#define RF_IRQFLAGS2_CRCOK                          0x02
+#define RF_IRQFLAGS2_LOWBAT                         0x01
+
+// RegRssiThresh
+#define RF_RSSITHRESH_VALUE                         0xE4  // Default
+
+// RegRxTimeout1
+#define RF_RXTIMEOUT1_RXSTART_VALUE             0x00  // Default
+
+// RegRxTimeout2
+#define RF_RXTIMEOUT2_RSSITHRESH_VALUE      0x00  // Default
+
+// RegPreamble
+#define RF_PREAMBLESIZE_MSB_VALUE                 0x00  // Default
+#define RF_PREAMBLESIZE_LSB_VALUE                 0x03  // Default
+
+
+// RegSyncConfig
+#define RF_SYNC_ON                              0x80  // Default
+#define RF_SYNC_OFF                             0x00
+
+#define RF_SYNC_FIFOFILL_AUTO           0x00  // Default -- when sync interrupt occurs
+#define RF_SYNC_FIFOFILL_MANUAL     0x40
+
+#define RF_SYNC_SIZE_1                      0x00
+#define RF_SYNC_SIZE_2                      0x08
+#define RF_SYNC_SIZE_3                      0x10
+#define RF_SYNC_SIZE_4                      0x18  // Default
+#define RF_SYNC_SIZE_5                      0x20
+#define RF_SYNC_SIZE_6                      0x28
+#define RF_SYNC_SIZE_7                      0x30
+#define RF_SYNC_SIZE_8                      0x38
+
+#define RF_SYNC_TOL_0                           0x00  // Default
+#define RF_SYNC_TOL_1                           0x01
+#define RF_SYNC_TOL_2                           0x02
+#define RF_SYNC_TOL_3                           0x03
+#define RF_SYNC_TOL_4                           0x04
+#define RF_SYNC_TOL_5                           0x05
+#define RF_SYNC_TOL_6                           0x06
+#define RF_SYNC_TOL_7                           0x07
+
+
+// RegSyncValue1-8
+#define RF_SYNC_BYTE1_VALUE             0x00  // Default
+#define RF_SYNC_BYTE2_VALUE             0x00  // Default
+#define RF_SYNC_BYTE3_VALUE             0x00  // Default
+#define RF_SYNC_BYTE4_VALUE             0x00  // Default
+#define RF_SYNC_BYTE5_VALUE             0x00  // Default
+#define RF_SYNC_BYTE6_VALUE             0x00  // Default
+#define RF_SYNC_BYTE7_VALUE             0x00  // Default
+#define RF_SYNC_BYTE8_VALUE             0x00  // Default
+
+
+// RegPacketConfig1
+#define RF_PACKET1_FORMAT_FIXED             0x00  // Default
+#define RF_PACKET1_FORMAT_VARIABLE      0x80
+
+#define RF_PACKET1_DCFREE_OFF                   0x00  // Default
+#define RF_PACKET1_DCFREE_MANCHESTER    0x20
+#define RF_PACKET1_DCFREE_WHITENING     0x40
+
+#define RF_PACKET1_CRC_ON                         0x10  // Default
+#define RF_PACKET1_CRC_OFF                      0x00
+
+#define RF_PACKET1_CRCAUTOCLEAR_ON      0x00  // Default
+#define RF_PACKET1_CRCAUTOCLEAR_OFF     0x08
+
+#define RF_PACKET1_ADRSFILTERING_OFF                  0x00  // Default
+#define RF_PACKET1_ADRSFILTERING_NODE                 0x02
+#define RF_PACKET1_ADRSFILTERING_NODEBROADCAST  0x04
+
+
+// RegPayloadLength
+#define RF_PAYLOADLENGTH_VALUE                  0x40  // Default
+
+// RegBroadcastAdrs
+#define RF_BROADCASTADDRESS_VALUE               0x00
+
+
+// RegAutoModes
+#define RF_AUTOMODES_ENTER_OFF                        0x00  // Default
+#define RF_AUTOMODES_ENTER_FIFONOTEMPTY           0x20
+#define RF_AUTOMODES_ENTER_FIFOLEVEL                0x40
+#define RF_AUTOMODES_ENTER_CRCOK                      0x60
+#define RF_AUTOMODES_ENTER_PAYLOADREADY           0x80
+#define RF_AUTOMODES_ENTER_SYNCADRSMATCH          0xA0
+#define RF_AUTOMODES_ENTER_PACKETSENT               0xC0
+#define RF_AUTOMODES_ENTER_FIFOEMPTY                0xE0
+
+#define RF_AUTOMODES_EXIT_OFF                           0x00  // Default
+#define RF_AUTOMODES_EXIT_FIFOEMPTY               0x04
+#define RF_AUTOMODES_EXIT_FIFOLEVEL               0x08
+#define RF_AUTOMODES_EXIT_CRCOK                       0x0C
+#define RF_AUTOMODES_EXIT_PAYLOADREADY          0x10
+#define RF_AUTOMODES_EXIT_SYNCADRSMATCH           0x14
+#define RF_AUTOMODES_EXIT_PACKETSENT              0x18
+#define RF_AUTOMODES_EXIT_RXTIMEOUT                 0x1C
+
+#define RF_AUTOMODES_INTERMEDIATE_SLEEP           0x00  // Default
+#define RF_AUTOMODES_INTERMEDIATE_STANDBY         0x01
+#define RF_AUTOMODES_INTERMEDIATE_RECEIVER      0x02
+#define RF_AUTOMODES_INTERMEDIATE_TRANSMITTER   0x03
+
+
+// RegFifoThresh
+#define RF_FIFOTHRESH_TXSTART_FIFOTHRESH          0x00
+#define RF_FIFOTHRESH_TXSTART_FIFONOTEMPTY      0x80  // Default
+
+#define RF_FIFOTHRESH_VALUE                             0x0F  // Default
+
+
+// RegPacketConfig2
+#define RF_PACKET2_RXRESTARTDELAY_1BIT            0x00  // Default
+#define RF_PACKET2_RXRESTARTDELAY_2BITS           0x10
+#define RF_PACKET2_RXRESTARTDELAY_4BITS         0x20
+#define RF_PACKET2_RXRESTARTDELAY_8BITS         0x30
+#define RF_PACKET2_RXRESTARTDELAY_16BITS          0x40
+#define RF_PACKET2_RXRESTARTDELAY_32BITS        0x50
+#define RF_PACKET2_RXRESTARTDELAY_64BITS        0x60
+#define RF_PACKET2_RXRESTARTDELAY_128BITS         0x70
+#define RF_PACKET2_RXRESTARTDELAY_256BITS       0x80
+#define RF_PACKET2_RXRESTARTDELAY_512BITS       0x90
+#define RF_PACKET2_RXRESTARTDELAY_1024BITS      0xA0
+#define RF_PACKET2_RXRESTARTDELAY_2048BITS      0xB0
+#define RF_PACKET2_RXRESTARTDELAY_NONE            0xC0
+#define RF_PACKET2_RXRESTART                            0x04
+
+#define RF_PACKET2_AUTORXRESTART_ON                 0x02  // Default
+#define RF_PACKET2_AUTORXRESTART_OFF                0x00
+
+#define RF_PACKET2_AES_ON                                 0x01
+#define RF_PACKET2_AES_OFF                              0x00  // Default
+
+
+// RegAesKey1-16
+#define RF_AESKEY1_VALUE                        0x00  // Default
+#define RF_AESKEY2_VALUE                        0x00  // Default
+#define RF_AESKEY3_VALUE                        0x00  // Default
+#define RF_AESKEY4_VALUE                        0x00  // Default
+#define RF_AESKEY5_VALUE                        0x00  // Default
+#define RF_AESKEY6_VALUE                        0x00  // Default
+#define RF_AESKEY7_VALUE                        0x00  // Default
+#define RF_AESKEY8_VALUE                        0x00  // Default
+#define RF_AESKEY9_VALUE                        0x00  // Default
+#define RF_AESKEY10_VALUE                       0x00  // Default
+#define RF_AESKEY11_VALUE                       0x00  // Default
+#define RF_AESKEY12_VALUE                       0x00  // Default
+#define RF_AESKEY13_VALUE                       0x00  // Default
+#define RF_AESKEY14_VALUE                       0x00  // Default
+#define RF_AESKEY15_VALUE                       0x00  // Default
+#define RF_AESKEY16_VALUE                       0x00  // Default
+
+
+// RegTemp1
+#define RF_TEMP1_MEAS_START                 0x08
+#define RF_TEMP1_MEAS_RUNNING               0x04
+#define RF_TEMP1_ADCLOWPOWER_ON         0x01  // Default
+#define RF_TEMP1_ADCLOWPOWER_OFF        0x00
+
+// RegTestDagc
+#define RF_DAGC_NORMAL              0x00  // Reset value
+#define RF_DAGC_IMPROVED_LOWBETA1   0x20  //
+#define RF_DAGC_IMPROVED_LOWBETA0   0x30  // Recommended default
+
+
+/// A carrier frequency held as the three RegFrf bytes, MSB first, so that retuning
+/// needs no arithmetic. Build them with rfm69Channel() or RFM69_CHANNEL() from
+/// RFM69ConfigBuilder.h
+struct RFM69Channel
+{
+    uint8_t     frf[3];
+};
+
+// Buckets of RFM69Stats::dwellMs
+#define RFM69_STATS_SLEEP   0
+#define RFM69_STATS_STDBY   1   // Including FS
+#define RFM69_STATS_RX      2
+#define RFM69_STATS_TX      3
+#define RFM69_STATS_LISTEN  4
+#define RFM69_STATS_MODES   5
+
+// Histogram sizes of RFM69Stats::rssi and RFM69Stats::txLatency
+#define RFM69_STATS_RSSI_BINS       8
+#define RFM69_STATS_LATENCY_BINS    12
+
+/// Counters kept by the driver, see RFM69::stats()
+struct RFM69Stats
+{
+    uint16_t    rxGood;         ///< Messages received and queued
+    uint16_t    rxBad;          ///< Messages lost to a FIFO overrun or a CRC error
+    uint16_t    rxCrcErrors;    ///< Messages that failed the CRC, included in rxBad
+    uint16_t    rxOverflows;    ///< Messages dropped because the receive queue was full
+    uint16_t    txGood;         ///< Messages sent
+    uint16_t    txRestarts;     ///< Messages started again after RFM69_TX_TIMEOUT
+    uint16_t    txDropped;      ///< Messages given up on after RFM69_TX_RETRIES
+    uint16_t    txBackoffs;     ///< Times listen before talk found the channel busy
+    uint16_t    txForced;       ///< Messages sent on a busy channel after RFM69_LBT_TRIES
+    uint16_t    txDeferred;     ///< Messages held back to keep within the duty cycle
+    uint16_t    txExpired;      ///< Messages dropped as they could not be sent within the duty cycle
+    uint16_t    rxForeign;      ///< Messages for other addresses read from the radio only to be
+                                ///< thrown away, by address filtering on the host
+    uint32_t    rxWakeups;      ///< Interrupts handled in RX, two per message received
+    uint16_t    hkReadings;     ///< Temperature and supply readings taken by housekeeping()
+    uint16_t    hkDeferred;     ///< Times a reading was due but waited for a packet to finish
+    uint32_t    hkRxOffUs;      ///< Time the receiver was off for readings
+    uint32_t    spiTransactions; ///< Chip select assertions
+    uint32_t    spiBytes;       ///< Bytes clocked, including address bytes
+
+    /// Milliseconds spent in each mode, indexed by RFM69_STATS_*
+    uint32_t    dwellMs[RFM69_STATS_MODES];
+
+    /// Received messages by RSSI. Bin i counts -120 + 10i to -111 + 10i dBm,
+    /// the first and last bins also count everything below and above.
+    uint16_t    rssi[RFM69_STATS_RSSI_BINS];
+
+    /// Messages by time from starting the transmitter to PACKETSENT. Bin i counts
+    /// under 2^i ms, the last bin also counts everything longer.
+    uint16_t    txLatency[RFM69_STATS_LATENCY_BINS];
+};
+
+/// One piece of a message for RFM69::sendv()
+struct RFM69Segment
+{
+    const uint8_t*  data;
+    uint8_t         len;
+};
+
+class RFM69
+{
+public:
+
+    /// Constructor. You can have multiple instances, but each instance must have its own
+    /// interrupt and slave select pin. After constructing, you must call init() to initialise the intnerface
+    /// and the radio module. With several radios on one bus, see RFM69Scheduler.
+    /// \param[in] interrupt The interrupt number DIO0 is wired to, init() attaches isr0() to it.
+    /// Default is interrupt 0 (Arduino input pin 2). RFM69_NO_INTERRUPT to call isr0() yourself.
+    /// \param[in] slaveSelectPin the Arduino pin number of the output to use to select the RF22 before
+    /// accessing it. Defaults to D10, the normal SS pin for Diecimila, Uno etc
+    /// \param[in] interruptDio1 The interrupt number DIO1 is wired to, init() attaches isr1() to it
+    /// on CHANGE. Needed to send or receive messages longer than RFM69_FIFO_SIZE, which
+    /// otherwise underrun and are dropped. Eg 1 (Arduino input pin 3).
+#if defined(ARDUINO)
+    RFM69(uint8_t interrupt = 0, uint8_t slaveSelectPin = 10, uint8_t interruptDio1 = RFM69_NO_INTERRUPT);
+#endif
+
+    /// Constructor for a radio reached through some other SPI transport, such as
+    /// the host simulator RFM69Sim. The transport must outlive this instance.
+    /// \param[in] transport The bus the radio is connected to
+    /// \param[in] interrupt The interrupt number DIO0 is wired to, on Arduino only
+    /// \param[in] interruptDio1 The interrupt number DIO1 is wired to, on Arduino only
+    RFM69(RFM69Transport& transport, uint8_t interrupt = RFM69_NO_INTERRUPT,
+          uint8_t interruptDio1 = RFM69_NO_INTERRUPT);
+  
+    /// \return The bus this radio is reached through
+    RFM69Transport& transport() { return *_transport; }
+
+    /// Initialises this instance and the radio module connected to it.
+    /// The following steps are taken:
+    /// - Initialise the slave select pin and the SPI interface library
+    /// - Software reset the RF22 module
+    /// - Checks the connected RF22 module is either a RF22_DEVICE_TYPE_RX_TRX or a RF22_DEVICE_TYPE_TX
+    /// - Attaches an interrupt handler
+    /// - Configures the RF22 module
+    /// - Sets the frequncy to 434.0 MHz
+    /// - Sets the modem data rate to FSK_Rb2_4Fd36
+    /// \return  true if everything was successful
+    boolean        init();
+
+    /// Reads a single register from the RF22
+    /// \param[in] reg Register number, one of RF22_REG_*
+    /// \return The value of the register
+    uint8_t        spiRead(uint8_t reg);
+
+    /// Writes a single byte to the RF22
+    /// \param[in] reg Register number, one of RF22_REG_*
+    /// \param[in] val The value to write
+    void           spiWrite(uint8_t reg, uint8_t val);
+
+    /// Reads a number of consecutive registers from the RF22 using burst read mode
+    /// \param[in] reg Register number of the first register, one of RF22_REG_*
+    /// \param[in] dest Array to write the register values to. Must be at least len bytes
+    /// \param[in] len Number of bytes to read
+    void           spiBurstRead(uint8_t reg, uint8_t* dest, uint8_t len);
+
+    /// Write a number of consecutive registers using burst write mode
+    /// \param[in] reg Register number of the first register, one of RF22_REG_*
+    /// \param[in] src Array of new register values to write. Must be at least len bytes
+    /// \param[in] len Number of bytes to write
+    void           spiBurstWrite(uint8_t reg, const uint8_t* src, uint8_t len);
+
+    /// Reads a configuration register through the shadow cache. Registers that only
+    /// change when we write them are read over SPI once, after that the shadow copy is
+    /// returned. Status registers (FIFO, IRQ flags, RSSI, AFC/FEI, temperature) always
+    /// go to the radio.
+    /// \param[in] reg Register number, one of RFM69_REG_*
+    /// \return The value of the register
+    uint8_t        regRead(uint8_t reg);
+
+    /// Writes a configuration register through the shadow cache. The write is only
+    /// recorded, it reaches the radio on the next regFlush(). Writing the value the
+    /// register already holds costs nothing. Registers that are not cached are written
+    /// straight away.
+    /// \param[in] reg Register number, one of RFM69_REG_*
+    /// \param[in] val The value to write
+    void           regWrite(uint8_t reg, uint8_t val);
+
+    /// Sends every pending regWrite() to the radio. Runs of neighbouring registers are
+    /// merged into single burst writes.
+    void           regFlush();
+
+    /// Sets the transmitter and receiver centre frequency
+    /// \param[in] centre Frequency in MHz. 290.0 to 340.0, 424.0 to 510.0 or 862.0 to 1020.0
+    /// \param[in] afcPullInRange Sets the AF Pull In Range in MHz, by choosing the narrowest AFC
+    /// bandwidth (RegAfcBw) that covers it. Defaults to 0.05MHz (50kHz). Range is 0.0 to 0.5
+    /// \return true if the selected frequency centre is within range and the afcPullInRange is within range
+    /// This does float maths, use setChannel() with a precomputed RFM69Channel to hop quickly.
+    boolean        setFrequency(float centre, float afcPullInRange = 0.05);
+
+    /// Retunes to a precomputed carrier frequency with a single 3 byte burst to RegFrf.
+    /// Does nothing if the radio is already there. Any setFrequencyTrim() is added on.
+    /// \param[in] channel The channel, see rfm69Channel() and RFM69_CHANNEL() in RFM69ConfigBuilder.h
+    void           setChannel(const RFM69Channel& channel);
+    
+    /// Moves the carrier, on this channel and any set later, by a number of synthesiser steps
+    /// (FSTEP, 61Hz), to cancel the drift of the radio's own crystal. See RFM69DriftTracker.
+    /// \param[in] steps Correction, positive to tune higher
+    void           setFrequencyTrim(int16_t steps);
+
+    /// \return The correction set by setFrequencyTrim()
+    int16_t        frequencyTrim() const { return _frfTrim; }
+
+    /// Turns on automatic frequency correction at the start of every packet, and has the
+    /// interrupt handler read back the correction for each message it takes, see lastFei().
+    /// Packets are then heard up to the AFC bandwidth (setFrequency() afcPullInRange) away
+    /// rather than only within the receiver bandwidth. Costs one 3 byte read per message.
+    /// \param[in] on false to go back to a fixed receiver
+    void           setAfc(boolean on);
+
+    /// Reads and returns the current RSSI value from register RF22_REG_26_RSSI. If you want to find the RSSI
+    /// of the last received message, use lastRssi() instead.
+    /// \return The current RSSI value 
+    int             rssiRead();
+
+    /// Reads and returns the current EZMAC value from register RF22_REG_31_EZMAC_STATUS
+    /// \return The current EZMAC value
+    uint8_t        ezmacStatusRead();
+
+    /// Sets the parameters for the RF22 Idle mode in register RF22_REG_07_OPERATING_MODE. 
+    /// Idle mode is the mode the RF22 will be in when not transmitting or receiving. The default idle mode 
+    /// is RF22_XTON ie READY mode. 
+    /// \param[in] mode Mask of mode bits, using RF22_SWRES, RF22_ENLBD, RF22_ENWT, 
+    /// RF22_X32KSEL, RF22_PLLON, RF22_XTON.
+    void           setMode(uint8_t mode);
+
+    /// If current mode is Rx or Tx changes it to Idle. If the transmitter or receiver is running, 
+    /// disables them.
+    void           setModeSleep();
+
+    /// If current mode is Tx or Idle, changes it to Rx. 
+    /// Starts the receiver in the RF22.
+    void           setModeRx();
+
+    /// If current mode is Rx or Idle, changes it to Rx. 
+    /// Starts the transmitter in the RF22.
+    void           setModeTx();
+
+    /// Sets up the Listen mode duty cycle: the radio idles for idleUs, then opens a receive
+    /// window of rxUs, and repeats. Each time is rounded to the nearest the radio can do.
+    /// A packet is only caught if a window opens during its preamble. With
+    /// RF_LISTEN1_CRITERIA_RSSIANDSYNC the window must also last until the sync word has been
+    /// heard, with RF_LISTEN1_CRITERIA_RSSI any signal above RegRssiThresh keeps the receiver
+    /// on, so short windows catch the next packet of a burst instead.
+    /// \param[in] idleUs Time between receive windows in microseconds, 64 to 66810000
+    /// \param[in] rxUs Length of each receive window in microseconds, 64 to 66810000
+    /// \param[in] criteria RF_LISTEN1_CRITERIA_RSSI or RF_LISTEN1_CRITERIA_RSSIANDSYNC
+    /// \return false if either time is out of range
+    boolean        setListen(uint32_t idleUs, uint32_t rxUs,
+                             uint8_t criteria = RF_LISTEN1_CRITERIA_RSSIANDSYNC);
+
+    /// Puts the radio into Listen mode, duty cycling on its own as set by setListen().
+    /// A packet that wakes it is queued for recv() as usual and the radio is then taken out
+    /// of Listen mode into RFM69_LISTEN_WAKE_MODE. Call setModeListen() again to go back to sleep.
+    /// Any other mode change, including send(), also ends Listen mode.
+    void           setModeListen();
+
+    /// \return true while the radio is in Listen mode
+    boolean        listening();
+
+    /// Expected average supply current in Listen mode with the current setListen() timing,
+    /// from RFM69_CURRENT_IDLE and RFM69_CURRENT_RX. Time spent receiving packets is not included.
+    /// \return The current in nA
+    uint32_t       listenCurrent();
+
+    /// Returns the operating mode of the library.
+    /// \return the current mode, one of RF22_MODE_*. STDBY while in Listen mode.
+    uint8_t        mode();
+
+    /// Sets the transmitter power output level in register RFM69_REG_11_PA_LEVEL, using PA1 and PA2.
+    /// Be a good neighbour and set the lowest power level you need.
+    /// After init(), the power wil be set to 10dBm (10mW).
+    /// Caution: 869.4 to 869.65MHz allows up to 500mW ERP, other parts of the band much less.
+    /// \param[in] power Transmitter power level in dBm, clamped to 2 to 17
+    void           setTxPower(uint8_t power);
+
+    /// Starts the receiver and checks whether a received message is available.
+    /// This can be called multiple times in a timeout loop
+    /// \return true if a complete, valid message has been received and is able to be retrieved by
+    /// recv()
+    boolean        available();
+
+    /// Turns the receiver on if it not already on.
+    /// If there is a valid message available, copy the oldest one to buf and return true
+    /// else return false. Up to RFM69_RX_QUEUE_LEN messages are held between calls.
+    /// If a message is copied, *len is set to the length (Caution, 0 length messages are permitted).
+    /// You should be sure to call this function frequently enough to not miss any messages
+    /// It is recommended that you call it in your main loop.
+    /// \param[in] buf Location to copy the received message
+    /// \param[in,out] len Pointer to available space in buf. Set to the actual number of octets copied.
+    /// \return true if a valid message was copied to buf
+    boolean        recv(uint8_t* buf, uint8_t* len);
+
+    /// Lends the oldest received message to the caller in place, without copying it.
+    /// The message stays in the receive queue, and its slot cannot be reused, until
+    /// recvRelease() is called. Calling recvLease() again before then returns the same message.
+    /// \param[out] buf Set to point at the message
+    /// \param[out] len Set to the length of the message
+    /// \return true if a message was available
+    boolean        recvLease(const uint8_t** buf, uint8_t* len);
+
+    /// Hands the message from recvLease() back to the receive queue. Any pointer obtained
+    /// from recvLease() must not be used after this.
+    void           recvRelease();
+
+    /// Queues a message for transmission and starts the transmitter if it is not already running.
+    /// Same as sendAsync(). Note that a message length of 0 is NOT permitted. 
+    /// \param[in] data Array of data to be sent
+    /// \param[in] len Number of bytes of data to send (> 0)
+    /// \return true if the message length was valid and it was correctly queued for transmit
+    boolean        send(const uint8_t* data, uint8_t len);
+
+    /// Copies a message into the transmit queue and returns without waiting for it to be sent.
+    /// Queued messages are sent back to back from the interrupt handler, the receiver is only
+    /// restarted once the queue is empty.
+    /// \param[in] data Array of data to be sent
+    /// \param[in] len Number of bytes of data to send (> 0)
+    /// \return false if the queue is full or the message is too long
+    boolean        sendAsync(const uint8_t* data, uint8_t len);
+
+    /// Sends a message made of several pieces, eg a header, the sensor fields and the path,
+    /// each copied once straight into the transmit queue. Otherwise the same as sendAsync().
+    /// \param[in] segments The pieces, in order
+    /// \param[in] count Number of pieces
+    /// \return false if the queue is full, or the message is empty or too long
+    boolean        sendv(const RFM69Segment* segments, uint8_t count);
+
+    /// Starts composing a message in place in the transmit queue. Add to it with write()
+    /// and send it with endPacket(). Nothing else may be sent until then.
+    /// \return false if the queue is full
+    boolean        beginPacket();
+
+    /// Appends to the message started by beginPacket()
+    /// \param[in] data Bytes to append
+    /// \param[in] len Number of bytes
+    /// \return false if the message would become too long. It is then not sent.
+    boolean        write(const uint8_t* data, uint8_t len);
+
+    /// Appends a NUL terminated string to the message started by beginPacket()
+    boolean        write(const char* str);
+
+    /// Queues the message composed since beginPacket() for transmission
+    /// \return false if it is empty, or write() failed
+    boolean        endPacket();
+
+    /// Returns the number of messages queued for transmission, including the one on air.
+    /// Also restarts the message on air if it has taken longer than RFM69_TX_TIMEOUT, and
+    /// with listen before talk, starts the next one once its backoff is over. Call it
+    /// from the main loop while anything is queued.
+    /// \return 0 once everything has been sent
+    uint8_t        txPending();
+
+    /// Turns listen before talk on or off. When on, each message waits a random backoff
+    /// in RX and is only sent once the channel is clear, see RFM69_LBT_SLOT. Forwarding
+    /// repeaters that heard the same packet then pick different slots instead of colliding.
+    /// \param[in] on true to listen before talk
+    /// \param[in] threshold RSSI in dBm at which the channel is busy, or 0 to follow
+    /// noiseFloor() + RFM69_LBT_MARGIN
+    void            setLbt(boolean on, int threshold = 0);
+
+    /// Turns on the radio's AES-128 packet encryption, or turns it off. The key goes out in
+    /// the same burst as the AES bit, and from then on the radio encrypts each message
+    /// after its length (and address) byte as it is sent and decrypts each one received
+    /// before PAYLOADREADY, so the host does no crypto. Every node has to share the key.
+    /// Messages are limited to RFM69_AES_MAX_LEN bytes and padded to a multiple of 16 on
+    /// air. Call it between messages. See RFM69Aes for the same thing in software.
+    /// \param[in] key 16 bytes, or NULL to send in the clear
+    void            setEncryptionKey(const uint8_t* key);
+
+    /// \return true if setEncryptionKey() has turned AES on
+    boolean         encrypting() const { return _aes; }
+
+    /// Only takes messages whose first byte is this node's address, or the broadcast
+    /// address. Done inside the radio, the packet handler drops everything else before
+    /// it raises an interrupt or puts anything in the FIFO, and in Listen mode does not
+    /// even wake. The address byte is left at the start of received messages, and
+    /// sendTo() puts it there for sending.
+    /// \param[in] node This node's address, or -1 to turn filtering off
+    /// \param[in] broadcast Address to take as well, or -1 for none
+    /// \param[in] inRadio false to filter on the host instead, after reading each message
+    /// over SPI, counted in RFM69Stats::rxForeign. Only for comparison.
+    void            setAddressFilter(int node, int broadcast = RFM69_BROADCAST_ADDRESS, boolean inRadio = true);
+
+    /// Sends a message to one node, or to every node with RFM69_BROADCAST_ADDRESS, by
+    /// putting its address in front. Otherwise the same as sendAsync().
+    boolean         sendTo(uint8_t address, const uint8_t* data, uint8_t len);
+
+    /// Works out how long a message occupies the channel, from the bitrate, preamble, sync
+    /// word, packet format, AES, DC free encoding and CRC settings in the register shadow
+    /// \param[in] len Message length, as passed to send()
+    /// \return Time on air in microseconds
+    uint32_t        airtime(uint8_t len);
+
+    /// Limits the time spent transmitting, eg to the 10% allowed on 869.4-869.65MHz with
+    /// setDutyCycle(100). Messages that would go over the limit wait in the queue until
+    /// enough earlier airtime has left the window, see RFM69_DUTY_MAX_DEFER.
+    /// \param[in] permille Share of the window that may be spent transmitting, in 1/1000ths.
+    /// 0 or 1000 for no limit.
+    /// \param[in] windowMs Length of the rolling window in milliseconds, up to 4294967 / permille
+    void            setDutyCycle(uint16_t permille, uint32_t windowMs = RFM69_DUTY_WINDOW);
+
+    /// \return Microseconds spent transmitting in the current duty cycle window. Always 0
+    /// when there is no duty cycle limit.
+    uint32_t        airtimeUsed();
+
+    /// Samples the channel
+    /// \return false if a packet is being received, or the RSSI is at or over the
+    /// listen before talk threshold
+    boolean         channelClear();
+
+    /// Returns the RSSI (Receiver Signal Strength Indicator)
+    /// of the last received message. This measurement is taken when 
+    /// the sync word has been received. It is a (non-linear) measure of the received signal strength.
+    /// \return The RSSI
+    int             lastRssi();
+
+    /// Returns the background noise level, estimated from RegRssiValue sampled by available()
+    /// every RFM69_NOISE_INTERVAL ms while the receiver is waiting for a packet. The estimate
+    /// drops quickly to a quieter reading and rises slowly, so bursts of traffic barely move it.
+    /// \return The noise floor in dBm, or 0 before the first sample
+    int             noiseFloor();
+
+    /// Returns how far the last received message was above the noise floor
+    /// \return lastRssi() - noiseFloor() in dB, or 0 before the first noise sample
+    int             linkMargin();
+
+    /// Turns on housekeeping(): every intervalMs the die temperature is read and the supply
+    /// compared with one of the low battery thresholds. The temperature needs the radio in
+    /// STDBY for about 100us, so each reading waits for a gap with nothing being sent or
+    /// received, and is taken a step per call, without ever waiting for the radio.
+    /// \param[in] intervalMs Time between readings, 0 to turn housekeeping off
+    /// \param[in] lowBatTrim Threshold for lowBattery(), one of RF_LOWBAT_TRIM_*
+    void            setHousekeeping(uint32_t intervalMs = RFM69_HOUSEKEEPING_INTERVAL,
+                                    uint8_t lowBatTrim = RF_LOWBAT_TRIM_1835);
+
+    /// Takes the next step of a temperature and supply reading when one is due. Called by
+    /// available(), so by recv(). A node that does not receive calls it from its main loop.
+    void            housekeeping();
+
+    /// \return The die temperature in degrees C from the last reading, or RFM69_TEMP_UNKNOWN
+    int8_t          temperature();
+
+    /// Returns the supply voltage, found by comparing it with a different RF_LOWBAT_TRIM_*
+    /// threshold at each reading, moving up while above and down while below, so it settles
+    /// within a few readings and follows a slowly changing battery.
+    /// \return The highest threshold the supply is above, in mV (1695 to 2185), or 0 if it is
+    /// below all of them or not known yet
+    uint16_t        supplyMv();
+
+    /// \return true if the supply was last found below the setHousekeeping() threshold
+    boolean         lowBattery();
+
+    /// Writes the readings as UKHASnet data fields, eg "T21V1.97", to add to a packet. The
+    /// V field is left out when the supply is outside the 1.695 to 2.185V the radio can
+    /// compare it with, as on a regulated 3.3V supply.
+    /// \param[out] buf Where to write the fields, NUL terminated
+    /// \param[in] size Size of buf
+    /// \return Length written, 0 if there is nothing to report or it does not fit
+    uint8_t         housekeepingFields(char* buf, uint8_t size);
+
+    /// Sets the RSSI level that starts reception, and wakes the radio in Listen mode with
+    /// RF_LISTEN1_CRITERIA_RSSI, eg setRssiThreshold(noiseFloor() + 10)
+    /// \param[in] dbm Threshold in dBm, -127 to 0
+    void            setRssiThreshold(int dbm);
+
+    /// Returns the millis() time at which the last message returned by recv() was taken
+    /// out of the radio
+    /// \return The arrival timestamp in milliseconds
+    uint32_t        lastTimestamp();
+
+    /// Returns how far the last message returned by recv() was from the receiver's carrier,
+    /// as measured by the AFC with setAfc() on. A steady offset from every neighbour means
+    /// this radio's own crystal has drifted.
+    /// \return The offset in steps of FSTEP (61Hz), positive when the sender was higher,
+    /// or 0 with AFC off
+    int16_t         lastFei();
+
+    /// Returns the number of messages dropped because the receive queue was full when they
+    /// arrived. Call recv() more often, or raise RFM69_RX_QUEUE_LEN, if this grows.
+    /// \return The overflow count
+    uint16_t        rxOverflows();
+
+    /// Takes a consistent copy of the driver's counters, with the time in the current mode
+    /// included in dwellMs
+    /// \param[out] stats Set to the counters
+    void            stats(RFM69Stats& stats);
+
+    /// Zeroes all the counters
+    void            clearStats();
+
+    /// Interrupt service routine for DIO0, the top half: latches RegIrqFlags1 and 2 with a
+    /// timestamp, then runs service() with interrupts enabled again, unless
+    /// RFM69_DEFER_BOTTOM_HALF is defined. Attached by init(), or call it on a rising edge.
+    void         isr0();
+
+    /// Interrupt service routine for DIO1, which is mapped to FIFOLEVEL. Attached by init() when
+    /// the constructor is given interruptDio1, or call it on both edges. Messages longer than
+    /// the FIFO need it.
+    void         isr1();
+
+    /// The bottom half of the interrupt handler: drains the FIFO, queues received messages
+    /// and moves the transmitter on, for everything latched by isr0() and isr1() so far.
+    /// Does nothing if there is nothing latched, or if it is already running.
+    /// Only needs calling, from the main loop or a thread, with RFM69_DEFER_BOTTOM_HALF defined.
+    void         service();
+
+protected:
+    
+    
+    /// This is a low level function to handle the interrupts for one instance of RF22.
+    /// Acts on the flags latched by the top half. Called by service().
+    /// Should not need to be called.
+    void         handleInterrupt();
+
+    /// The top half: reads RegRssiValue and both IRQ flag registers in one burst and marks
+    /// them for service()
+    void         latchInterrupt();
+
+    /// Takes one noise floor sample, unless a packet is arriving
+    void         sampleNoise();
+
+    /// Sets what DIO0 signals, leaving DIO1 on FIFOLEVEL
+    /// \param[in] mapping RF_DIOMAPPING1_DIO0_10 for SYNCADDRESS in RX, 01 for PAYLOADREADY
+    /// or 00 for PACKETSENT in TX
+    void         mapDio0(uint8_t mapping);
+
+    /// Clears the receiver buffer.
+    /// Internal use only
+    void           clearRxBuf();
+
+    /// Clears the transmitter buffer, the free slot at the head of the transmit queue
+    /// Internal use only
+    void           clearTxBuf();
+
+    /// Fills the transmitter buffer with the data of a mesage to be sent
+    /// \param[in] data Array of data bytes to be sent (1 to 255)
+    /// \param[in] len Number of data bytes in data (> 0)
+    /// \return true if the message length is valid
+    boolean           fillTxBuf(const uint8_t* data, uint8_t len);
+
+    /// Appends the transmitter buffer with the data of a mesage to be sent
+    /// \param[in] data Array of data bytes to be sent (0 to 255)
+    /// \param[in] len Number of data bytes in data
+    /// \return false if the resulting message would exceed RF22_MAX_MESSAGE_LEN, else true
+    boolean           appendTxBuf(const uint8_t* data, uint8_t len);
+
+    /// Queues the message in the transmitter buffer and starts the transmitter if it is idle
+    void              queueTxBuf();
+
+    /// Loads as much of the message at the tail of the transmit queue into the FIFO as
+    /// will fit, starting with the length byte. Called again on FIFOLEVEL to top it up.
+    void        sendTxBuf();
+    
+    /// Drains len bytes from the FIFO into the message being received
+    /// \param[in] len Number of bytes, no more than are known to be in the FIFO
+    void        readRxBuf(uint8_t len);
+
+    /// Abandons any partly received message
+    void        resetRxStream();
+
+    /// Adds the time since the last call to the dwell time of the current mode
+    void        dwell();
+
+    /// Counts one SPI transaction of len bytes
+    void        busUsed(uint16_t len) { _stats.spiTransactions++; _stats.spiBytes += len; }
+
+    /// Records len bytes written directly to registers from reg onwards in the shadow
+    void        shadowUpdate(uint8_t reg, const uint8_t* src, uint8_t len);
+
+    /// \return val as the shadow holds it for reg, with write-only trigger bits removed
+    uint8_t     shadowValue(uint8_t reg, uint8_t val);
+
+    /// Start the transmission of the contents 
+    /// of the Tx buffer
+    void           startTransmit();
+
+    /// Starts the message at the tail of the queue, once the duty cycle has room for it and
+    /// after a backoff with listen before talk. Drops messages that cannot be sent in time.
+    void           tryTransmit();
+
+    /// Moves the duty cycle window on to now
+    void           dutyAdvance();
+
+    /// \param[in] us Airtime of the next message
+    /// \param[out] freeAt If there is no room, the millis() at which there will be, or 0 for never
+    /// \return true if the message can be sent now without going over the duty cycle
+    boolean        dutyRoom(uint32_t us, uint32_t* freeAt);
+
+    /// Listens for a random number of slots before trying to send the message at the tail of
+    /// the queue, more of them the more times the channel has been found busy
+    void           backoff();
+
+    /// ReStart the transmission of the contents 
+    /// of the Tx buffer after a atransmission failure.
+    /// Reloads the message at the tail of the queue from the start, or drops it after
+    /// RFM69_TX_RETRIES attempts.
+    void           restartTransmit();
+
+protected:
+    //GenericSPIClass*    _spi;
+
+    /// Low level interrupt service routine for RF22 connected to interrupt 0
+    //static void         isr0();
+
+    /// Low level interrupt service routine for RF22 connected to interrupt 1
+    //static void         isr1();
+private:    
+    /// Common part of the constructors
+    void                construct();
+
+    volatile uint8_t    _mode;
+    volatile boolean    _listen;
+    uint8_t             _interrupt;
+    uint8_t             _interruptDio1;
+
+    // Latched by the top half for the bottom half
+    volatile boolean    _irqPending;
+    volatile boolean    _inService;
+    volatile uint8_t    _irqFlags1;
+    volatile uint8_t    _irqFlags2;
+    volatile int8_t     _irqRssi;           // RegRssiValue in dBm
+    volatile uint32_t   _irqAt;             // millis() when the flags were latched
+
+    // In RX, DIO0 signals SYNCADDRESS until a packet starts, so that its RSSI can be taken
+    // while it is on air, then PAYLOADREADY
+    volatile boolean    _dio0Sync;
+    volatile int8_t     _syncRssi;
+    volatile boolean    _syncRssiValid;     // _syncRssi belongs to the packet now on air
+
+    int16_t             _noiseFloor;        // 1/16 dB
+    boolean             _noiseValid;
+    uint32_t            _noiseAt;           // millis() of the last sample
+
+    // Housekeeping, see housekeeping()
+    uint8_t             _hkState;
+    uint32_t            _hkInterval;        // 0 for off
+    uint32_t            _hkAt;              // millis() of the last reading
+    uint32_t            _hkStartedAt;       // micros() the receiver was turned off
+    uint8_t             _hkResume;          // Mode to go back to
+    boolean             _hkWaiting;         // Due, and counted in hkDeferred
+    uint8_t             _hkTrim;            // RF_LOWBAT_TRIM_* being compared with
+    uint8_t             _hkLowTrim;
+    uint8_t             _hkSupply;          // Thresholds the supply is above, 0xFF unknown
+    int8_t              _temperature;
+
+    uint8_t             _sleepMode;
+    uint8_t             _idleMode;
+    uint8_t             _afterTxMode;
+    RFM69Transport*     _transport;
+#if defined(ARDUINO)
+    RFM69SPITransport   _defaultTransport;
+#endif
+    //SPI                 _spi;
+    //InterruptIn         _interrupt;
+
+    // Shadow copy of the configuration registers, with a bit per register for
+    // "value known" and "written but not flushed"
+    uint8_t             _shadow[RFM69_SHADOW_SIZE];
+    uint8_t             _shadowValid[RFM69_SHADOW_SIZE / 8];
+    uint8_t             _shadowDirty[RFM69_SHADOW_SIZE / 8];
+    uint8_t             _deviceType;
+
+    /// One received message waiting in the receive queue
+    struct RxSlot
+    {
+        uint8_t         len;
+        int8_t          rssi;
+        int16_t         fei;            // RegAfcValue, with setAfc() on
+        uint32_t        timestamp;
+        uint8_t         data[RFM69_MAX_MESSAGE_LEN];
+    };
+
+    /// One message in the transmit queue
+    struct TxSlot
+    {
+        uint8_t         len;
+        uint32_t        queuedAt;       // millis()
+        uint8_t         data[RFM69_MAX_MESSAGE_LEN];
+    };
+
+    // Single producer (sendAsync) / single consumer (handleInterrupt) ring of messages to send.
+    // The slot at _txHead is the one being filled by appendTxBuf(), it is queued by advancing _txHead.
+    TxSlot              _txQueue[RFM69_TX_QUEUE_LEN];
+    volatile uint8_t    _txHead;
+    volatile uint8_t    _txTail;
+    volatile boolean    _txBusy;
+    volatile uint32_t   _txStartedAt;       // millis() when the tail message was started
+    uint8_t             _txRetries;
+
+    // Listen before talk and duty cycle. While _txWait is not TX_WAIT_NONE the tail message
+    // is claimed but not started, txPending() carries on with it at _txWaitUntil.
+    boolean             _lbt;
+    int8_t              _lbtThreshold;      // dBm, 0 to follow the noise floor
+    boolean             _aes;
+    boolean             _afc;
+    RFM69Channel        _channel;           // As last set, before _frfTrim
+    int16_t             _frfTrim;
+    boolean             _addressHost;       // Filtering on the host, see setAddressFilter()
+    uint8_t             _nodeAddress;
+    int16_t             _broadcastAddress;  // -1 for none
+    volatile uint8_t    _txWait;
+    volatile uint32_t   _txWaitUntil;
+    volatile uint8_t    _lbtTries;          // Busy samples for the tail message
+    uint16_t            _lbtSeed;
+
+    // Airtime in microseconds per bucket of _dutyBucketLen ms, the current one being
+    // _dutyBucket, which started at _dutyBucketAt
+    uint16_t            _dutyPermille;      // 0 for no limit
+    uint32_t            _dutyBudget;
+    uint32_t            _dutyBucketLen;
+    uint32_t            _dutyBuckets[RFM69_DUTY_BUCKETS];
+    uint8_t             _dutyBucket;
+    uint32_t            _dutyBucketAt;
+    uint32_t            _dutyUsed;
+    boolean             _txComposing;       // beginPacket() called, endPacket() not yet
+    boolean             _txComposeFailed;
+
+    // Single producer (handleInterrupt) / single consumer (recv) ring of received messages.
+    // _rxHead is only written by the producer and _rxTail only by the consumer, both are
+    // free running and taken modulo RFM69_RX_QUEUE_LEN.
+    RxSlot              _rxQueue[RFM69_RX_QUEUE_LEN];
+    volatile uint8_t    _rxHead;
+    volatile uint8_t    _rxTail;
+    uint32_t            _lastTimestamp;
+    int16_t             _lastFei;
+
+    volatile boolean    _txPacketSent;
+    volatile uint8_t    _txBufSentIndex;   // Bytes of the tail message written to the FIFO
+
+    // Message being drained from the FIFO while still on air
+    volatile boolean    _rxStreaming;
+    volatile boolean    _rxStreamDiscard;  // No free slot, the message is read and dropped
+    volatile uint8_t    _rxStreamLen;
+    volatile uint8_t    _rxStreamPos;
+    uint32_t            _rxStreamAt;
+  
+    RFM69Stats          _stats;
+    uint32_t            _modeSince;         // micros() when dwell() was last called
+    uint16_t            _dwellUs[RFM69_STATS_MODES]; // Sub-millisecond remainders
+
+    volatile int        _lastRssi;
+};
+
+
+#endif 
@@ -0,0 +1,122 @@
+// address_bench.cpp
+//
+// Copyright (C) 2026 the UKHASnet_rfm69 contributors
+//
+// Puts a node on a busy channel where most messages are addressed to someone
+// else, and compares taking everything, filtering addresses on the host after
+// reading each message, and leaving the filtering to the radio's packet
+// handler. Every run must deliver exactly the messages for this node and the
+// broadcasts. Build and run from the library root:
+//
+//   g++ -O2 -I. *.cpp extras/host/address_bench.cpp -o address_bench && ./address_bench
+
+#include <stdio.h>
+#include "RFM69Sim.h"
+
+#define NODE        0x05
+#define MESSAGES    2000
+
+static RFM69Sim sim(8000000);
+static RFM69 radio(sim);
+
+static void dio0Handler(void*)
+{
+    radio.isr0();
+}
+
+struct Result
+{
+    uint32_t    delivered;
+    uint32_t    wanted;
+    uint32_t    wakeups;
+    uint32_t    transactions;
+    uint32_t    bytes;
+    uint32_t    foreign;
+    uint32_t    filtered;
+    boolean     exact;
+};
+
+// mode 0: no filtering, 1: on the host, 2: in the radio
+static Result run(uint8_t mode)
+{
+    Result r;
+    memset(&r, 0, sizeof(r));
+    r.exact = true;
+    sim.reset();
+    if (!radio.init()) {
+        printf("init failed\n");
+        r.exact = false;
+        return r;
+    }
+    if (mode)
+        radio.setAddressFilter(NODE, RFM69_BROADCAST_ADDRESS, mode == 2);
+    radio.setModeRx();
+    radio.clearStats();
+    sim.clearStats();
+
+    // 80% to the other 30 nodes, 10% to this one, 10% broadcast
+    uint32_t seed = 1;
+    for (uint16_t i = 0; i < MESSAGES; i++) {
+        seed = seed * 1103515245 + 12345;
+        uint8_t pick = (seed >> 16) % 10;
+        uint8_t msg[40];
+        uint8_t len = 8 + (seed >> 8) % 32;
+        msg[0] = pick == 0 ? NODE : pick == 1 ? RFM69_BROADCAST_ADDRESS : 0x10 + (seed >> 20) % 30;
+        for (uint8_t j = 1; j < len; j++)
+            msg[j] = (uint8_t)(i + j);
+        boolean wanted = msg[0] == NODE || msg[0] == RFM69_BROADCAST_ADDRESS;
+        r.wanted += wanted;
+        sim.air(msg, len, -70);
+        sim.advance(sim.airtime(len) + 2000000);
+
+        uint8_t got[RFM69_MAX_MESSAGE_LEN];
+        uint8_t gotLen = sizeof(got);
+        boolean any = false;
+        while (radio.recv(got, &gotLen)) {
+            any = true;
+            r.delivered++;
+            if (!(mode ? wanted : true) || gotLen != len || memcmp(got, msg, len) != 0)
+                r.exact = false;
+            gotLen = sizeof(got);
+        }
+        if (any != (mode ? wanted : true))
+            r.exact = false;
+    }
+    RFM69Stats stats;
+    radio.stats(stats);
+    r.wakeups = stats.rxWakeups;
+    r.foreign = stats.rxForeign;
+    r.transactions = sim.stats().transactions;
+    r.bytes = sim.stats().bytes;
+    r.filtered = sim.stats().rxFiltered;
+    return r;
+}
+
+int main()
+{
+    sim.attachInterrupt(0, dio0Handler, NULL);
+    rfm69SetHostClock(&sim);
+
+    static const char* names[] = { "none", "host", "radio" };
+    Result results[3];
+    boolean ok = true;
+    printf("%d messages, node 0x%02X\n\n", MESSAGES, NODE);
+    printf("%-6s %9s %8s %8s %12s %10s %8s %8s\n", "filter", "delivered", "wanted", "wakeups", "transactions",
+           "SPI bytes", "foreign", "filtered");
+    for (uint8_t mode = 0; mode < 3; mode++) {
+        Result& r = results[mode];
+        r = run(mode);
+        printf("%-6s %9u %8u %8u %12u %10u %8u %8u %s\n", names[mode], r.delivered, r.wanted, r.wakeups,
+               r.transactions, r.bytes, r.foreign, r.filtered, r.exact ? "" : "WRONG");
+        ok = ok && r.exact;
+    }
+    const Result& host = results[1];
+    const Result& inRadio = results[2];
+    printf("\nin the radio saves %.0f%% of wakeups and %.0f%% of SPI bytes against the host\n",
+           100.0 * (host.wakeups - inRadio.wakeups) / host.wakeups,
+           100.0 * (host.bytes - inRadio.bytes) / host.bytes);
+    ok = ok && inRadio.delivered == inRadio.wanted && inRadio.foreign == 0
+        && inRadio.filtered == MESSAGES - inRadio.wanted && host.foreign == MESSAGES - host.wanted
+        && inRadio.wakeups < host.wakeups && inRadio.bytes < host.bytes;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,175 @@
+// housekeeping_bench.cpp
+//
+// Copyright (C) 2026 the UKHASnet_rfm69 contributors
+//
+// A node receiving on a busy channel reads its temperature and supply once a
+// second for ten minutes, while the temperature climbs from -10 to 40C and the
+// battery runs down from 2.3 to 1.8V. Compares housekeeping(), which waits for a
+// gap between packets and never waits for the radio, with doing it the obvious
+// way: STDBY, start the measurement, spin until it is done, back to RX. Reports
+// packets lost, the longest the main loop was held up, and the readings. Build
+// and run from the library root:
+//
+//   g++ -O2 -I. *.cpp extras/host/housekeeping_bench.cpp -o housekeeping_bench && ./housekeeping_bench
+
+#include <stdio.h>
+#include "RFM69Sim.h"
+
+#define RUN_MS      600000
+#define STEP_NS     100000  // Main loop period
+#define INTERVAL_MS 1000
+
+static RFM69Sim sim(8000000);
+static RFM69 radio(sim);
+
+static void dio0Handler(void*)
+{
+    radio.isr0();
+}
+
+struct Result
+{
+    uint32_t    sent;
+    uint32_t    received;
+    uint32_t    readings;
+    uint32_t    worstLoopUs;
+    uint32_t    rxOffUs;
+    uint32_t    deferred;
+    uint32_t    tempErrors;     // Readings more than 1C out
+    uint32_t    supplyErrors;   // supplyMv() above the supply, or lowBattery() wrong, once settled
+    char        fields[16];
+};
+
+// The obvious way, for comparison
+static void blockingReading(int8_t* temperature)
+{
+    radio.setMode(RFM69_MODE_STDBY);
+    radio.spiWrite(RFM69_REG_4E_TEMP1, RF_TEMP1_MEAS_START | RF_TEMP1_ADCLOWPOWER_ON);
+    while (radio.spiRead(RFM69_REG_4E_TEMP1) & RF_TEMP1_MEAS_RUNNING)
+        delayMicroseconds(10);
+    *temperature = (int8_t)(RFM69_TEMP_OFFSET - (int)radio.spiRead(RFM69_REG_4F_TEMP2));
+    radio.setModeRx();
+}
+
+static Result run(boolean stateMachine)
+{
+    Result r;
+    memset(&r, 0, sizeof(r));
+    sim.reset();
+    radio.init();
+    radio.clearStats();
+    if (stateMachine)
+        radio.setHousekeeping(INTERVAL_MS, RF_LOWBAT_TRIM_1835);
+    radio.setModeRx();
+
+    uint32_t seed = 7;
+    uint64_t start = sim.now();
+    uint64_t nextPacket = start + 5000000;
+    uint64_t nextBlocking = start;
+    uint32_t lastReadings = 0;
+    int8_t blockingTemp = RFM69_TEMP_UNKNOWN;
+    while (sim.now() - start < (uint64_t)RUN_MS * 1000000) {
+        double progress = (double)(sim.now() - start) / ((uint64_t)RUN_MS * 1000000);
+        int celsius = -10 + (int)(50 * progress);
+        uint16_t mv = 2300 - (uint16_t)(500 * progress);
+        sim.setTemperature(celsius);
+        sim.setSupply(mv);
+
+        // About 45% of the time on air, in packets of 20 to 40 bytes
+        if (sim.now() + STEP_NS >= nextPacket) {
+            seed = seed * 1103515245 + 12345;
+            uint8_t packet[40];
+            uint8_t len = 20 + (seed >> 16) % 21;
+            memset(packet, 'a' + r.sent % 26, len);
+            sim.air(packet, len, -80, nextPacket);
+            r.sent++;
+            nextPacket += sim.airtime(len) + 20000000 + (uint64_t)((seed >> 8) % 300) * 1000000;
+        }
+        sim.advance(STEP_NS);
+
+        uint64_t before = sim.now();
+        uint8_t buf[RFM69_MAX_MESSAGE_LEN];
+        uint8_t len = sizeof(buf);
+        while (radio.recv(buf, &len)) {
+            r.received++;
+            len = sizeof(buf);
+        }
+        if (!stateMachine && sim.now() >= nextBlocking) {
+            blockingReading(&blockingTemp);
+            r.readings++;
+            if (blockingTemp < celsius - 1 || blockingTemp > celsius + 1)
+                r.tempErrors++;
+            nextBlocking += (uint64_t)INTERVAL_MS * 1000000;
+        }
+        uint32_t loopUs = (uint32_t)((sim.now() - before) / 1000);
+        if (loopUs > r.worstLoopUs)
+            r.worstLoopUs = loopUs;
+
+        if (stateMachine) {
+            RFM69Stats stats;
+            radio.stats(stats);
+            if (stats.hkReadings != lastReadings) {
+                lastReadings = stats.hkReadings;
+                if (radio.temperature() < celsius - 1 || radio.temperature() > celsius + 1)
+                    r.tempErrors++;
+                // A few readings to settle, then the supply must lie between the threshold
+                // reported and the next one up, give or take a step, and a second's worth of
+                // battery, as it falls
+                uint16_t reported = radio.supplyMv();
+                boolean low = radio.lowBattery();
+                if (lastReadings > 8 && (reported > mv + 10 || (mv < 2116 && reported + 150 < mv)
+                                         || (mv < 1835 - 75 && !low) || (mv > 1835 + 75 && low)))
+                    r.supplyErrors++;
+            }
+        }
+    }
+    // Let anything still on air arrive
+    sim.advance(1000000000);
+    uint8_t buf[RFM69_MAX_MESSAGE_LEN];
+    uint8_t len = sizeof(buf);
+    while (radio.recv(buf, &len)) {
+        r.received++;
+        len = sizeof(buf);
+    }
+
+    RFM69Stats stats;
+    radio.stats(stats);
+    if (stateMachine) {
+        r.readings = stats.hkReadings;
+        r.rxOffUs = stats.hkRxOffUs;
+        r.deferred = stats.hkDeferred;
+        radio.housekeepingFields(r.fields, sizeof(r.fields));
+    } else {
+        r.rxOffUs = (uint32_t)(r.readings * (uint64_t)r.worstLoopUs); // About the same every time
+        snprintf(r.fields, sizeof(r.fields), "T%d", blockingTemp);
+    }
+    return r;
+}
+
+int main()
+{
+    sim.attachInterrupt(0, dio0Handler, NULL);
+    rfm69SetHostClock(&sim);
+
+    printf("%u s on a busy channel, a reading every %u ms, main loop every %u us\n\n", RUN_MS / 1000,
+           INTERVAL_MS, STEP_NS / 1000);
+    printf("%-14s %6s %8s %6s %8s %12s %10s %8s %9s %s\n", "readings", "sent", "received", "lost", "taken",
+           "worst loop us", "RX off ms", "deferred", "bad temp", "fields at the end");
+    static const char* names[] = { "blocking", "housekeeping" };
+    Result results[2];
+    for (uint8_t i = 0; i < 2; i++) {
+        Result& r = results[i];
+        r = run(i == 1);
+        printf("%-14s %6u %8u %6u %8u %12u %10.1f %8u %9u %s\n", names[i], r.sent, r.received,
+               r.sent - r.received, r.readings, r.worstLoopUs, r.rxOffUs / 1000.0, r.deferred, r.tempErrors,
+               r.fields);
+    }
+    const Result& hk = results[1];
+    printf("\nsupply readings out of bounds: %u, low battery at the end: %s\n", hk.supplyErrors,
+           radio.lowBattery() ? "yes" : "no");
+
+    boolean ok = hk.readings >= RUN_MS / INTERVAL_MS * 9 / 10 && hk.tempErrors == 0 && hk.supplyErrors == 0
+        && radio.lowBattery() && hk.sent - hk.received < results[0].sent - results[0].received
+        && hk.worstLoopUs < results[0].worstLoopUs;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,265 @@
+// linux_bench.cpp
+//
+// Copyright (C) 2026 the UKHASnet_rfm69 contributors
+//
+// Runs the Linux backend against stand-ins for the kernel devices: a spidev whose
+// ioctl goes to the simulated radio, and a pipe carrying GPIO line events written
+// from the simulated DIO0. A second thread plays the air in real time while the
+// gateway thread waits for edges. Compares RFM69EventLoop with polling the DIO0
+// level, flat out and every millisecond, on CPU used and on the time from the
+// PAYLOADREADY edge to recv(). Build and run from the library root:
+//
+//   g++ -O2 -I. *.cpp extras/host/linux_bench.cpp -o linux_bench -lpthread && ./linux_bench
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/gpio.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include "RFM69Linux.h"
+#include "RFM69Sim.h"
+
+#define RUN_NS  2000000000ULL
+
+static RFM69Sim sim;
+static std::recursive_mutex simLock;
+
+static uint64_t wallNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint64_t cpuNs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// spidev stand-in, each ioctl becomes one transaction on the simulator
+class FakeSpidev : public RFM69SpidevTransport
+{
+public:
+    void begin()
+    {
+        std::lock_guard<std::recursive_mutex> hold(simLock);
+        sim.begin();
+    }
+
+protected:
+    boolean message(const uint8_t* tx, uint8_t* rx, uint16_t len)
+    {
+        std::lock_guard<std::recursive_mutex> hold(simLock);
+        sim.select();
+        for (uint16_t done = 0; done < len; done += 255)
+            sim.transfer(tx + done, rx + done, len - done > 255 ? 255 : len - done);
+        sim.deselect();
+        return true;
+    }
+};
+
+// The simulator's clock, shared with the air thread
+class LockedClock : public RFM69HostClock
+{
+public:
+    uint32_t micros()
+    {
+        std::lock_guard<std::recursive_mutex> hold(simLock);
+        return sim.micros();
+    }
+
+    uint32_t millis()
+    {
+        std::lock_guard<std::recursive_mutex> hold(simLock);
+        return sim.millis();
+    }
+
+    void delayMicroseconds(uint32_t us)
+    {
+        std::lock_guard<std::recursive_mutex> hold(simLock);
+        sim.delayMicroseconds(us);
+    }
+};
+
+static FakeSpidev spi;
+static LockedClock lockedClock;
+static RFM69 radio(spi);
+
+static int gpioPipe[2];
+static std::atomic<bool> eventsOn(false);
+static std::atomic<uint64_t> lastEdge(0);
+
+// The GPIO chardev stand-in, one line event per rising edge
+static void dio0Handler(void*)
+{
+    uint64_t now = wallNs();
+    lastEdge = now;
+    if (!eventsOn)
+        return;
+    struct gpio_v2_line_event event;
+    memset(&event, 0, sizeof(event));
+    event.timestamp_ns = now;
+    event.id = GPIO_V2_LINE_EVENT_RISING_EDGE;
+    if (write(gpioPipe[1], &event, sizeof(event)) != sizeof(event))
+        perror("write");
+}
+
+// Moves simulated time along with the wall clock, with a packet on air every interval
+static void airThread(std::atomic<bool>* running, uint16_t* sent)
+{
+    const uint8_t packet[] = "3aT12.3L0R-80,42[AB1,CD2,EF3]";
+    const uint8_t len = sizeof(packet) - 1;
+    uint64_t interval;
+    uint64_t simStart;
+    {
+        std::lock_guard<std::recursive_mutex> hold(simLock);
+        interval = sim.airtime(len) + 50000000;
+        simStart = sim.now();
+    }
+    uint64_t wallStart = wallNs();
+    uint64_t next = 0;
+    while (*running) {
+        uint64_t elapsed = wallNs() - wallStart;
+        {
+            std::lock_guard<std::recursive_mutex> hold(simLock);
+            if (simStart + elapsed > sim.now())
+                sim.advance(simStart + elapsed - sim.now());
+            if (elapsed >= next && elapsed + interval < RUN_NS) {
+                sim.air(packet, len, -70);
+                (*sent)++;
+                next = elapsed + interval;
+            }
+        }
+        usleep(100);
+    }
+}
+
+#define MODE_EPOLL      0
+#define MODE_POLL_BUSY  1
+#define MODE_POLL_1MS   2
+
+struct Result
+{
+    uint16_t    sent;
+    uint16_t    received;
+    uint64_t    cpuNs;
+    uint64_t    latencyNs;  // total
+    uint64_t    worstNs;
+    uint32_t    wakes;
+};
+
+static void run(uint8_t mode, RFM69EventLoop& events, Result& result)
+{
+    memset(&result, 0, sizeof(result));
+    eventsOn = mode == MODE_EPOLL;
+    std::atomic<bool> running(true);
+    std::thread air(airThread, &running, &result.sent);
+
+    uint64_t start = wallNs();
+    uint64_t cpuStart = cpuNs();
+    boolean level = false;
+    while (wallNs() - start < RUN_NS + 200000000ULL) {
+        if (mode == MODE_EPOLL) {
+            if (events.wait(100) > 0)
+                result.wakes++;
+        } else {
+            boolean now;
+            {
+                std::lock_guard<std::recursive_mutex> hold(simLock);
+                now = sim.dio(0);
+            }
+            if (now && !level)
+                radio.isr0();
+            level = now;
+            result.wakes++;
+            if (mode == MODE_POLL_1MS)
+                usleep(1000);
+        }
+        uint8_t buf[RFM69_MAX_MESSAGE_LEN];
+        uint8_t len = sizeof(buf);
+        while (radio.recv(buf, &len)) {
+            uint64_t latency = wallNs() - lastEdge;
+            result.latencyNs += latency;
+            if (latency > result.worstNs)
+                result.worstNs = latency;
+            result.received++;
+            len = sizeof(buf);
+        }
+    }
+    result.cpuNs = cpuNs() - cpuStart;
+    running = false;
+    air.join();
+
+    // Leave nothing behind for the next run
+    struct gpio_v2_line_event drain[16];
+    while (read(gpioPipe[0], drain, sizeof(drain)) > 0)
+        ;
+}
+
+int main()
+{
+    if (pipe(gpioPipe) < 0) {
+        perror("pipe");
+        return 1;
+    }
+    fcntl(gpioPipe[0], F_SETFL, O_NONBLOCK);
+    rfm69SetHostClock(&lockedClock);
+    sim.attachInterrupt(0, dio0Handler, NULL);
+    if (!radio.init()) {
+        printf("init failed\n");
+        return 1;
+    }
+    RFM69EventLoop events;
+    if (!events.attachFd(radio, gpioPipe[0])) {
+        printf("attach failed\n");
+        return 1;
+    }
+    radio.setModeRx();
+
+    uint32_t messagesBefore = spi.messages();
+    uint32_t transactionsBefore;
+    uint32_t bytesBefore;
+    {
+        std::lock_guard<std::recursive_mutex> hold(simLock);
+        transactionsBefore = sim.stats().transactions;
+        bytesBefore = sim.stats().bytes;
+    }
+
+    static const char* const names[] = { "epoll", "poll, busy", "poll, 1ms" };
+    printf("%-12s %6s %6s %8s %10s %10s %10s\n", "2s", "sent", "recv", "wakes", "cpu %", "avg us", "worst us");
+    boolean ok = true;
+    Result results[3];
+    for (uint8_t mode = 0; mode < 3; mode++) {
+        Result& result = results[mode];
+        run(mode, events, result);
+        printf("%-12s %6u %6u %8u %10.2f %10llu %10llu\n", names[mode], result.sent, result.received,
+               result.wakes, result.cpuNs * 100.0 / (RUN_NS + 200000000ULL),
+               (unsigned long long)(result.received ? result.latencyNs / result.received / 1000 : 0),
+               (unsigned long long)(result.worstNs / 1000));
+        if (result.received != result.sent)
+            ok = false;
+    }
+
+    uint32_t messages = spi.messages() - messagesBefore;
+    uint32_t transactions;
+    uint32_t bytes;
+    {
+        std::lock_guard<std::recursive_mutex> hold(simLock);
+        transactions = sim.stats().transactions - transactionsBefore;
+        bytes = sim.stats().bytes - bytesBefore;
+    }
+    printf("\nspidev: %u transactions, %u ioctls, %u bytes (%.1f bytes an ioctl)\n",
+           transactions, messages, bytes, messages ? (double)bytes / messages : 0.0);
+    if (messages != transactions)
+        ok = false;
+    // Sleeping in epoll has to cost less than spinning on the line
+    if (results[MODE_EPOLL].cpuNs * 10 > results[MODE_POLL_BUSY].cpuNs)
+        ok = false;
+    return ok ? 0 : 1;
+}
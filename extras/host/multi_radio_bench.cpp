@@ -0,0 +1,138 @@
+// multi_radio_bench.cpp
+//
+// Copyright (C) 2026 the UKHASnet_rfm69 contributors
+//
+// A gateway with three simulated radios on three channels, run from one main loop
+// that takes 150ms to deal with each message, so it cannot keep up with everything
+// heard. Channel 0 is flooded, channels 1 and 2 carry a packet every 500ms. Compares
+// RFM69Scheduler's round robin against always looking at the radios in the same
+// order. Build and run from the library root:
+//
+//   g++ -O2 -I. *.cpp extras/host/multi_radio_bench.cpp -o multi_radio_bench && ./multi_radio_bench
+
+#include <stdio.h>
+#include "RFM69Scheduler.h"
+#include "RFM69ConfigBuilder.h"
+#include "RFM69Sim.h"
+
+#define RADIOS 3
+
+static RFM69Sim sims[RADIOS];
+static RFM69 radio0(sims[0]);
+static RFM69 radio1(sims[1]);
+static RFM69 radio2(sims[2]);
+static RFM69* const radios[RADIOS] = { &radio0, &radio1, &radio2 };
+
+static const RFM69Channel channels[RADIOS] =
+{
+    RFM69_CHANNEL(869450000), RFM69_CHANNEL(869500000), RFM69_CHANNEL(869550000)
+};
+
+// Keeps the simulated radios in step. The driver's clock is the first one's.
+static void advanceAll(uint64_t ns)
+{
+    uint64_t latest = 0;
+    for (uint8_t i = 0; i < RADIOS; i++)
+        if (sims[i].now() > latest)
+            latest = sims[i].now();
+    for (uint8_t i = 0; i < RADIOS; i++)
+        sims[i].advance(latest - sims[i].now() + ns);
+}
+
+static void dio0Handler(void* ctx)
+{
+    ((RFM69*)ctx)->isr0();
+}
+
+struct Result
+{
+    uint16_t    heard[RADIOS];
+    uint16_t    handled[RADIOS];
+    uint16_t    overflows[RADIOS];
+    uint32_t    worstWait[RADIOS];
+};
+
+static void run(boolean roundRobin, RFM69Scheduler& scheduler, Result& result)
+{
+    memset(&result, 0, sizeof(result));
+    RFM69Stats before[RADIOS];
+    for (uint8_t i = 0; i < RADIOS; i++)
+        radios[i]->stats(before[i]);
+
+    const uint8_t packet[] = "3aT12.3L0[AB1]";
+    const uint8_t len = sizeof(packet) - 1;
+    uint64_t airtime = sims[0].airtime(len);
+    uint64_t next[RADIOS] = { 0, 0, 0 };
+    uint64_t end = sims[0].now() + 60000000000ULL;
+    while (sims[0].now() < end) {
+        for (uint8_t i = 0; i < RADIOS; i++) {
+            if (sims[i].now() >= next[i]) {
+                sims[i].air(packet, len, -80);
+                result.heard[i]++;
+                next[i] = sims[i].now() + (i == 0 ? airtime + 2000000 : 500000000ULL);
+            }
+        }
+
+        uint8_t buf[RFM69_MAX_MESSAGE_LEN];
+        uint8_t got = sizeof(buf);
+        uint8_t index = RADIOS;
+        if (roundRobin) {
+            scheduler.poll(buf, &got, &index);
+        } else {
+            for (uint8_t i = 0; i < RADIOS && index == RADIOS; i++)
+                if (radios[i]->recv(buf, &got))
+                    index = i;
+        }
+        if (index < RADIOS) {
+            result.handled[index]++;
+            uint32_t wait = millis() - radios[index]->lastTimestamp();
+            if (wait > result.worstWait[index])
+                result.worstWait[index] = wait;
+            advanceAll(150000000); // Dealing with it
+        } else {
+            advanceAll(1000000);
+        }
+    }
+    for (uint8_t i = 0; i < RADIOS; i++) {
+        RFM69Stats after;
+        radios[i]->stats(after);
+        result.overflows[i] = after.rxOverflows - before[i].rxOverflows;
+        radios[i]->clearStats();
+        uint8_t buf[RFM69_MAX_MESSAGE_LEN];
+        uint8_t got = sizeof(buf);
+        while (radios[i]->recv(buf, &got))
+            got = sizeof(buf);
+    }
+}
+
+int main()
+{
+    rfm69SetHostClock(&sims[0]);
+    RFM69Scheduler scheduler;
+    for (uint8_t i = 0; i < RADIOS; i++) {
+        sims[i].attachInterrupt(0, dio0Handler, radios[i]);
+        scheduler.add(*radios[i]);
+    }
+    if (!scheduler.init()) {
+        printf("init failed\n");
+        return 1;
+    }
+    for (uint8_t i = 0; i < RADIOS; i++) {
+        radios[i]->setChannel(channels[i]);
+        radios[i]->setModeRx();
+    }
+
+    printf("%-16s %8s %8s %8s %8s %10s\n", "60s", "radio", "heard", "handled", "dropped", "worst ms");
+    boolean fair = true;
+    for (uint8_t roundRobin = 0; roundRobin < 2; roundRobin++) {
+        Result result;
+        run(roundRobin, scheduler, result);
+        for (uint8_t i = 0; i < RADIOS; i++) {
+            printf("%-16s %8u %8u %8u %8u %10u\n", i ? "" : roundRobin ? "round robin" : "fixed order", i,
+                   result.heard[i], result.handled[i], result.overflows[i], result.worstWait[i]);
+            if (roundRobin && i && result.overflows[i])
+                fair = false;
+        }
+    }
+    return fair ? 0 : 1;
+}
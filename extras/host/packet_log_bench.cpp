@@ -0,0 +1,229 @@
+// packet_log_bench.cpp
+//
+// Copyright (C) 2026 the UKHASnet_rfm69 contributors
+//
+// Logs a month of gateway traffic, 40 nodes heard every minute or so and a balloon
+// heard for six hours, both as RFM69PacketLog and as a text log of one line per
+// packet, then runs the same queries against each: an hour, a day of one node,
+// the balloon's whole flight. Results must match. Also tears the end of the
+// log and checks the writer carries on after it. Build and run from the library
+// root:
+//
+//   g++ -O2 -I. *.cpp extras/host/packet_log_bench.cpp -o packet_log_bench && ./packet_log_bench
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "RFM69PacketLog.h"
+#include "UKHASnetPacket.h"
+
+#define NODES       40
+#define DAYS        30
+#define START       1418428800000ULL    // Midnight, 13 Dec 2014
+#define HOUR        3600000ULL
+#define DAY         (24 * HOUR)
+#define BALLOON_AT  (START + 17 * DAY + 9 * HOUR)
+#define BALLOON_FOR (6 * HOUR)
+
+static double nowS()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint32_t seed = 2463534242UL;
+
+static uint32_t rnd()
+{
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+static long fileSize(const char* path)
+{
+    struct stat st;
+    return stat(path, &st) == 0 ? (long)st.st_size : 0;
+}
+
+struct Query
+{
+    const char* name;
+    uint64_t    from;
+    uint64_t    to;
+    const char* origin;
+};
+
+// The text log, one "time,rssi,packet" line each, scanned the way a script would
+struct TextLog
+{
+    char*   text;
+    long    len;
+};
+
+static uint32_t textScan(const TextLog& log, const Query& q)
+{
+    uint32_t matched = 0;
+    char* p = log.text;
+    char* end = log.text + log.len;
+    while (p < end) {
+        char* eol = (char*)memchr(p, '\n', end - p);
+        if (!eol)
+            break;
+        char* rest;
+        uint64_t t = strtoull(p, &rest, 10);
+        if (t >= q.from && t <= q.to) {
+            if (!q.origin) {
+                matched++;
+            } else {
+                strtol(rest + 1, &rest, 10);
+                rest++;
+                UKHASnetPacket packet;
+                if (packet.parse((const uint8_t*)rest, (uint8_t)(eol - rest)) && packet.origin().equals(q.origin))
+                    matched++;
+            }
+        }
+        p = eol + 1;
+    }
+    return matched;
+}
+
+int main()
+{
+    char logPath[64];
+    char textPath[64];
+    snprintf(logPath, sizeof(logPath), "/tmp/rfm69_log_bench.%d.bin", (int)getpid());
+    snprintf(textPath, sizeof(textPath), "/tmp/rfm69_log_bench.%d.txt", (int)getpid());
+    unlink(logPath);
+
+    RFM69PacketLog log;
+    FILE* text = fopen(textPath, "w");
+    if (!log.open(logPath) || !text) {
+        printf("cannot create logs\n");
+        return 1;
+    }
+    double t0 = nowS();
+    uint64_t next[NODES];
+    char seq[NODES];
+    for (uint8_t n = 0; n < NODES; n++) {
+        next[n] = START + rnd() % 60000;
+        seq[n] = 'a';
+    }
+    uint64_t balloon = BALLOON_AT;
+    uint32_t packets = 0;
+    for (;;) {
+        uint8_t n = 0;
+        for (uint8_t i = 1; i < NODES; i++)
+            if (next[i] < next[n])
+                n = i;
+        uint64_t t = next[n];
+        if (t >= START + DAYS * DAY)
+            break;
+        char buf[RFM69_MAX_MESSAGE_LEN];
+        int len;
+        if (balloon < BALLOON_AT + BALLOON_FOR && balloon <= t) {
+            len = snprintf(buf, sizeof(buf), "5%cL51.%04u,-1.%04uA%u[HAB1,GW1]", 'a' + (int)(balloon / 30000 % 26),
+                           rnd() % 10000, rnd() % 10000, rnd() % 30000);
+            t = balloon;
+            balloon += 30000;
+        } else {
+            len = snprintf(buf, sizeof(buf), "2%cT%u.%uV3.%u[N%02u%s]", seq[n], rnd() % 30, rnd() % 10,
+                           rnd() % 10, n, n % 3 ? "" : ",R1");
+            seq[n] = seq[n] == 'z' ? 'b' : seq[n] + 1;
+            next[n] += 50000 + rnd() % 20000;
+        }
+        int rssi = -60 - (int)(rnd() % 50);
+        log.append((const uint8_t*)buf, len, rssi, t);
+        fprintf(text, "%llu,%d,%.*s\n", (unsigned long long)t, rssi, len, buf);
+        packets++;
+    }
+    log.close();
+    fclose(text);
+    printf("%u packets over %u days written in %.2fs: binary %.1fMB, text %.1fMB\n\n",
+           packets, DAYS, nowS() - t0, fileSize(logPath) / 1e6, fileSize(textPath) / 1e6);
+
+    TextLog textLog;
+    FILE* f = fopen(textPath, "rb");
+    textLog.len = fileSize(textPath);
+    textLog.text = (char*)malloc(textLog.len);
+    if (fread(textLog.text, 1, textLog.len, f) != (size_t)textLog.len)
+        return 1;
+    fclose(f);
+
+    RFM69PacketLogReader reader;
+    if (!reader.open(logPath)) {
+        printf("cannot map log\n");
+        return 1;
+    }
+    static const Query queries[] =
+    {
+        { "one hour",           START + 5 * DAY + 12 * HOUR, START + 5 * DAY + 13 * HOUR - 1, NULL },
+        { "N07 for a day",      START + 20 * DAY, START + 21 * DAY - 1, "N07" },
+        { "N07, all month",     0, ~0ULL, "N07" },
+        { "HAB1, all month",    0, ~0ULL, "HAB1" },
+    };
+    printf("%-16s %8s %10s %10s %10s %14s\n", "query", "packets", "text ms", "index ms", "speedup", "blocks read");
+    boolean ok = true;
+    for (uint8_t i = 0; i < sizeof(queries) / sizeof(queries[0]); i++) {
+        const Query& q = queries[i];
+        double a = nowS();
+        uint32_t expected = textScan(textLog, q);
+        double textMs = (nowS() - a) * 1000;
+        RFM69LogScan work;
+        a = nowS();
+        uint32_t got = reader.scan(q.from, q.to, q.origin, NULL, NULL, &work);
+        double indexMs = (nowS() - a) * 1000;
+        printf("%-16s %8u %10.1f %10.2f %9.0fx %7u of %u\n", q.name, got, textMs, indexMs,
+               textMs / (indexMs > 0.001 ? indexMs : 0.001), work.blocksRead, reader.blocks());
+        if (got != expected) {
+            printf("  text log has %u\n", expected);
+            ok = false;
+        }
+    }
+    reader.close();
+    free(textLog.text);
+
+    // Cut the log off part way through a record, as a crash in the middle of a
+    // write might, and carry on logging
+    long size = fileSize(logPath);
+    if (truncate(logPath, size - 7) < 0)
+        return 1;
+    log.open(logPath);
+    const uint8_t packet[] = "1aV3.3[LATE]";
+    log.append(packet, sizeof(packet) - 1, -80, START + DAYS * DAY);
+    log.close();
+    reader.open(logPath);
+    uint32_t total = reader.scan(0, ~0ULL, NULL, NULL, NULL);
+    uint32_t late = reader.scan(0, ~0ULL, "LATE", NULL, NULL);
+    printf("\nafter a torn write: %u packets, the torn one cut off and the next one logged: %s\n",
+           total, total == packets && late == 1 ? "yes" : "no");
+    if (total != packets || late != 1)
+        ok = false;
+    reader.close();
+
+    // Damage the first block's index so that its records would run through it and on
+    // into the next block. The block must be read as if it had no index.
+    int fd = open(logPath, O_WRONLY);
+    uint32_t bad = 0xFFFFFFF0;
+    if (fd < 0 || pwrite(fd, &bad, 4, RFM69_LOG_BLOCK + 24) != 4)
+        return 1;
+    close(fd);
+    reader.open(logPath);
+    RFM69LogScan work;
+    total = reader.scan(0, ~0ULL, NULL, NULL, NULL, &work);
+    printf("damaged index: %u packets, %u of %u blocks read: %s\n", total, work.blocksRead, reader.blocks(),
+           total == packets ? "yes" : "no");
+    if (total != packets)
+        ok = false;
+    reader.close();
+
+    unlink(logPath);
+    unlink(textPath);
+    return ok ? 0 : 1;
+}
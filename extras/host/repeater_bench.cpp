@@ -0,0 +1,104 @@
+// repeater_bench.cpp
+//
+// Copyright (C) 2026 the UKHASnet_rfm69 contributors
+//
+// Puts a UKHASnetRepeater on the simulated radio in the middle of a dense mesh,
+// where every packet is heard several times through different neighbours, and
+// reports how much it forwards. Build and run from the library root:
+//
+//   g++ -O2 -I. *.cpp extras/host/repeater_bench.cpp -o repeater_bench && ./repeater_bench
+
+#include <stdio.h>
+#include <time.h>
+#include "UKHASnetRepeater.h"
+#include "RFM69Sim.h"
+
+static RFM69Sim sim(8000000);
+static RFM69 radio(sim);
+static UKHASnetRepeater repeater(radio, "RPT1");
+
+static uint16_t sent;
+static boolean sentOk = true;
+
+static void dio0Handler(void*)
+{
+    radio.isr0();
+}
+
+// Every forwarded packet must have one fewer hop and end with this node
+static void onTransmit(void*, const uint8_t* data, uint8_t len)
+{
+    sent++;
+    UKHASnetPacket packet;
+    if (!packet.parse(data, len) || !packet.lastHop().equals("RPT1"))
+        sentOk = false;
+}
+
+// Hears a packet and gives the repeater time to deal with it
+static void hear(const char* text)
+{
+    sim.air((const uint8_t*)text, strlen(text), -80);
+    sim.advance(sim.airtime(strlen(text)) + 2000000);
+    while (repeater.poll())
+        ;
+    while (radio.txPending())
+        sim.advance(1000000);
+}
+
+int main()
+{
+    rfm69SetHostClock(&sim);
+    sim.onTransmit(onTransmit, NULL);
+    sim.attachInterrupt(0, dio0Handler, NULL);
+    radio.init();
+
+    // 20 nodes, each packet heard direct and through 3 other repeaters, then our own
+    // forward coming back from a neighbour
+    const uint8_t nodes = 20;
+    char text[64];
+    for (uint8_t n = 0; n < nodes; n++) {
+        snprintf(text, sizeof(text), "3aT12.%uV3.3[N%u]", n, n);
+        hear(text);
+        for (uint8_t r = 0; r < 3; r++) {
+            snprintf(text, sizeof(text), "2aT12.%uV3.3[N%u,R%u]", n, n, r);
+            hear(text);
+        }
+        snprintf(text, sizeof(text), "1aT12.%uV3.3[N%u,RPT1,R9]", n, n);
+        hear(text);
+    }
+    printf("storm: %u heard, %u forwarded, %u duplicates, %u sent %s\n", repeater.received(),
+           repeater.forwarded(), repeater.duplicates(), sent, sentOk ? "ok" : "WRONG");
+
+    // Out of hops, and a sequence letter seen again after the entry has expired
+    hear("0bT1[N0]");
+    sim.advance((UKHASNET_DEDUP_EXPIRY + 2000) * 1000000ULL);
+    repeater.poll();
+    hear("3aT12.0V3.3[N0]");
+    printf("after expiry: %u forwarded (expected %u)\n", repeater.forwarded(), nodes + 1);
+
+    // A copy worn out over a long path arrives before one heard straight from the origin
+    hear("0cT1[N5,R1,R2,R3]");
+    hear("2cT1[N5]");
+    printf("out of hops first: %u forwarded (expected %u)\n", repeater.forwarded(), nodes + 2);
+
+    // Raw table cost, with the table full of live entries
+    UKHASnetDedup dedup;
+    char names[UKHASNET_DEDUP_SIZE * 2][8];
+    UKHASnetView views[UKHASNET_DEDUP_SIZE * 2];
+    for (uint16_t i = 0; i < UKHASNET_DEDUP_SIZE * 2; i++) {
+        snprintf(names[i], sizeof(names[i]), "N%u", i);
+        views[i].ptr = names[i];
+        views[i].len = strlen(names[i]);
+    }
+    const uint32_t runs = 4000000;
+    uint32_t hits = 0;
+    struct timespec a, b;
+    clock_gettime(CLOCK_MONOTONIC, &a);
+    for (uint32_t i = 0; i < runs; i++)
+        hits += dedup.seen(views[i % (UKHASNET_DEDUP_SIZE * 2)], 'a' + (i / 1000) % 26, i / 1000);
+    clock_gettime(CLOCK_MONOTONIC, &b);
+    double ns = ((b.tv_sec - a.tv_sec) * 1e9 + (b.tv_nsec - a.tv_nsec)) / runs;
+    printf("dedup: %u entries, %.1f ns per lookup+insert, %u%% hits\n", UKHASNET_DEDUP_SIZE, ns,
+           (unsigned)(hits * 100ULL / runs));
+    return sentOk && repeater.forwarded() == nodes + 2 ? 0 : 1;
+}
@@ -0,0 +1,569 @@
+// rfm69_bench.cpp
+//
+// Copyright (C) 2026 the UKHASnet_rfm69 contributors
+//
+// Runs the driver against the RFM69Sim register model and reports the SPI
+// cost and latency of each driver path. Build and run from the library root:
+//
+//   g++ -O2 -I. *.cpp extras/host/rfm69_bench.cpp -o rfm69_bench && ./rfm69_bench
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "UKHASnet_rfm69.h"
+#include "RFM69Sim.h"
+#include "RFM69ChannelPlan.h"
+
+static RFM69Sim sim(8000000);   // 8MHz SPI, as SPI_CLOCK_DIV2 on a 16MHz AVR
+static RFM69 radio(sim);
+
+struct Mark
+{
+    RFM69SimStats   stats;
+    uint64_t        at;
+};
+
+static Mark mark()
+{
+    Mark m;
+    m.stats = sim.stats();
+    m.at = sim.now();
+    return m;
+}
+
+static void report(const char* path, const Mark& from, uint32_t runs = 1)
+{
+    const RFM69SimStats& s = sim.stats();
+    printf("%-28s %8.1f %8.1f %10.1f %12.1f\n", path,
+           (double)(s.transactions - from.stats.transactions) / runs,
+           (double)(s.bytes - from.stats.bytes) / runs,
+           (double)(s.busNs - from.stats.busNs) / runs / 1000.0,
+           (double)(sim.now() - from.at) / runs / 1000.0);
+}
+
+// Polls the driver the way a main loop would until the radio raises DIO0
+static boolean waitDio0(uint64_t timeoutNs = 10000000000ULL)
+{
+    uint64_t end = sim.now() + timeoutNs;
+    while (!sim.dio(0)) {
+        if (sim.now() > end)
+            return false;
+        sim.advance(10000);
+    }
+    radio.isr0();
+    return true;
+}
+
+// Same for a received packet: DIO0 signals SYNCADDRESS first, then PAYLOADREADY
+static boolean waitRx()
+{
+    RFM69Stats before, after;
+    radio.stats(before);
+    do {
+        if (!waitDio0())
+            return false;
+        radio.stats(after);
+    } while (after.rxGood + after.rxBad + after.rxOverflows == before.rxGood + before.rxBad + before.rxOverflows);
+    return true;
+}
+
+static void dio0Handler(void*)
+{
+    radio.isr0();
+}
+
+static void dio1Handler(void*)
+{
+    radio.isr1();
+}
+
+// Time the last packet became available to recv(), as seen from the DIO0 interrupt
+static uint64_t availableAt;
+
+static void dio0LatencyHandler(void*)
+{
+    radio.isr0();
+    if (radio.available() && !availableAt)
+        availableAt = sim.now();
+}
+
+// Average supply current since from, in uA, from the time the simulator spent in each state
+// Our transmissions, as the time each one ended, for the listen before talk and duty cycle runs
+static uint64_t sentEnds[512];
+static uint16_t sentCount;
+
+static void recordTransmit(void*, const uint8_t*, uint8_t)
+{
+    if (sentCount < sizeof(sentEnds) / sizeof(sentEnds[0]))
+        sentEnds[sentCount++] = sim.now();
+}
+
+// Sends a message about once a second, on a channel another node keeps about 40% busy,
+// for seconds of simulated time. The other node listens before it talks, checking once
+// a millisecond.
+// \return Number of our messages that overlapped one of theirs
+static uint16_t lbtRun(const uint8_t* packet, uint8_t len, uint16_t seconds, double* accessMs)
+{
+    static uint64_t theirs[1024];
+    uint16_t theirCount = 0;
+    uint64_t air = sim.airtime(len);
+    uint64_t next = sim.now();
+    uint64_t end = sim.now() + seconds * 1000000000ULL;
+    uint64_t queuedAt = 0;
+    uint64_t nextOurs = 0;
+    double access = 0;
+    sentCount = 0;
+    srand(1);
+    sim.onTransmit(recordTransmit, NULL);
+    sim.attachInterrupt(0, dio0Handler, NULL);
+    while (sim.now() < end) {
+        if (next <= sim.now() && sim.mode() == RFM69_MODE_TX) {
+            next += (1 + rand() % 8) * RFM69_LBT_SLOT * 1000000ULL; // They hear us, and back off
+        } else if (next <= sim.now() && theirCount < sizeof(theirs) / sizeof(theirs[0])) {
+            sim.air(packet, len, -70);
+            theirs[theirCount++] = sim.now();
+            next = sim.now() + air + (rand() % 250) * 1000000ULL;
+        }
+        if (!radio.txPending() && sim.now() >= nextOurs) {
+            if (sentCount)
+                access += (sentEnds[sentCount - 1] - air - queuedAt) / 1e6;
+            queuedAt = sim.now();
+            nextOurs = sim.now() + (500 + rand() % 1000) * 1000000ULL;
+            radio.sendAsync(packet, len);
+        }
+        sim.advance(1000000);
+        uint8_t buf[RFM69_MAX_MESSAGE_LEN];
+        uint8_t bufLen = sizeof(buf);
+        while (radio.recv(buf, &bufLen))
+            bufLen = sizeof(buf);
+    }
+    while (radio.txPending())
+        sim.advance(1000000);
+    sim.onTransmit(NULL, NULL);
+    sim.attachInterrupt(0, NULL, NULL);
+
+    uint16_t collisions = 0;
+    for (uint16_t i = 0; i < sentCount; i++)
+        for (uint16_t j = 0; j < theirCount; j++)
+            if (sentEnds[i] - air < theirs[j] + air && theirs[j] < sentEnds[i]) {
+                collisions++;
+                break;
+            }
+    *accessMs = sentCount > 1 ? access / (sentCount - 1) : 0;
+    return collisions;
+}
+
+static double averageCurrent(const Mark& from)
+{
+    const RFM69SimStats& s = sim.stats();
+    double nAns = (double)(s.sleepNs - from.stats.sleepNs) * RFM69_CURRENT_SLEEP
+        + (double)(s.idleNs - from.stats.idleNs) * RFM69_CURRENT_IDLE
+        + (double)(s.stdbyNs - from.stats.stdbyNs) * RFM69_CURRENT_STDBY
+        + (double)(s.rxNs - from.stats.rxNs) * RFM69_CURRENT_RX
+        + (double)(s.txNs - from.stats.txNs) * RFM69_CURRENT_TX;
+    return nAns / (double)(sim.now() - from.at) / 1000.0;
+}
+
+int main()
+{
+    rfm69SetHostClock(&sim);
+    sim.setSelectOverhead(3000); // Two digitalWrite()s and the call overhead on a 16MHz AVR
+
+    printf("%-28s %8s %8s %10s %12s\n", "path", "xfers", "bytes", "bus us", "elapsed us");
+
+    Mark m = mark();
+    radio.init();
+    report("init", m);
+
+    const uint32_t runs = 1000;
+    m = mark();
+    for (uint32_t i = 0; i < runs; i++)
+        radio.spiRead(RFM69_REG_10_VERSION);
+    report("spiRead", m, runs);
+
+    m = mark();
+    for (uint32_t i = 0; i < runs; i++)
+        radio.rssiRead();
+    report("rssiRead", m, runs);
+
+    m = mark();
+    for (uint32_t i = 0; i < runs; i++)
+        radio.setMode(i & 1 ? RFM69_MODE_RX : RFM69_MODE_STDBY);
+    report("setMode", m, runs);
+    radio.setModeRx();
+
+    // Channel hopping: precomputed FRF burst against float setFrequency()
+    static const RFM69Channel channels[] = {
+        RFM69_CHANNEL(869500000UL), RFM69_CHANNEL(869850000UL), RFM69_CHANNEL(868300000UL)
+    };
+    RFM69ChannelPlan plan(channels, 3);
+    m = mark();
+    for (uint32_t i = 0; i < runs; i++)
+        plan.next(radio);
+    report("setChannel", m, runs);
+    m = mark();
+    for (uint32_t i = 0; i < runs; i++)
+        radio.setFrequency(i & 1 ? 869.85 : 869.5);
+    report("setFrequency", m, runs);
+    for (uint8_t i = 1; i < 3; i++) {
+        plan.select(radio, 0);
+        sim.advance(1000000);
+        m = mark();
+        plan.select(radio, i);
+        while (!(radio.spiRead(RFM69_REG_27_IRQ_FLAGS1) & RF_IRQFLAGS1_PLLLOCK))
+            ;
+        char label[32];
+        snprintf(label, sizeof(label), "hop -> PLLLOCK (ch %u)", i);
+        report(label, m);
+    }
+    plan.select(radio, 0);
+    sim.advance(1000000);
+
+    const uint8_t packet[] = "3aT12.3L0[AB1]";
+    const uint8_t len = sizeof(packet) - 1;
+
+    m = mark();
+    radio.send(packet, len);
+    report("send (load)", m);
+    m = mark();
+    waitDio0();
+    report("send -> PACKETSENT", m);
+
+    // The same packet composed from a header, the sensor fields and the path
+    static uint8_t lastSent[RFM69_MAX_MESSAGE_LEN];
+    static uint8_t lastSentLen;
+    struct Capture
+    {
+        static void onTransmit(void*, const uint8_t* data, uint8_t len)
+        {
+            memcpy(lastSent, data, len);
+            lastSentLen = len;
+        }
+    };
+    sim.onTransmit(Capture::onTransmit, NULL);
+    const RFM69Segment pieces[] = {
+        { (const uint8_t*)"3a", 2 }, { (const uint8_t*)"T12.3L0", 7 }, { (const uint8_t*)"[AB1]", 5 }
+    };
+    m = mark();
+    radio.sendv(pieces, 3);
+    report("sendv (load)", m);
+    waitDio0();
+    printf("sendv: %s\n", lastSentLen == len && memcmp(lastSent, packet, len) == 0 ? "exact" : "WRONG");
+    sim.onTransmit(NULL, NULL);
+
+    // A repeater flushing a backlog of forwarded packets
+    m = mark();
+    uint8_t backlog = 0;
+    while (radio.sendAsync(packet, len))
+        backlog++;
+    while (radio.txPending())
+        if (!waitDio0())
+            break;
+    report("tx backlog (per packet)", m, backlog);
+    printf("backlog: %u packets, %.1f ms each on air, %u sent\n", backlog,
+           sim.airtime(len) / 1e6, sim.stats().txPackets - m.stats.txPackets);
+
+    uint8_t buf[RFM69_MAX_MESSAGE_LEN];
+    uint8_t bufLen;
+    m = mark();
+    sim.air(packet, len, -80);
+    waitRx();
+    report("air -> PAYLOADREADY", m);
+    m = mark();
+    bufLen = sizeof(buf);
+    radio.recv(buf, &bufLen);
+    report("recv", m);
+
+    const uint8_t* lease;
+    m = mark();
+    sim.air(packet, len, -80);
+    waitRx();
+    report("air -> recvLease", m);
+    boolean leased = radio.recvLease(&lease, &bufLen) && bufLen == len && memcmp(lease, packet, len) == 0;
+    radio.recvRelease();
+    printf("recvLease: %s\n", leased ? "exact" : "WRONG");
+
+    // A burst of packets from neighbouring repeaters, serviced by the "interrupt"
+    // while the main loop is busy elsewhere
+    m = mark();
+    for (uint8_t i = 0; i < RFM69_RX_QUEUE_LEN; i++)
+        sim.air(packet, len, -70 - i, sim.now() + i * (sim.airtime(len) + 1000000));
+    for (uint8_t i = 0; i < RFM69_RX_QUEUE_LEN; i++)
+        waitRx();
+    uint8_t queued = 0;
+    bufLen = sizeof(buf);
+    while (radio.recv(buf, &bufLen)) {
+        queued++;
+        bufLen = sizeof(buf);
+    }
+    report("rx burst (queue depth)", m, RFM69_RX_QUEUE_LEN);
+    printf("burst: %u/%u queued, %u overflows\n", queued, RFM69_RX_QUEUE_LEN, radio.rxOverflows());
+
+    // Long messages streamed through the FIFO, with DIO1 (FIFOLEVEL) attached as an interrupt
+    if (RFM69_MAX_MESSAGE_LEN > RFM69_FIFO_SIZE) {
+        uint8_t longPacket[RFM69_MAX_MESSAGE_LEN];
+        for (uint16_t i = 0; i < sizeof(longPacket); i++)
+            longPacket[i] = 'A' + i % 26;
+        sim.attachInterrupt(1, dio1Handler, NULL, RFM69_SIM_CHANGE);
+
+        m = mark();
+        uint32_t underruns = sim.stats().txUnderruns;
+        radio.sendAsync(longPacket, sizeof(longPacket));
+        waitDio0();
+        report("send 255 -> PACKETSENT", m);
+
+        m = mark();
+        sim.air(longPacket, sizeof(longPacket), -90);
+        waitRx();
+        bufLen = sizeof(buf);
+        boolean ok = radio.recv(buf, &bufLen) && bufLen == sizeof(longPacket)
+            && memcmp(buf, longPacket, bufLen) == 0;
+        report("air 255 -> recv", m);
+        printf("255 byte stream: tx underruns %u, rx %s, overruns %u\n",
+               sim.stats().txUnderruns - underruns, ok ? "intact" : "CORRUPT", sim.stats().rxOverruns);
+        sim.attachInterrupt(1, NULL, NULL);
+
+        // Without DIO1 the FIFO runs dry: the message is retried, then dropped, not stuck
+        underruns = sim.stats().txUnderruns;
+        radio.sendAsync(longPacket, sizeof(longPacket));
+        m = mark();
+        while (radio.txPending())
+            sim.advance(10000000);
+        printf("255 byte without DIO1: %u underruns, queue clear after %.0f ms\n",
+               sim.stats().txUnderruns - underruns, (sim.now() - m.at) / 1e6);
+    }
+
+    // PAYLOADREADY to recv() latency, with DIO0 on an interrupt against a main loop that
+    // calls isr0() between 20ms of other work
+    printf("\n%-28s %10s %10s %8s\n", "dio0 service", "mean us", "max us", "heard");
+    for (uint8_t interrupt = 0; interrupt < 2; interrupt++) {
+        const uint8_t count = 8;
+        const uint64_t spacing = sim.airtime(len) + 1000000;
+        const uint64_t work = 20000000;
+        if (interrupt)
+            sim.attachInterrupt(0, dio0LatencyHandler, NULL);
+        uint64_t start = sim.now() + 1000000;
+        uint64_t total = 0, worst = 0;
+        uint8_t heard = 0;
+        for (uint8_t i = 0; i < count; i++)
+            sim.air(packet, len, -80, start + i * spacing);
+        while (sim.now() < start + (count + 1) * spacing) {
+            availableAt = 0;
+            sim.advance(interrupt ? 100000 : work);
+            if (!interrupt && sim.dio(0))
+                radio.isr0();
+            if (!interrupt && radio.available())
+                availableAt = sim.now();
+            if (!availableAt)
+                continue;
+            bufLen = sizeof(buf);
+            radio.recv(buf, &bufLen);
+            // Measured from the end of the packet that arrived last before it was available
+            uint64_t ready = start + sim.airtime(len);
+            ready += (availableAt - ready) / spacing * spacing;
+            uint64_t latency = availableAt - ready;
+            total += latency;
+            if (latency > worst)
+                worst = latency;
+            heard++;
+        }
+        printf("%-28s %10.1f %10.1f %5u/%u\n", interrupt ? "interrupt" : "polled, 20ms loop",
+               heard ? total / heard / 1000.0 : 0.0, worst / 1000.0, heard, count);
+        sim.attachInterrupt(0, NULL, NULL);
+    }
+
+    // A battery node in Listen mode: a minute of silence, then a burst from a repeater
+    sim.attachInterrupt(0, dio0Handler, NULL);
+    printf("\n%-28s %10s %10s %8s %8s %6s\n", "listen idle/rx", "model uA", "sim uA", "wakes", "heard",
+           "rssi");
+    static const struct {
+        const char* name;
+        uint32_t    idleUs;
+        uint32_t    rxUs;
+        uint8_t     criteria;
+    } listens[] = {
+        { "1s/24ms rssi+sync", 1000000, 24000, RF_LISTEN1_CRITERIA_RSSIANDSYNC },
+        { "1s/2ms rssi", 1000000, 2000, RF_LISTEN1_CRITERIA_RSSI },
+        { "4s/2ms rssi", 4000000, 2000, RF_LISTEN1_CRITERIA_RSSI },
+    };
+    const uint8_t burst = 16;
+    for (uint8_t l = 0; l < sizeof(listens) / sizeof(listens[0]); l++) {
+        radio.setListen(listens[l].idleUs, listens[l].rxUs, listens[l].criteria);
+        radio.setModeListen();
+        m = mark();
+        sim.advance(60000000000ULL);
+        double quiet = averageCurrent(m);
+
+        uint32_t wakes = sim.stats().listenWakes;
+        uint8_t heard = 0;
+        uint8_t rssiOk = 0; // Each packet's own RSSI, not one left over from an earlier one
+        for (uint8_t i = 0; i < burst; i++) {
+            int8_t level = -70 - 2 * i;
+            sim.air(packet, len, level);
+            sim.advance(sim.airtime(len) + 10000000);
+            bufLen = sizeof(buf);
+            while (radio.recv(buf, &bufLen)) {
+                heard++;
+                if (abs(radio.lastRssi() - level) <= 3)
+                    rssiOk++;
+                bufLen = sizeof(buf);
+            }
+        }
+        printf("%-28s %10.1f %10.1f %8u %5u/%u %6s\n", listens[l].name, radio.listenCurrent() / 1000.0,
+               quiet, sim.stats().listenWakes - wakes, heard, burst, rssiOk == heard ? "ok" : "WRONG");
+        radio.setModeRx();
+    }
+    sim.attachInterrupt(0, NULL, NULL);
+
+    // A corrupted packet, then what the driver counted over the whole run
+    sim.air(packet, len, -100, 0, 0, false);
+    waitRx();
+    RFM69Stats st;
+    radio.stats(st);
+    printf("\ndriver stats: rx %u bad %u crc %u overflows %u, tx %u restarts %u dropped %u\n",
+           st.rxGood, st.rxBad, st.rxCrcErrors, st.rxOverflows, st.txGood, st.txRestarts, st.txDropped);
+    printf("spi: %u transactions, %u bytes (sim %u, %u)\n", st.spiTransactions, st.spiBytes,
+           sim.stats().transactions, sim.stats().bytes);
+    printf("dwell ms: sleep %u stdby %u rx %u tx %u listen %u\n", st.dwellMs[RFM69_STATS_SLEEP],
+           st.dwellMs[RFM69_STATS_STDBY], st.dwellMs[RFM69_STATS_RX], st.dwellMs[RFM69_STATS_TX],
+           st.dwellMs[RFM69_STATS_LISTEN]);
+    printf("rssi:");
+    for (uint8_t i = 0; i < RFM69_STATS_RSSI_BINS; i++)
+        printf(" %d:%u", -120 + 10 * i, st.rssi[i]);
+    printf("\ntx latency:");
+    for (uint8_t i = 0; i < RFM69_STATS_LATENCY_BINS; i++)
+        if (st.txLatency[i])
+            printf(" <%ums:%u", 1U << i, st.txLatency[i]);
+    m = mark();
+    for (uint32_t i = 0; i < runs; i++)
+        radio.stats(st);
+    printf("\n");
+    report("stats snapshot", m, runs);
+
+    // RSSI taken at sync against the level after PAYLOADREADY, and the noise floor
+    // estimate from a main loop calling available() every 10ms, quiet then busy
+    printf("\n%-28s %10s %10s %10s %8s\n", "rssi at sync", "sent dBm", "lastRssi", "after", "margin");
+    sim.attachInterrupt(0, dio0Handler, NULL);
+    radio.setModeRx();
+    sim.setNoise(-105, 3);
+    for (uint16_t i = 0; i < 3000; i++) {
+        radio.available();
+        sim.advance(10000000);
+    }
+    int quiet = radio.noiseFloor();
+    const int levels[] = { -50, -70, -90, -100 };
+    for (uint8_t i = 0; i < sizeof(levels) / sizeof(levels[0]); i++) {
+        sim.air(packet, len, levels[i]);
+        sim.advance(sim.airtime(len) + 1000000);
+        uint8_t got = sizeof(buf);
+        if (!radio.recv(buf, &got))
+            printf("%-28s %10d lost\n", "", levels[i]);
+        else
+            printf("%-28s %10d %10d %10d %8d\n", "", levels[i], radio.lastRssi(), radio.rssiRead(),
+                   radio.linkMargin());
+    }
+    // A packet every 130ms, on air most of the time
+    for (uint16_t i = 0; i < 3000; i++) {
+        if (i % 13 == 0)
+            sim.air(packet, len, -60);
+        radio.available();
+        sim.advance(10000000);
+        uint8_t got = sizeof(buf);
+        radio.recv(buf, &got);
+    }
+    printf("noise floor: -105 +/-3 dBm set, %d quiet, %d busy\n", quiet, radio.noiseFloor());
+    sim.attachInterrupt(0, NULL, NULL);
+
+    // Listen before talk, on a channel kept busy by another node
+    printf("\n%-28s %8s %10s %10s %8s %8s\n", "channel 40% busy", "sent", "collided", "access ms",
+           "backoffs", "forced");
+    for (uint8_t lbt = 0; lbt < 2; lbt++) {
+        radio.setLbt(lbt);
+        radio.stats(st);
+        double accessMs;
+        uint16_t collisions = lbtRun(packet, len, 60, &accessMs);
+        RFM69Stats after;
+        radio.stats(after);
+        printf("%-28s %8u %9.1f%% %10.1f %8u %8u\n", lbt ? "listen before talk" : "straight to TX",
+               sentCount, collisions * 100.0 / sentCount, accessMs, after.txBackoffs - st.txBackoffs,
+               after.txForced - st.txForced);
+    }
+    radio.setLbt(false);
+
+    // Airtime worked out from the register shadow, against the simulator's
+    struct { uint8_t br[2]; uint8_t preamble; uint8_t sync; uint8_t crc; } airConfigs[] =
+    {
+        { { 0x3E, 0x80 }, 3, RF_SYNC_SIZE_2, RF_PACKET1_CRC_ON },   // 2kbps, as UKHASnet
+        { { 0x1A, 0x0B }, 8, RF_SYNC_SIZE_4, RF_PACKET1_CRC_ON },   // 4.8kbps
+        { { 0x02, 0x80 }, 4, RF_SYNC_SIZE_8, RF_PACKET1_CRC_OFF },  // 50kbps
+    };
+    uint8_t saved[5] = { radio.regRead(RFM69_REG_03_BITRATE_MSB), radio.regRead(RFM69_REG_04_BITRATE_LSB),
+                         radio.regRead(RFM69_REG_2D_PREAMBLE_LSB), radio.regRead(RFM69_REG_2E_SYNC_CONFIG),
+                         radio.regRead(RFM69_REG_37_PACKET_CONFIG1) };
+    const uint8_t airLens[] = { 1, 14, 64, 255 };
+    uint16_t airChecked = 0, airWrong = 0;
+    for (uint8_t c = 0; c < sizeof(airConfigs) / sizeof(airConfigs[0]); c++) {
+        radio.regWrite(RFM69_REG_03_BITRATE_MSB, airConfigs[c].br[0]);
+        radio.regWrite(RFM69_REG_04_BITRATE_LSB, airConfigs[c].br[1]);
+        radio.regWrite(RFM69_REG_2D_PREAMBLE_LSB, airConfigs[c].preamble);
+        radio.regWrite(RFM69_REG_2E_SYNC_CONFIG, (saved[3] & ~0x38) | airConfigs[c].sync);
+        radio.regWrite(RFM69_REG_37_PACKET_CONFIG1, (saved[4] & ~RF_PACKET1_CRC_ON) | airConfigs[c].crc);
+        radio.regFlush();
+        for (uint8_t l = 0; l < sizeof(airLens); l++, airChecked++)
+            if (radio.airtime(airLens[l]) != sim.airtime(airLens[l]) / 1000)
+                airWrong++;
+    }
+    printf("\n%-28s %8s %8s %10s %12s\n", "path", "xfers", "bytes", "bus us", "elapsed us");
+    m = mark();
+    for (uint32_t i = 0; i < runs; i++)
+        radio.airtime(len);
+    report("airtime", m, runs);
+    const uint8_t savedRegs[] = { RFM69_REG_03_BITRATE_MSB, RFM69_REG_04_BITRATE_LSB, RFM69_REG_2D_PREAMBLE_LSB,
+                                  RFM69_REG_2E_SYNC_CONFIG, RFM69_REG_37_PACKET_CONFIG1 };
+    for (uint8_t i = 0; i < sizeof(savedRegs); i++)
+        radio.regWrite(savedRegs[i], saved[i]);
+    radio.regFlush();
+    printf("airtime: %u/%u settings and lengths match the simulator\n", airChecked - airWrong, airChecked);
+
+    // 10% duty cycle over a minute, offered a message every 300ms (29%) for 5 minutes
+    const uint32_t window = 60000;
+    uint64_t air = sim.airtime(len);
+    radio.setDutyCycle(100, window);
+    radio.stats(st);
+    sentCount = 0;
+    uint16_t offered = 0, accepted = 0;
+    uint64_t start = sim.now();
+    sim.onTransmit(recordTransmit, NULL);
+    sim.attachInterrupt(0, dio0Handler, NULL);
+    for (uint32_t t = 0; t < 300000; t++) {
+        if (t % 300 == 0) {
+            offered++;
+            accepted += radio.sendAsync(packet, len);
+        }
+        radio.txPending();
+        sim.advance(1000000);
+    }
+    uint64_t worst = 0;
+    for (uint16_t i = 0; i < sentCount; i++) {
+        uint64_t inWindow = 0;
+        for (uint16_t j = 0; j <= i; j++)
+            if (sentEnds[j] + window * 1000000ULL > sentEnds[i])
+                inWindow += air;
+        if (inWindow > worst)
+            worst = inWindow;
+    }
+    RFM69Stats after;
+    radio.stats(after);
+    printf("duty 10%%/%us: %u offered, %u queued, %u sent, %u deferred, %u expired\n", window / 1000,
+           offered, accepted, sentCount, after.txDeferred - st.txDeferred, after.txExpired - st.txExpired);
+    printf("duty 10%%/%us: busiest window %.1f%%, overall %.1f%%\n", window / 1000,
+           worst * 100.0 / (window * 1000000ULL), sentCount * air * 100.0 / (sim.now() - start));
+    radio.setDutyCycle(0);
+    while (radio.txPending())
+        sim.advance(1000000);
+    sim.onTransmit(NULL, NULL);
+    sim.attachInterrupt(0, NULL, NULL);
+
+    printf("\nairtime %u bytes: %.1f ms, sim tx %u rx %u missed %u\n", len,
+           sim.airtime(len) / 1e6, sim.stats().txPackets, sim.stats().rxPackets, sim.stats().rxMissed);
+    return 0;
+}
@@ -0,0 +1,333 @@
+// spool_bench.cpp
+//
+// Copyright (C) 2026 the UKHASnet_rfm69 contributors
+//
+// Feeds 100 packets a second through an RFM69Spool and RFM69Uploader to a
+// stand-in collector on a local socket that answers in chunks for a while,
+// refuses batches holding a malformed packet (400s), then goes through refused
+// connections, an outage (503s) and a stall (takes requests, never answers)
+// before coming back. Checks that every packet bar the malformed ones arrives
+// exactly once, that the main loop is never
+// held up, and that packets survive the gateway process being killed, and a
+// torn record is cut off. Build and run from the library root:
+//
+//   g++ -O2 -I. *.cpp extras/host/spool_bench.cpp -o spool_bench -lpthread && ./spool_bench
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <atomic>
+#include <thread>
+#include "RFM69Uploader.h"
+
+#define PACKETS_MAX 4096
+
+#define SERVER_UP       0
+#define SERVER_DOWN     1   // Answers 503
+#define SERVER_STALL    2   // Reads requests, never answers
+#define SERVER_REFUSE   3   // Closes connections straight away
+#define SERVER_CHUNKED  4   // Answers 200 with a chunked body, keeping the connection
+#define SERVER_REJECT   5   // Answers 400 to a batch holding a malformed packet
+
+static std::atomic<int> serverMode(SERVER_UP);
+static std::atomic<bool> serverRunning(true);
+static uint8_t seen[PACKETS_MAX];
+static boolean malformed[PACKETS_MAX];
+static uint32_t serverRequests;
+
+static uint64_t nowUs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+// Counts the packets in one complete request body
+static void take(const char* body, size_t len)
+{
+    const char* end = body + len;
+    for (const char* p = body; p < end; p++) {
+        if (strncmp(p, "\"packet\":\"3a:", 13) == 0) {
+            int n = atoi(p + 13);
+            if (n >= 0 && n < PACKETS_MAX && seen[n] < 255)
+                seen[n]++;
+        }
+    }
+}
+
+// One connection at a time is all the uploader makes
+static void serverThread(int listener)
+{
+    static char buf[65536];
+    while (serverRunning) {
+        struct pollfd pfd = { listener, POLLIN, 0 };
+        if (poll(&pfd, 1, 20) != 1)
+            continue;
+        int fd = accept(listener, NULL, NULL);
+        if (fd < 0)
+            continue;
+        size_t have = 0;
+        int acceptedMode = serverMode;
+        while (serverRunning) {
+            int mode = serverMode;
+            if (mode == SERVER_REFUSE || (acceptedMode == SERVER_STALL && mode != SERVER_STALL))
+                break;
+            struct pollfd cfd = { fd, POLLIN, 0 };
+            if (poll(&cfd, 1, 20) != 1)
+                continue;
+            ssize_t got = recv(fd, buf + have, sizeof(buf) - have, 0);
+            if (got <= 0)
+                break;
+            have += got;
+            char* headersEnd = (char*)memmem(buf, have, "\r\n\r\n", 4);
+            if (!headersEnd)
+                continue;
+            const char* lengthAt = strcasestr(buf, "Content-Length:");
+            size_t bodyLen = lengthAt ? atoi(lengthAt + 15) : 0;
+            size_t total = headersEnd + 4 - buf + bodyLen;
+            if (have < total)
+                continue;
+            serverRequests++;
+            if (mode == SERVER_UP) {
+                // Words that only mean something in other headers must not be picked up
+                take(headersEnd + 4, bodyLen);
+                static const char ok[] = "HTTP/1.1 200 OK\r\nTransfer-Encoding: identity\r\n"
+                    "X-Note: not chunked, no close\r\nContent-Length: 2\r\n\r\nok";
+                send(fd, ok, sizeof(ok) - 1, MSG_NOSIGNAL);
+            } else if (mode == SERVER_CHUNKED) {
+                // In pieces that split the chunk framing, with an extension and a trailer
+                take(headersEnd + 4, bodyLen);
+                static const char* const pieces[] = {
+                    "HTTP/1.1 200 OK\r\ntransfer-encoding: Chunked\r\n\r\n1",
+                    "0;name=value\r\nreceived",
+                    " packets\r",
+                    "\n0\r\nX-Trailer: 1\r\n",
+                    "\r\n",
+                };
+                for (uint8_t i = 0; i < sizeof(pieces) / sizeof(pieces[0]); i++) {
+                    send(fd, pieces[i], strlen(pieces[i]), MSG_NOSIGNAL);
+                    usleep(1000);
+                }
+            } else if (mode == SERVER_REJECT) {
+                static const char bad[] = "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\n\r\n";
+                static const char ok[] = "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n";
+                if (memmem(headersEnd + 4, bodyLen, ":BAD", 4)) {
+                    send(fd, bad, sizeof(bad) - 1, MSG_NOSIGNAL);
+                } else {
+                    take(headersEnd + 4, bodyLen);
+                    send(fd, ok, sizeof(ok) - 1, MSG_NOSIGNAL);
+                }
+            } else if (mode == SERVER_DOWN) {
+                static const char busy[] = "HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\n\r\n";
+                send(fd, busy, sizeof(busy) - 1, MSG_NOSIGNAL);
+            }
+            memmove(buf, buf + total, have - total);
+            have -= total;
+        }
+        close(fd);
+    }
+}
+
+struct Phase
+{
+    const char* name;
+    int         mode;
+    uint32_t    ms;
+};
+
+static const Phase phases[] =
+{
+    { "up",         SERVER_UP,      1000 },
+    { "chunked",    SERVER_CHUNKED, 1000 },
+    { "rejects",    SERVER_REJECT,  1000 },
+    { "refused",    SERVER_REFUSE,  1000 },
+    { "503s",       SERVER_DOWN,    2000 },
+    { "stalled",    SERVER_STALL,   2000 },
+    { "up again",   SERVER_UP,      3000 },
+};
+
+// Lengths vary so that records do not always meet the end of the ring exactly
+static int makePacket(uint8_t* buf, uint32_t n)
+{
+    return snprintf((char*)buf, RFM69_MAX_MESSAGE_LEN, "3a:%u[GW%.*s]", n, (int)(n % 7), ",R1,R22");
+}
+
+int main()
+{
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addrLen = sizeof(addr);
+    if (bind(listener, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(listener, 4) < 0
+        || getsockname(listener, (struct sockaddr*)&addr, &addrLen) < 0) {
+        perror("listen");
+        return 1;
+    }
+    std::thread server(serverThread, listener);
+    char url[64];
+    snprintf(url, sizeof(url), "http://127.0.0.1:%u/upload", ntohs(addr.sin_port));
+
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/rfm69_spool_bench.%d", (int)getpid());
+    unlink(path);
+    boolean ok = true;
+
+    // The radio loop, a packet every 10ms, with the collector misbehaving
+    {
+        RFM69Spool spool;
+        RFM69Uploader uploader(spool);
+        if (!spool.open(path, 24 * 1024) || !uploader.begin(url)) {
+            printf("setup failed\n");
+            return 1;
+        }
+        uploader.setBatch(32, 200, 500);
+
+        printf("%-10s %8s %8s %8s %8s %8s %8s %10s\n",
+               "phase", "appended", "pending", "uploaded", "requests", "failures", "timeouts", "worst us");
+        uint32_t n = 0;
+        for (uint8_t p = 0; p < sizeof(phases) / sizeof(phases[0]); p++) {
+            serverMode = phases[p].mode;
+            uint64_t end = nowUs() + phases[p].ms * 1000ULL;
+            uint64_t nextPacket = 0;
+            uint64_t worst = 0;
+            boolean last = p == sizeof(phases) / sizeof(phases[0]) - 1;
+            while (nowUs() < end) {
+                uint64_t start = nowUs();
+                if (start >= nextPacket && (!last || start + 1500000 < end)) {
+                    uint8_t buf[RFM69_MAX_MESSAGE_LEN];
+                    int len = makePacket(buf, n);
+                    if (phases[p].mode == SERVER_REJECT && n % 20 == 0 && start + 500000 < end) {
+                        // Sent while the collector still refuses it
+                        len = snprintf((char*)buf, sizeof(buf), "3a:%u:BAD[GW]", n);
+                        malformed[n] = true;
+                    }
+                    n++;
+                    spool.append(buf, len, -90);
+                    nextPacket = start + 10000;
+                }
+                uploader.poll();
+                uint64_t took = nowUs() - start;
+                if (took > worst)
+                    worst = took;
+                usleep(1000);
+            }
+            RFM69SpoolStats s;
+            RFM69UploaderStats u;
+            spool.stats(s);
+            uploader.stats(u);
+            printf("%-10s %8u %8u %8u %8u %8u %8u %10llu\n", phases[p].name, s.appended, s.pending,
+                   u.uploaded, u.requests, u.failures, u.timeouts, (unsigned long long)worst);
+            if (worst > 5000)
+                ok = false;
+        }
+
+        uint32_t lost = 0;
+        uint32_t duplicates = 0;
+        uint32_t bad = 0;
+        for (uint32_t i = 0; i < n; i++) {
+            if (malformed[i])
+                bad++;
+            if (!seen[i])
+                lost += !malformed[i];
+            else
+                duplicates += seen[i] - 1 + malformed[i];
+        }
+        RFM69SpoolStats s;
+        RFM69UploaderStats u;
+        spool.stats(s);
+        uploader.stats(u);
+        printf("\n%u packets, %u lost, %u sent twice, %u of %u malformed rejected, %u requests at the collector, "
+               "spool high water %u of %u bytes\n",
+               n, lost, duplicates, u.rejected, bad, serverRequests, s.highWater, s.capacity);
+        if (lost || duplicates || s.dropped || u.rejected != bad)
+            ok = false;
+        spool.close();
+    }
+
+    // A gateway killed mid-run leaves its packets behind for the next one. It has
+    // delivered 700 packets already, so the ones left run round the end of the ring.
+    unlink(path);
+    memset(seen, 0, sizeof(seen));
+    pid_t child = fork();
+    if (child == 0) {
+        RFM69Spool spool;
+        if (!spool.open(path, 24 * 1024))
+            _exit(1);
+        for (uint32_t i = 0; i < 1200; i++) {
+            uint8_t buf[RFM69_MAX_MESSAGE_LEN];
+            spool.append(buf, makePacket(buf, i >= 700 ? i - 700 : 2000 + i), -90);
+            if (i < 700 && i % 100 == 99)
+                spool.release(spool.head());
+        }
+        raise(SIGKILL);
+    }
+    int status;
+    waitpid(child, &status, 0);
+    {
+        RFM69Spool spool;
+        RFM69Uploader uploader(spool);
+        spool.open(path);
+        uploader.begin(url);
+        uploader.setBatch(64, 0);
+        RFM69SpoolStats s;
+        spool.stats(s);
+        printf("killed with 500 spooled from %llu to %llu: %u recovered, %u bytes discarded",
+               (unsigned long long)spool.tail(), (unsigned long long)spool.head(), s.recovered, s.discarded);
+        if (s.recovered != 500 || s.discarded)
+            ok = false;
+        for (uint32_t i = 0; i < 2000 && s.pending; i++) {
+            uploader.poll();
+            spool.stats(s);
+            usleep(1000);
+        }
+        uint32_t arrived = 0;
+        for (uint32_t i = 0; i < 500; i++)
+            if (seen[i])
+                arrived++;
+        printf(", %u uploaded after restart\n", arrived);
+        if (arrived != 500)
+            ok = false;
+
+        // Tear the last record, as a power cut part way through writing it back might
+        for (uint32_t i = 0; i < 3; i++) {
+            uint8_t buf[RFM69_MAX_MESSAGE_LEN];
+            spool.append(buf, makePacket(buf, 1000 + i), -90);
+        }
+        spool.close();
+    }
+    {
+        // Flip a byte in the last record, just before the head
+        FILE* g = fopen(path, "r+b");
+        uint64_t head;
+        uint32_t capacity;
+        fseek(g, 12, SEEK_SET);
+        if (fread(&capacity, 4, 1, g) != 1 || fread(&head, 8, 1, g) != 1)
+            ok = false;
+        fseek(g, 4096 + (head - 4) % capacity, SEEK_SET);
+        fputc(0x5A, g);
+        fclose(g);
+
+        RFM69Spool spool;
+        spool.open(path);
+        RFM69SpoolStats s;
+        spool.stats(s);
+        printf("torn last record: %u recovered, %u bytes discarded\n", s.recovered, s.discarded);
+        if (s.recovered != 2 || s.discarded == 0)
+            ok = false;
+    }
+    unlink(path);
+
+    serverRunning = false;
+    server.join();
+    close(listener);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+// ukhasnet_parse_bench.cpp
+//
+// Copyright (C) 2026 the UKHASnet_rfm69 contributors
+//
+// Checks UKHASnetPacket::parse() and parseFast() agree on a set of good and bad
+// packets, then times both. Build and run from the library root:
+//
+//   g++ -O2 -I. *.cpp extras/host/ukhasnet_parse_bench.cpp -o ukhasnet_parse_bench && ./ukhasnet_parse_bench
+
+#include <stdio.h>
+#include <time.h>
+#include "UKHASnetPacket.h"
+
+static const char* const packets[] =
+{
+    "3aT12.3L0[AB1]",
+    "0zT21.5,19.2V4.12R-92[CD2,REPEAT1,GATEWAY]",
+    "9bL51.4981,-0.1283,45T18.0H54P1013.2V3.31X12:hello world, HOW ARE YOU[LONDONNODE01,RPT2]",
+    "5c[AB1]",
+    "4d:[AB1]",
+    "2eZ1[X]",
+    // Malformed
+    "aaT1[AB1]",
+    "3AT1[AB1]",
+    "3a12T1[AB1]",
+    "3aT1[]",
+    "3aT1[AB1,]",
+    "3aT1[AB1]x",
+    "3aT1AB1]",
+    "3aT1[AB1",
+    "3aT1]AB1[",
+    "3aT1[A[B]",
+    "3a",
+};
+
+static boolean same(const UKHASnetPacket& a, const UKHASnetPacket& b)
+{
+    if (a.repeat() != b.repeat() || a.sequence() != b.sequence() || !a.data().equals(b.data())
+        || a.fieldCount() != b.fieldCount() || a.pathCount() != b.pathCount())
+        return false;
+    for (uint8_t i = 0; i < a.fieldCount(); i++)
+        if (a.field(i).type != b.field(i).type || !a.field(i).value.equals(b.field(i).value))
+            return false;
+    for (uint8_t i = 0; i < a.pathCount(); i++)
+        if (!a.path(i).equals(b.path(i)))
+            return false;
+    return true;
+}
+
+static double seconds()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main()
+{
+    const uint8_t count = sizeof(packets) / sizeof(packets[0]);
+    uint8_t failures = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        const uint8_t* buf = (const uint8_t*)packets[i];
+        uint8_t len = strlen(packets[i]);
+        UKHASnetPacket slow, fast;
+        boolean ok = slow.parse(buf, len);
+        boolean fastOk = fast.parseFast(buf, len);
+        if (ok != fastOk || (ok && !same(slow, fast))) {
+            printf("MISMATCH %s\n", packets[i]);
+            failures++;
+            continue;
+        }
+        printf("%-5s %s", ok ? "ok" : "bad", packets[i]);
+        if (ok) {
+            printf("\n      repeat %u seq %c fields", slow.repeat(), slow.sequence());
+            for (uint8_t f = 0; f < slow.fieldCount(); f++)
+                printf(" %c=%.*s", slow.field(f).type, slow.field(f).value.len, slow.field(f).value.ptr);
+            printf(" origin %.*s hops %u", slow.origin().len, slow.origin().ptr, slow.pathCount());
+        }
+        printf("\n");
+    }
+
+    const uint32_t runs = 2000000;
+    const uint8_t* buf = (const uint8_t*)packets[2];
+    uint8_t len = strlen(packets[2]);
+    UKHASnetPacket packet;
+    uint32_t parsed = 0;
+    double start = seconds();
+    for (uint32_t i = 0; i < runs; i++)
+        parsed += packet.parse(buf, len);
+    double scalar = seconds() - start;
+    start = seconds();
+    for (uint32_t i = 0; i < runs; i++)
+        parsed += packet.parseFast(buf, len);
+    double vector = seconds() - start;
+    printf("\n%u byte packet: parse %.1f ns, parseFast %.1f ns (%.2f Mpackets/s), %u parsed\n", len,
+           scalar / runs * 1e9, vector / runs * 1e9, runs / vector / 1e6, parsed);
+    return failures ? 1 : 0;
+}